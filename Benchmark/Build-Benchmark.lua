@@ -0,0 +1,51 @@
+project "Benchmark"
+    kind "ConsoleApp"
+    language "C++"
+    staticruntime "off"
+
+    files
+    {
+        "**.h",
+        "**.cpp"
+    }
+
+    defines
+    {
+        "NOMINMAX"
+    }
+
+    includedirs
+    {
+        "src",
+        "%{wks.location}/GameLib/src",
+
+        "%{wks.location}/vendor/OpenGL/include",
+        "%{wks.location}/vendor/stdext/include",
+    }
+
+    links
+    {
+        "GameLib"
+    }
+
+    targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+    postbuildcommands
+    {
+        "{COPYDIR} %{wks.location}/Common-DLLs %{wks.location}/bin/" .. outputdir .. "/%{prj.name}"
+    }
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "WINDOWS" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Release"
+        optimize "On"
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "Benchmark.h"
+
+#include "Utils/Exception.h"
+
+namespace {
+
+	auto g_FailedChecks = 0zu;
+
+}
+
+namespace Game::Bench {
+
+	void Check(std::string_view name, bool passed)
+	{
+		std::println("{:<60} {}", name, passed ? "ok" : "FAILED");
+		if (!passed)
+		{
+			++g_FailedChecks;
+		}
+	}
+
+	size_t GetFailedChecks()
+	{
+		return g_FailedChecks;
+	}
+
+	bool Throws(const std::function<void()>& func)
+	{
+		try
+		{
+			func();
+		}
+		catch (const Exception&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <print>
+#include <string_view>
+
+namespace Game::Bench {
+
+	// @brief Keeps the optimizer from discarding a computed value
+	template<class T>
+	void DoNotOptimize(const T& value)
+	{
+		static volatile const void* sink{};
+		sink = &value;
+	}
+
+	// @brief Prints the result of a correctness check, any failed check makes the run exit with a failure
+	void Check(std::string_view name, bool passed);
+	size_t GetFailedChecks();
+
+	// @brief True if func throws a Game::Exception
+	bool Throws(const std::function<void()>& func);
+
+	// @brief Runs func(i) for i in [0, iterations) and prints throughput
+	template<class F>
+	double Run(std::string_view name, size_t iterations, F&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (auto i = 0zu; i < iterations; ++i)
+		{
+			func(i);
+		}
+
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const auto opsPerSecond = static_cast<double>(iterations) / elapsed;
+
+		std::println("{:<40} {:>12.2f} Mops/s {:>10.2f} ns/op", name, opsPerSecond / 1'000'000.0, (elapsed * 1'000'000'000.0) / static_cast<double>(iterations));
+
+		return opsPerSecond;
+	}
+
+	void RunMatrixBenchmarks();
+	void RunRayBenchmarks();
+	void RunVertexBenchmarks();
+	void RunMeshBenchmarks();
+	void RunCullingBenchmarks();
+	void RunRendererBenchmarks();
+	void RunLightBenchmarks();
+	void RunRenderGraphBenchmarks();
+	void RunDynamicResolutionBenchmarks();
+
+}
@@ -0,0 +1,238 @@
+#include "Benchmark.h"
+
+#include "Core/Camera.h"
+#include "Core/Entity.h"
+#include "Graphics/Culling.h"
+#include "Graphics/MeshView.h"
+#include "Math/AABB.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix4.h"
+#include "Math/SIMD.h"
+#include "Math/Transform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace {
+
+	constexpr auto kEntityCount = 100'000zu;
+	constexpr auto kFrames = 20zu;
+	constexpr auto kMeshCount = 256u;
+
+	struct SyntheticEntity
+	{
+		Game::AABB bounds;
+		Game::mat4 transform;
+	};
+
+	// @brief Boxes of crate to building size scattered around the camera in a 1 km cube with random yaw and scale
+	std::vector<SyntheticEntity> RandomEntities(size_t count)
+	{
+		auto rng = std::mt19937{ 42u };
+		auto position = std::uniform_real_distribution<float>{ -500.0f, 500.0f };
+		auto extent = std::uniform_real_distribution<float>{ 0.5f, 20.0f };
+		auto scale = std::uniform_real_distribution<float>{ 0.5f, 2.0f };
+		auto angle = std::uniform_real_distribution<float>{ 0.0f, std::numbers::pi_v<float> };
+
+		return std::views::iota(0zu, count) |
+			std::views::transform([&](auto)
+								  {
+									  const auto halfExtent = Game::vec3{ extent(rng), extent(rng), extent(rng) };
+									  const auto a = angle(rng);
+									  const auto transform = Game::Transform{
+										  { position(rng), position(rng), position(rng) },
+										  { scale(rng) },
+										  { 0.0f, std::sin(a), 0.0f, std::cos(a) }
+									  };
+									  return SyntheticEntity{ .bounds = { -halfExtent, halfExtent }, .transform = Game::mat4{ transform } };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	std::vector<uint8_t> Cull(const Game::Frustum& frustum, std::span<const SyntheticEntity> entities)
+	{
+		return entities |
+			std::views::transform([&](const auto& entity) { return static_cast<uint8_t>(frustum.Intersects(entity.bounds, entity.transform)); }) |
+			std::ranges::to<std::vector>();
+	}
+
+	// @brief FNV-1a, a readback of the GPU cull passes hashes to the same value for the same visibility
+	uint64_t Hash(std::span<const std::byte> bytes, uint64_t hash = 14695981039346656037ull)
+	{
+		for (const auto byte : bytes)
+		{
+			hash = (hash ^ std::to_integer<uint64_t>(byte)) * 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	// @brief Unit boxes placed by hand, the expected stream below follows from the CullLayout and CullResult contracts. The
+	// random scene cannot have a golden stream as the standard library's distributions differ between implementations.
+	void CheckGoldenCommandStream(const Game::Frustum& frustum)
+	{
+		constexpr auto kGoldenMeshCount = 4u;
+		constexpr struct
+		{
+			uint32_t mesh;
+			Game::vec3 position;
+		} kPlacements[] = {
+			{ 0u, { 0.0f, 0.0f, -10.0f } },		// visible
+			{ 1u, { 0.0f, 0.0f, 10.0f } },		// behind the camera
+			{ 2u, { 0.0f, 0.0f, -2000.0f } },	// past the far plane
+			{ 0u, { 3.0f, 0.0f, -20.0f } },		// visible
+			{ 3u, { 0.0f, 0.0f, -50.0f } },		// visible
+			{ 1u, { 500.0f, 0.0f, -10.0f } },	// right of the frustum
+			{ 2u, { 0.0f, 0.0f, -5.0f } },		// visible
+			{ 3u, { 0.0f, 500.0f, -10.0f } }	// above the frustum
+		};
+
+		// UINT16 batch with meshes 0 and 2, UINT32 batch with meshes 1 and 3 of which only 3 has a visible instance
+		const auto expectedCommands = std::vector<Game::IndirectCommand>{
+			{ .count = 36u, .instanceCount = 2u, .first = 0u, .baseVertex = 0, .baseInstance = 0u },
+			{ .count = 36u, .instanceCount = 1u, .first = 72u, .baseVertex = 48, .baseInstance = 2u },
+			{ .count = 36u, .instanceCount = 1u, .first = 108u, .baseVertex = 72, .baseInstance = 6u },
+			{}
+		};
+		const auto expectedDrawCounts = std::vector<uint32_t>{ 2u, 1u };
+
+		const auto getView = [](Game::MeshHandle handle)
+			{
+				return Game::MeshView{
+					.indexType = handle.index % 2u == 0u ? Game::IndexType::UINT16 : Game::IndexType::UINT32,
+					.indexOffset = handle.index * 36u,
+					.indexCount = 36u,
+					.vertexOffset = handle.index * 24u,
+					.vertexCount = 24u,
+					.handle = handle,
+					.quantization = Game::PositionQuantization::Identity(),
+					.bounds = { { -1.0f }, { 1.0f } }
+				};
+			};
+		const auto entities = kPlacements |
+			std::views::transform([](const auto& placement) { return Game::Entity{ {}, { placement.mesh, 0u }, {}, 0u }; }) |
+			std::ranges::to<std::vector>();
+		const auto transforms = kPlacements |
+			std::views::transform([](const auto& placement) { return Game::mat4{ Game::Transform{ placement.position, { 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } }; }) |
+			std::ranges::to<std::vector>();
+
+		auto layout = Game::CullLayout{};
+		Game::BuildCullLayout(entities, getView, layout);
+		Game::Bench::Check("golden layout has one template per mesh", layout.templates.size() == kGoldenMeshCount && layout.batches.size() == 2zu);
+
+		auto result = Game::CullResult{};
+		Game::Cull(layout, frustum, transforms, result);
+		Game::Bench::Check(std::format("[{}] golden command stream", Game::SIMD::GetBackend()), result.commands == expectedCommands && result.drawCounts == expectedDrawCounts);
+		Game::Bench::Check(std::format("[{}] golden instance slots", Game::SIMD::GetBackend()),
+			result.instances[0] == 0u && result.instances[1] == 3u && result.instances[2] == 6u && result.instances[6] == 4u);
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunCullingBenchmarks()
+	{
+		std::println("== frustum culling ({} synthetic entities)", kEntityCount);
+
+		const auto entities = RandomEntities(kEntityCount);
+		const auto camera = Camera{ {}, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, std::numbers::pi_v<float> / 4.0f, 1920.0f, 1080.0f, 0.1f, 1000.0f };
+		const auto frustum = camera.GetFrustum();
+		const auto initialBackend = SIMD::GetBackend();
+
+		// the corner transform is the straightforward reference, Arvo's extents must give the same box up to rounding
+		const auto reference = entities |
+			std::views::transform([&](const auto& entity) { return static_cast<uint8_t>(frustum.Intersects(entity.bounds.Transform(entity.transform))); }) |
+			std::ranges::to<std::vector>();
+		const auto visibleReference = std::ranges::count(reference, uint8_t{ 1u });
+		std::println("reference: {} visible, {} culled", visibleReference, kEntityCount - visibleReference);
+
+		auto scalarResult = std::vector<uint8_t>{};
+		for (const auto backend : { SIMD::Backend::SCALAR, SIMD::Backend::SSE })
+		{
+			SIMD::SetBackend(backend);
+
+			const auto start = std::chrono::steady_clock::now();
+			auto visible = std::vector<uint8_t>{};
+			for (auto frame = 0zu; frame < kFrames; ++frame)
+			{
+				visible = Cull(frustum, entities);
+				DoNotOptimize(visible);
+			}
+			const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(kFrames);
+
+			if (scalarResult.empty())
+			{
+				scalarResult = visible;
+			}
+
+			const auto visibleCount = std::ranges::count(visible, uint8_t{ 1u });
+			const auto referenceMismatches = std::ranges::count_if(std::views::zip(visible, reference), [](const auto& pair) { return std::get<0>(pair) != std::get<1>(pair); });
+			const auto scalarMismatches = std::ranges::count_if(std::views::zip(visible, scalarResult), [](const auto& pair) { return std::get<0>(pair) != std::get<1>(pair); });
+
+			std::println("[{}] {} visible, {} culled in {:.3f} ms per frame, {} differ from the reference, {} from scalar",
+				backend, visibleCount, kEntityCount - visibleCount, elapsed, referenceMismatches, scalarMismatches);
+
+			CheckGoldenCommandStream(frustum);
+
+			Run(std::format("[{}] Frustum::Intersects(AABB, mat4)", backend), kEntityCount * kFrames, [&](auto i)
+				{
+					const auto& entity = entities[i % kEntityCount];
+					const auto result = frustum.Intersects(entity.bounds, entity.transform);
+					DoNotOptimize(result);
+				});
+		}
+
+		// the reference of the GPU cull passes, entity i instances mesh i % kMeshCount which takes the bounds of entity i % kMeshCount
+		const auto views = std::views::iota(0u, kMeshCount) |
+			std::views::transform([&](auto mesh)
+								  {
+									  return MeshView{
+										  .indexType = mesh % 2u == 0u ? IndexType::UINT16 : IndexType::UINT32,
+										  .indexOffset = mesh * 36u,
+										  .indexCount = 36u,
+										  .vertexOffset = mesh * 24u,
+										  .vertexCount = 24u,
+										  .handle = { mesh, 0u },
+										  .quantization = PositionQuantization::Identity(),
+										  .bounds = entities[mesh].bounds
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+		const auto sceneEntities = std::views::iota(0zu, kEntityCount) |
+			std::views::transform([](auto index) { return Entity{ {}, { static_cast<uint32_t>(index % kMeshCount), 0u }, {}, 0u }; }) |
+			std::ranges::to<std::vector>();
+		const auto transforms = entities | std::views::transform([](const auto& entity) { return entity.transform; }) | std::ranges::to<std::vector>();
+
+		auto layout = CullLayout{};
+		BuildCullLayout(sceneEntities, [&](auto handle) { return views[handle.index]; }, layout);
+
+		auto result = CullResult{};
+		const auto start = std::chrono::steady_clock::now();
+		for (auto frame = 0zu; frame < kFrames; ++frame)
+		{
+			Game::Cull(layout, frustum, transforms, result);
+			DoNotOptimize(result);
+		}
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(kFrames);
+
+		const auto visibleInstances = std::ranges::fold_left(result.commands | std::views::transform([](const auto& command) { return command.instanceCount; }), 0zu, std::plus{});
+		const auto drawCount = std::ranges::fold_left(result.drawCounts, 0zu, std::plus{});
+		const auto hash = Hash(std::as_bytes(std::span{ result.drawCounts }), Hash(std::as_bytes(std::span{ result.commands })));
+		std::println("[{}] Cull: {} visible instances in {} of {} commands, {:.3f} ms per frame, command stream hash {:016x}",
+			SIMD::GetBackend(), visibleInstances, drawCount, layout.templates.size(), elapsed, hash);
+
+		SIMD::SetBackend(initialBackend);
+	}
+
+}
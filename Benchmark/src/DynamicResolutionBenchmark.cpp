@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+
+#include "Graphics/DynamicResolution.h"
+#include "Graphics/GPUProfiler.h"
+#include "Utils/Formatter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <print>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+	using Game::Bench::Check;
+
+	constexpr auto kTargetFrameTime = 1000.0f / 144.0f;
+	constexpr auto kSegmentFrames = 600zu;
+	constexpr auto kReadbackLatency = 3zu;
+	// frames after a load change before the frame time has to be back under the target
+	constexpr auto kResponseFrames = 30zu;
+	constexpr auto kUpdateIterations = 1'000'000zu;
+
+	constexpr auto kConfig = Game::DynamicResolutionConfig{
+		.targetFrameTime = kTargetFrameTime,
+		.minScale = 0.5f,
+		.maxScale = 1.0f,
+		.scaleStep = 0.05f,
+		.headroom = 0.9f,
+		.growFrames = 30u,
+		.settleFrames = static_cast<uint32_t>(Game::GPUProfiler::kFrameSlots)
+	};
+
+	// GPU frame times in ms at full resolution captured on the smoke test scene, the calm part and the part with the
+	// smoke grenade filling the view. Only the share that scales with the pixel count shrinks with the resolution.
+	constexpr float kCalmTrace[] = {
+		5.31f, 5.42f, 5.28f, 5.77f, 5.35f, 5.30f, 5.61f, 5.33f, 5.29f, 5.48f, 5.36f, 6.12f, 5.34f, 5.31f, 5.40f, 5.38f,
+		5.30f, 5.52f, 5.27f, 5.35f, 5.44f, 5.32f, 5.29f, 5.71f, 5.33f, 5.36f, 5.30f, 5.41f, 5.28f, 5.39f, 5.55f, 5.34f
+	};
+	constexpr float kSmokeTrace[] = {
+		10.84f, 11.21f, 10.97f, 11.63f, 10.92f, 11.05f, 12.40f, 10.88f, 11.17f, 10.95f, 11.32f, 10.90f, 11.08f, 11.46f, 10.93f, 11.01f,
+		11.12f, 10.86f, 11.74f, 10.99f, 11.03f, 11.27f, 10.91f, 11.15f, 10.89f, 11.58f, 11.06f, 10.94f, 11.19f, 10.97f, 11.36f, 11.02f
+	};
+	constexpr auto kFixedShare = 0.15f;
+
+	struct Frame
+	{
+		float scale;
+		float frameTime;
+	};
+
+	float FrameTime(float fullResolution, float scale)
+	{
+		return fullResolution * (kFixedShare + (1.0f - kFixedShare) * scale * scale);
+	}
+
+	// @brief Calm, smoke, calm, each frame's time read back kReadbackLatency frames later like the profiler's
+	std::vector<Frame> Simulate(const Game::DynamicResolutionConfig& config)
+	{
+		const auto segments = std::vector<std::span<const float>>{ kCalmTrace, kSmokeTrace, kCalmTrace };
+
+		auto controller = Game::DynamicResolution{ config };
+		auto inFlight = std::deque<float>{};
+		auto frames = std::vector<Frame>{};
+		for (const auto& trace : segments)
+		{
+			for (const auto index : std::views::iota(0zu, kSegmentFrames))
+			{
+				const auto scale = controller.GetScale();
+				const auto frameTime = FrameTime(trace[index % trace.size()], scale);
+				frames.push_back({ .scale = scale, .frameTime = frameTime });
+
+				inFlight.push_back(frameTime);
+				if (inFlight.size() > kReadbackLatency)
+				{
+					controller.Update(inFlight.front());
+					inFlight.pop_front();
+				}
+			}
+		}
+
+		return frames;
+	}
+
+	size_t ScaleChanges(std::span<const Frame> frames)
+	{
+		return std::ranges::count_if(std::views::iota(1zu, frames.size()), [&](auto index) { return frames[index].scale != frames[index - 1zu].scale; });
+	}
+
+	bool UnderTarget(std::span<const Frame> frames)
+	{
+		return std::ranges::all_of(frames, [](const auto& frame) { return frame.frameTime <= kTargetFrameTime; });
+	}
+
+	void CheckTraces()
+	{
+		const auto frames = Simulate(kConfig);
+		const auto calm = std::span{ frames }.first(kSegmentFrames);
+		const auto smoke = std::span{ frames }.subspan(kSegmentFrames, kSegmentFrames);
+		const auto recovered = std::span{ frames }.subspan(2zu * kSegmentFrames);
+
+		const auto again = Simulate(kConfig);
+		Check("the same trace gives the same scales", std::ranges::equal(frames, again, {}, &Frame::scale, &Frame::scale));
+
+		Check("calm frames stay at full resolution", std::ranges::all_of(calm, [](const auto& frame) { return frame.scale == kConfig.maxScale; }));
+		Check("smoke is back under the target within the response time", UnderTarget(smoke.subspan(kResponseFrames)));
+		Check("smoke settles on one scale", ScaleChanges(smoke.subspan(kResponseFrames)) == 0zu);
+		Check("scales stay within the bounds", std::ranges::all_of(frames, [](const auto& frame)
+			{
+				return frame.scale >= kConfig.minScale && frame.scale <= kConfig.maxScale;
+			}));
+		Check("full resolution returns after the smoke clears", recovered.back().scale == kConfig.maxScale && UnderTarget(recovered));
+
+		{
+			// the smoke at full resolution, the controller only sees it and never changes what it measures
+			auto controller = Game::DynamicResolution{ kConfig };
+			for (const auto frameTime : kSmokeTrace)
+			{
+				controller.Update(frameTime);
+			}
+			Check("scales never drop below the minimum", controller.Update(1'000.0f) == kConfig.minScale);
+		}
+
+		{
+			auto controller = Game::DynamicResolution{ { .targetFrameTime = kTargetFrameTime, .minScale = 0.5f, .maxScale = 1.0f, .scaleStep = 0.05f, .headroom = 0.9f, .growFrames = 30u, .settleFrames = 0u } };
+			controller.Update(FrameTime(kSmokeTrace[0], 1.0f));
+			const auto shrunk = controller.GetScale();
+			for (const auto index : std::views::iota(0zu, static_cast<size_t>(kConfig.growFrames) - 1zu))
+			{
+				controller.Update(index % 2zu == 0zu ? 1.0f : FrameTime(kSmokeTrace[0], shrunk));
+			}
+			Check("single fast frames never grow the scale", controller.GetScale() == shrunk);
+		}
+
+		{
+			auto controller = Game::DynamicResolution{ kConfig };
+			controller.Update(2.0f * kTargetFrameTime);
+			const auto shrunk = controller.GetScale();
+			for (auto sample = 0u; sample < kConfig.settleFrames; ++sample)
+			{
+				controller.Update(4.0f * kTargetFrameTime);
+			}
+			Check("samples from before a change are ignored", controller.GetScale() == shrunk && shrunk < kConfig.maxScale);
+		}
+
+		const auto smokeScale = smoke.back().scale;
+		std::println("{}", kConfig);
+		std::println("smoke: scale {:.2f}, {:.2f} ms per frame, {} scale changes over {} frames", smokeScale, smoke.back().frameTime, ScaleChanges(frames), frames.size());
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunDynamicResolutionBenchmarks()
+	{
+		std::println("== dynamic resolution");
+
+		CheckTraces();
+
+		auto controller = DynamicResolution{ kConfig };
+		Run("controller update", kUpdateIterations, [&](auto index)
+			{
+				DoNotOptimize(controller.Update(FrameTime(kSmokeTrace[index % std::size(kSmokeTrace)], controller.GetScale())));
+			});
+	}
+
+}
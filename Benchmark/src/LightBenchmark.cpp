@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+
+#include "Core/Camera.h"
+#include "Graphics/LightClusters.h"
+#include "Graphics/PointLight.h"
+#include "Math/AABB.h"
+#include "Math/Vector4.h"
+#include "Utils/Formatter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <numbers>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace {
+
+	constexpr auto kMaxLights = 4096zu;
+	constexpr auto kFrames = 50zu;
+
+	// @brief Lights of 5 to 40 m reach scattered over a 400 m square around the camera
+	std::vector<Game::PointLight> RandomLights(size_t count)
+	{
+		auto rng = std::mt19937{ 42u };
+		auto position = std::uniform_real_distribution<float>{ -200.0f, 200.0f };
+		auto height = std::uniform_real_distribution<float>{ 0.0f, 20.0f };
+		auto radius = std::uniform_real_distribution<float>{ 5.0f, 40.0f };
+		auto channel = std::uniform_real_distribution<float>{ 0.2f, 1.0f };
+
+		return std::views::iota(0zu, count) |
+			std::views::transform([&](auto)
+								  {
+									  // full white reaches the cutoff of 1/256 exactly at the radius
+									  const auto reach = radius(rng);
+									  return Game::PointLight{
+										  .position = { position(rng), height(rng), position(rng) },
+										  .color = { 1.0f, channel(rng), channel(rng) },
+										  .constantAttenuation = 1.0f,
+										  .linearAttenuation = 0.0f,
+										  .quadraticAttenuation = 255.0f / (reach * reach),
+										  .specularPower = 32.0f
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	// @brief Every light against every cluster, the straightforward version of what AssignLights prunes by slice and row
+	size_t CountMismatches(const Game::ClusterGrid& grid, const Game::mat4& view, std::span<const Game::PointLight> lights, const Game::ClusterLights& result)
+	{
+		auto mismatches = 0zu;
+		auto expected = std::vector<uint32_t>{};
+
+		const auto clusterBounds = grid.Bounds();
+		for (const auto& [cluster, bounds] : clusterBounds | std::views::enumerate)
+		{
+			expected.clear();
+			for (const auto& [index, light] : lights | std::views::enumerate)
+			{
+				const auto center = static_cast<Game::vec3>(view * Game::vec4{ light.position, 1.0f });
+				const auto radius = Game::LightRadius(light);
+				const auto closest = Game::vec3{
+					std::clamp(center.x, bounds.min.x, bounds.max.x),
+					std::clamp(center.y, bounds.min.y, bounds.max.y),
+					std::clamp(center.z, bounds.min.z, bounds.max.z)
+				};
+				const auto offset = closest - center;
+
+				if (Game::vec3::Dot(offset, offset) <= radius * radius && expected.size() < Game::kMaxLightsPerCluster)
+				{
+					expected.push_back(static_cast<uint32_t>(index));
+				}
+			}
+
+			const auto [offset, count] = result.clusters[cluster];
+			if (!std::ranges::equal(expected, std::span{ result.lightIndices }.subspan(offset, count)))
+			{
+				++mismatches;
+			}
+		}
+
+		return mismatches;
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunLightBenchmarks()
+	{
+		std::println("== clustered light assignment ({}x{}x{} clusters, up to {} lights)", kClusterGridWidth, kClusterGridHeight, kClusterGridDepth, kMaxLights);
+
+		const auto camera = Camera{ { 0.0f, 10.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, std::numbers::pi_v<float> / 4.0f, 1920.0f, 1080.0f, 0.1f, 1000.0f };
+		const auto grid = ClusterGrid::FromCamera(camera);
+		const auto& view = camera.GetData().view;
+		const auto allLights = RandomLights(kMaxLights);
+
+		auto result = ClusterLights{};
+		for (auto lightCount = 1zu; lightCount <= kMaxLights; lightCount *= 2zu)
+		{
+			const auto lights = std::span{ allLights }.first(lightCount);
+
+			auto stats = ClusterStats{};
+			const auto start = std::chrono::steady_clock::now();
+			for (auto frame = 0zu; frame < kFrames; ++frame)
+			{
+				stats = AssignLights(grid, view, lights, result);
+				DoNotOptimize(result);
+			}
+			const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(kFrames);
+
+			const auto mismatches = CountMismatches(grid, view, lights, result);
+			std::println("{:>5} lights: {:>9.1f} us per frame, {}, {} clusters differ from brute force", lightCount, elapsed, stats, mismatches);
+			Check(std::format("{} lights match brute force", lightCount), mismatches == 0zu);
+		}
+	}
+
+}
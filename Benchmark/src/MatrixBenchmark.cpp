@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+
+#include "Math/Matrix4.h"
+#include "Math/SIMD.h"
+#include "Math/Transform.h"
+#include "Math/Vector4.h"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <numbers>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace {
+
+	using Game::Bench::Check;
+
+	constexpr auto kMatrixCount = 1024zu;
+	constexpr auto kIterations = 10'000'000zu;
+
+	std::vector<Game::mat4> RandomTransforms(size_t count)
+	{
+		auto rng = std::mt19937{ 42u };
+		auto position = std::uniform_real_distribution<float>{ -100.0f, 100.0f };
+		auto scale = std::uniform_real_distribution<float>{ 0.1f, 10.0f };
+		auto angle = std::uniform_real_distribution<float>{ 0.0f, std::numbers::pi_v<float> };
+
+		return std::views::iota(0zu, count) |
+			std::views::transform([&](auto)
+								  {
+									  const auto a = angle(rng);
+									  const auto transform = Game::Transform{
+										  { position(rng), position(rng), position(rng) },
+										  { scale(rng), scale(rng), scale(rng) },
+										  { 0.0f, std::sin(a), 0.0f, std::cos(a) }
+									  };
+									  return Game::mat4{ transform };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	struct Results
+	{
+		std::vector<Game::mat4> products;
+		std::vector<Game::mat4> inverses;
+		std::vector<Game::vec4> points;
+	};
+
+	// @brief Every operation the kernels replace, on the active backend
+	Results Compute(std::span<const Game::mat4> matrices)
+	{
+		auto results = Results{};
+		for (const auto& [index, matrix] : matrices | std::views::enumerate)
+		{
+			results.products.push_back(matrix * matrices[(static_cast<size_t>(index) + 1zu) % matrices.size()]);
+			results.inverses.push_back(Game::mat4::Invert(matrix));
+			results.points.push_back(matrix * Game::vec4{ 1.0f, 2.0f, 3.0f, 1.0f });
+		}
+
+		return results;
+	}
+
+	bool BitIdentical(std::span<const Game::mat4> a, std::span<const Game::mat4> b)
+	{
+		return std::ranges::equal(a, b, [](const auto& x, const auto& y) { return std::memcmp(x.Data().data(), y.Data().data(), 16zu * sizeof(float)) == 0; });
+	}
+
+	bool BitIdentical(std::span<const Game::vec4> a, std::span<const Game::vec4> b)
+	{
+		return std::ranges::equal(a, b, [](const auto& x, const auto& y) { return std::memcmp(&x, &y, sizeof(Game::vec4)) == 0; });
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunMatrixBenchmarks()
+	{
+		std::println("== mat4 ({} matrices, {} iterations)", kMatrixCount, kIterations);
+
+		const auto matrices = RandomTransforms(kMatrixCount);
+		const auto initialBackend = SIMD::GetBackend();
+
+		SIMD::SetBackend(SIMD::Backend::SCALAR);
+		const auto scalar = Compute(matrices);
+
+		for (const auto backend : { SIMD::Backend::SCALAR, SIMD::Backend::SSE, SIMD::Backend::AVX2 })
+		{
+			if (!SIMD::IsSupported(backend))
+			{
+				std::println("{} not supported on this CPU, skipping", backend);
+				continue;
+			}
+
+			SIMD::SetBackend(backend);
+
+			if (backend != SIMD::Backend::SCALAR)
+			{
+				const auto results = Compute(matrices);
+				Check(std::format("[{}] mat4 * mat4 matches SCALAR bit for bit", backend), BitIdentical(results.products, scalar.products));
+				Check(std::format("[{}] mat4::Invert matches SCALAR bit for bit", backend), BitIdentical(results.inverses, scalar.inverses));
+				Check(std::format("[{}] mat4 * vec4 matches SCALAR bit for bit", backend), BitIdentical(results.points, scalar.points));
+			}
+
+			auto accumulator = mat4{};
+			Run(std::format("[{}] mat4 *= mat4", backend), kIterations, [&](auto i)
+				{
+					accumulator = matrices[i % kMatrixCount];
+					accumulator *= matrices[(i + 1zu) % kMatrixCount];
+					DoNotOptimize(accumulator);
+				});
+
+			Run(std::format("[{}] mat4::Invert", backend), kIterations, [&](auto i)
+				{
+					const auto inverse = mat4::Invert(matrices[i % kMatrixCount]);
+					DoNotOptimize(inverse);
+				});
+
+			auto point = vec4{ 1.0f, 2.0f, 3.0f, 1.0f };
+			Run(std::format("[{}] mat4 * vec4", backend), kIterations, [&](auto i)
+				{
+					point = matrices[i % kMatrixCount] * point;
+					point.w = 1.0f;
+					DoNotOptimize(point);
+				});
+		}
+
+		SIMD::SetBackend(initialBackend);
+	}
+
+}
@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/Utils.h"
+#include "Resources/EmbeddedResourceLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace {
+
+	using Game::Bench::Check;
+
+	using VertexKey = std::array<uint32_t, sizeof(Game::VertexData) / sizeof(uint32_t)>;
+	using TriangleKey = std::array<VertexKey, 3zu>;
+
+	// @brief The mesh's triangles by the bits of their vertices, sorted. Each starts at its smallest vertex, which keeps
+	// the winding while ignoring where a triangle starts and where its vertices sit in the vertex buffer.
+	std::vector<TriangleKey> Triangles(const Game::MeshData& mesh)
+	{
+		auto triangles = std::views::iota(0zu, mesh.indices.size() / 3zu) |
+			std::views::transform([&](auto triangle)
+								  {
+									  auto key = TriangleKey{};
+									  for (const auto corner : std::views::iota(0zu, 3zu))
+									  {
+										  key[corner] = std::bit_cast<VertexKey>(mesh.vertices[mesh.indices[triangle * 3zu + corner]]);
+									  }
+									  std::ranges::rotate(key, std::ranges::min_element(key));
+									  return key;
+								  }) |
+			std::ranges::to<std::vector>();
+		std::ranges::sort(triangles);
+
+		return triangles;
+	}
+
+	bool Within(const Game::vec3& a, const Game::vec3& b, float tolerance)
+	{
+		return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance && std::abs(a.z - b.z) <= tolerance;
+	}
+
+	bool Within(const Game::VertexData& a, const Game::VertexData& b, const Game::WeldTolerance& tolerance)
+	{
+		return Within(a.position, b.position, tolerance.position) &&
+			   Within(a.normal, b.normal, tolerance.normal) &&
+			   Within(a.tangent, b.tangent, tolerance.tangent) &&
+			   Within(a.bitangent, b.bitangent, tolerance.bitangent) &&
+			   std::abs(a.uv.s - b.uv.s) <= tolerance.uv &&
+			   std::abs(a.uv.t - b.uv.t) <= tolerance.uv;
+	}
+
+	// @brief Every corner of every welded mesh, looked up through its remapped index, against the corner before welding
+	template<class F>
+	bool CornersMatch(std::span<const Game::MeshData> original, std::span<const Game::MeshData> welded, F&& matches)
+	{
+		return std::ranges::all_of(std::views::zip(original, welded), [&](const auto& pair)
+			{
+				const auto& [before, after] = pair;
+				return before.indices.size() == after.indices.size() &&
+					   std::ranges::all_of(std::views::zip(before.indices, after.indices), [&](const auto& indices)
+						   {
+							   const auto [a, b] = indices;
+							   return matches(before.vertices[a], after.vertices[b]);
+						   });
+			});
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunMeshBenchmarks()
+	{
+		std::println("== mesh welding and optimization (de_dust2, {} entry FIFO cache)", kVertexCacheSize);
+
+		auto resourceLoader = EmbeddedResourceLoader{};
+		auto models = LoadModel(resourceLoader.LoadDataBuffer("models\\de_dust2.glb"), resourceLoader);
+		auto meshes = models |
+			std::views::transform([](auto& model) { return std::move(model.meshData); }) |
+			std::ranges::to<std::vector>();
+		auto copies = meshes;
+
+		auto weldTotal = WeldStats{ .verticesBefore = 0u, .verticesAfter = 0u };
+		const auto weldStart = std::chrono::steady_clock::now();
+		const auto weldStats = WeldMeshes(meshes);
+		const auto weldElapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - weldStart).count();
+		for (const auto& [index, weld] : weldStats | std::views::enumerate)
+		{
+			std::println("mesh {:>3} welded {}", index, weld);
+			weldTotal += weld;
+		}
+		std::println("welding total {} in {:.2f} ms", weldTotal, weldElapsed);
+
+		Check("welded corners stay within tolerance", CornersMatch(copies, meshes, [](const auto& a, const auto& b) { return Within(a, b, WeldTolerance{}); }));
+
+		auto exact = copies;
+		WeldMeshes(exact, { .position = 0.0f, .normal = 0.0f, .tangent = 0.0f, .bitangent = 0.0f, .uv = 0.0f });
+		Check("welding without tolerance only merges identical bits", CornersMatch(copies, exact, [](const auto& a, const auto& b)
+			{
+				return std::bit_cast<VertexKey>(a) == std::bit_cast<VertexKey>(b);
+			}));
+
+		WeldMeshes(copies);
+
+		auto changedGeometry = 0zu;
+		for (auto& mesh : meshes)
+		{
+			const auto triangles = Triangles(mesh);
+			const auto before = AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+			const auto after = OptimizeMesh(mesh).after;
+			std::println("{:>8} triangles: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", before.triangleCount, before.ACMR(), after.ACMR(), before.ATVR(), after.ATVR());
+
+			changedGeometry += Triangles(mesh) != triangles ? 1zu : 0zu;
+		}
+		Check("optimization keeps every mesh's triangles", changedGeometry == 0zu);
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto stats = OptimizeMeshes(copies);
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::println("total {}", stats);
+		std::println("optimized {} meshes in {:.2f} ms", copies.size(), elapsed);
+
+		// the parallel pass must bake exactly what the serial one did
+		const auto differences = std::ranges::count_if(std::views::zip(meshes, copies), [](const auto& pair)
+			{
+				const auto& [a, b] = pair;
+				return a.indices != b.indices || a.vertices.size() != b.vertices.size();
+			});
+		Check("parallel optimization matches serial", differences == 0);
+	}
+
+}
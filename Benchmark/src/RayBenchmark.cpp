@@ -0,0 +1,238 @@
+#include "Benchmark.h"
+
+#include "Graphics/Utils.h"
+#include "Math/AABB.h"
+#include "Math/BVH.h"
+#include "Math/DynamicBVH.h"
+#include "Math/Matrix4.h"
+#include "Math/Ray.h"
+#include "Math/RayPacket.h"
+#include "Math/Transform.h"
+#include "Math/Utils.h"
+#include "Math/Vector4.h"
+#include "Resources/EmbeddedResourceLoader.h"
+
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace {
+
+	constexpr auto kRayCount = 100'000zu;
+	constexpr auto kBruteForceRayCount = 1'000zu;
+
+	struct Instance
+	{
+		const Game::MeshData* meshData;
+		Game::BVH bvh;
+		Game::mat4 transform;
+	};
+
+	// @brief The original Scene::IntersectRay: every triangle of every entity, inverting each transform per ray
+	std::optional<float> IntersectBruteForce(std::span<const Instance> instances, const Game::Ray& ray)
+	{
+		auto result = std::optional<float>{};
+
+		for (const auto& instance : instances)
+		{
+			const auto invTransform = Game::mat4::Invert(instance.transform);
+			const auto transformedRay = Game::Ray{ invTransform * Game::vec4{ ray.origin, 1.0f }, invTransform * Game::vec4{ ray.direction, 0.0f } };
+
+			const auto& vertices = instance.meshData->vertices;
+			for (const auto& indices : std::views::chunk(instance.meshData->indices, 3))
+			{
+				if (const auto distance = Game::Intersect(transformedRay, vertices[indices[0]].position, vertices[indices[1]].position, vertices[indices[2]].position); distance)
+				{
+					// convert back to world space so results are comparable with the BVH path
+					const auto worldPoint = Game::vec3{ instance.transform * Game::vec4{ transformedRay.origin + transformedRay.direction * (*distance), 1.0f } };
+					const auto worldDistance = Game::vec3::Distance(ray.origin, worldPoint);
+					if (!result || worldDistance < *result)
+					{
+						result = worldDistance;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	// @brief Same traversal as Scene::IntersectRay, the entity BVH first and then the mesh BVHs of the entities it reaches
+	std::optional<float> IntersectBVH(std::span<const Instance> instances, const Game::DynamicBVH& entityBVH, const Game::Ray& ray)
+	{
+		auto result = std::optional<float>{};
+
+		entityBVH.Intersect(ray, std::numeric_limits<float>::max(), [&](auto index, auto closest)
+			{
+				const auto& instance = instances[index];
+				const auto hit = instance.bvh.Intersect(ray, instance.transform, closest).transform([](const auto& h) { return h.distance; });
+				if (hit)
+				{
+					result = hit;
+				}
+
+				return hit;
+			});
+
+		return result;
+	}
+
+	// @brief Coherently sorted packets of four, the single threaded core of Scene::IntersectRays
+	std::vector<std::optional<float>> IntersectPackets(std::span<const Instance> instances, const Game::DynamicBVH& entityBVH, std::span<const Game::Ray> rays)
+	{
+		auto hits = std::vector<std::optional<float>>(rays.size());
+		const auto order = Game::CoherentOrder(rays);
+
+		for (const auto indices : order | std::views::chunk(Game::RayPacket::kSize))
+		{
+			auto packet = Game::RayPacket{};
+			for (auto lane = 0u; lane < Game::RayPacket::kSize; ++lane)
+			{
+				packet.SetRay(lane, rays[indices[lane < indices.size() ? lane : 0u]]);
+			}
+
+			auto closest = Game::PacketDistances{};
+			closest.fill(std::numeric_limits<float>::max());
+			auto hitMask = 0u;
+			auto activeMask = (1u << indices.size()) - 1u;
+
+			entityBVH.IntersectPacket(packet, closest, activeMask, [&](auto index, auto mask)
+				{
+					const auto& instance = instances[index];
+					hitMask |= instance.bvh.IntersectPacket(packet, instance.transform, closest, mask);
+				});
+
+			for (const auto& [lane, index] : indices | std::views::enumerate)
+			{
+				hits[index] = (hitMask & (1u << lane)) ? std::make_optional(closest[lane]) : std::nullopt;
+			}
+		}
+
+		return hits;
+	}
+
+	std::vector<Game::Ray> RandomRays(const Game::AABB& bounds, size_t count)
+	{
+		auto rng = std::mt19937{ 1234u };
+		auto unit = std::uniform_real_distribution<float>{ 0.0f, 1.0f };
+
+		return std::views::iota(0zu, count) |
+			std::views::transform([&](auto)
+								  {
+									  const auto extent = bounds.Extent();
+									  const auto origin = bounds.min + Game::vec3{ unit(rng) * extent.x, unit(rng) * extent.y, unit(rng) * extent.z };
+
+									  // uniform direction on the unit sphere
+									  const auto z = unit(rng) * 2.0f - 1.0f;
+									  const auto phi = unit(rng) * 2.0f * std::numbers::pi_v<float>;
+									  const auto r = std::sqrt(1.0f - z * z);
+
+									  return Game::Ray{ origin, { r * std::cos(phi), r * std::sin(phi), z } };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	double RaysPerSecond(size_t count, std::chrono::steady_clock::duration elapsed)
+	{
+		return static_cast<double>(count) / std::chrono::duration<double>(elapsed).count();
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunRayBenchmarks()
+	{
+		std::println("== ray casting ({} random rays into de_dust2)", kRayCount);
+
+		auto resourceLoader = EmbeddedResourceLoader{};
+		const auto models = LoadModel(resourceLoader.LoadDataBuffer("models\\de_dust2.glb"), resourceLoader);
+
+		// same placement as the game
+		const auto transform = mat4{ Transform{ {}, { 0.1f }, { 0.0f, 0.0f, 1.0f, 0.0f } } };
+
+		const auto buildStart = std::chrono::steady_clock::now();
+		const auto instances = models |
+			std::views::transform([&](const auto& model)
+								  {
+									  const auto positions = model.meshData.vertices |
+										  std::views::transform([](const auto& vertex) { return vertex.position; }) |
+										  std::ranges::to<std::vector>();
+									  return Instance{ .meshData = &model.meshData, .bvh = BVH{ positions, model.meshData.indices }, .transform = transform };
+								  }) |
+			std::ranges::to<std::vector>();
+		const auto buildElapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+		const auto instanceBounds = instances |
+			std::views::transform([](const auto& instance) { return instance.bvh.GetBounds().Transform(instance.transform); }) |
+			std::ranges::to<std::vector>();
+
+		auto entityBVH = DynamicBVH{};
+		entityBVH.Build(instanceBounds);
+
+		auto bounds = AABB{};
+		auto triangleCount = 0zu;
+		auto nodeCount = 0zu;
+		for (const auto& [instance, instanceBound] : std::views::zip(instances, instanceBounds))
+		{
+			bounds.Grow(instanceBound);
+			triangleCount += instance.bvh.GetTriangleCount();
+			nodeCount += instance.bvh.GetNodes().size();
+		}
+
+		std::println("{} meshes, {} triangles, {} nodes, built in {:.2f} ms", instances.size(), triangleCount, nodeCount, buildElapsed);
+
+		const auto rays = RandomRays(bounds, kRayCount);
+
+		// brute force is orders of magnitude slower, so it only traces a prefix of the rays
+		auto bruteForceHits = std::vector<std::optional<float>>{};
+		const auto bruteForceStart = std::chrono::steady_clock::now();
+		for (const auto& ray : rays | std::views::take(kBruteForceRayCount))
+		{
+			bruteForceHits.push_back(IntersectBruteForce(instances, ray));
+		}
+		const auto bruteForceRate = RaysPerSecond(kBruteForceRayCount, std::chrono::steady_clock::now() - bruteForceStart);
+
+		auto bvhHits = std::vector<std::optional<float>>{};
+		bvhHits.reserve(kRayCount);
+		const auto bvhStart = std::chrono::steady_clock::now();
+		for (const auto& ray : rays)
+		{
+			bvhHits.push_back(IntersectBVH(instances, entityBVH, ray));
+		}
+		const auto bvhRate = RaysPerSecond(kRayCount, std::chrono::steady_clock::now() - bvhStart);
+
+		const auto packetStart = std::chrono::steady_clock::now();
+		const auto packetHits = IntersectPackets(instances, entityBVH, rays);
+		const auto packetRate = RaysPerSecond(kRayCount, std::chrono::steady_clock::now() - packetStart);
+
+		const auto mismatches = std::ranges::count_if(std::views::zip(bruteForceHits, bvhHits), [](const auto& hits)
+			{
+				const auto& [expected, actual] = hits;
+				if (expected.has_value() != actual.has_value())
+				{
+					return true;
+				}
+
+				return expected && std::abs(*expected - *actual) > 1e-3f * std::max(1.0f, *expected);
+			});
+
+		std::println("{:<40} {:>12.0f} rays/s ({} rays)", "before: brute force", bruteForceRate, kBruteForceRayCount);
+		std::println("{:<40} {:>12.0f} rays/s ({} rays)", "after: entity + mesh bvh", bvhRate, kRayCount);
+		std::println("{:<40} {:>12.0f} rays/s ({} rays)", "after: coherent packets", packetRate, kRayCount);
+		std::println("speedup {:.1f}x, {} mismatches in the first {} rays", bvhRate / bruteForceRate, mismatches, kBruteForceRayCount);
+		Check("bvh hits match brute force", mismatches == 0);
+
+		// packets replay the single ray arithmetic, so the hits must be identical
+		const auto packetMismatches = std::ranges::count_if(std::views::zip(bvhHits, packetHits), [](const auto& hits) { return std::get<0>(hits) != std::get<1>(hits); });
+		std::println("packets: {} mismatches against single rays", packetMismatches);
+		Check("packet hits match single rays", packetMismatches == 0);
+	}
+
+}
@@ -0,0 +1,202 @@
+#include "Benchmark.h"
+
+#include "Graphics/RenderGraph.h"
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+	using Game::Bench::Check;
+	using Game::Bench::Throws;
+
+	constexpr auto kChainLength = 1'000u;
+	constexpr auto kCompileIterations = 1'000zu;
+
+	constexpr auto kColor = Game::RenderTextureDesc{ .width = 1920u, .height = 1080u, .format = Game::TextureFormat::RGB16F };
+	constexpr auto kNormal = Game::RenderTextureDesc{ .width = 1920u, .height = 1080u, .format = Game::TextureFormat::RG16_SNORM };
+	constexpr auto kDepth = Game::RenderTextureDesc{ .width = 1920u, .height = 1080u, .format = Game::TextureFormat::DEPTH24 };
+
+	struct GraphDesc
+	{
+		std::vector<Game::RenderResourceDesc> resources;
+		std::vector<Game::RenderPassDesc> passes;
+
+		uint32_t Texture(std::string_view name, const Game::RenderTextureDesc& desc)
+		{
+			resources.push_back({ .name = std::string{ name }, .texture = desc });
+			return static_cast<uint32_t>(resources.size() - 1zu);
+		}
+
+		uint32_t Buffer(std::string_view name)
+		{
+			resources.push_back({ .name = std::string{ name }, .texture = std::nullopt });
+			return static_cast<uint32_t>(resources.size() - 1zu);
+		}
+
+		void Pass(std::string_view name, std::vector<Game::RenderResourceAccess> reads, std::vector<Game::RenderResourceAccess> writes, bool sideEffects = false)
+		{
+			passes.push_back({ .name = std::string{ name }, .reads = std::move(reads), .writes = std::move(writes), .sideEffects = sideEffects });
+		}
+
+		Game::CompiledRenderGraph Compile() const
+		{
+			return Game::CompileRenderGraph(resources, passes);
+		}
+
+		std::vector<std::string> Order(const Game::CompiledRenderGraph& compiled) const
+		{
+			return compiled.passes |
+				std::views::transform([&](const auto& pass) { return passes[pass.pass].name; }) |
+				std::ranges::to<std::vector>();
+		}
+	};
+
+	// @brief Post processing passes ping ponging between same sized targets, only neighbours are alive at the same time
+	GraphDesc Chain(uint32_t length)
+	{
+		auto graph = GraphDesc{};
+		auto previous = graph.Texture("scene", kColor);
+		graph.Pass("scene", {}, { { previous, Game::RenderAccess::COLOR_ATTACHMENT } });
+
+		for (auto index = 0u; index < length; ++index)
+		{
+			const auto next = graph.Texture(std::format("post_{}", index), kColor);
+			graph.Pass(std::format("post_{}", index), { { previous, Game::RenderAccess::SAMPLED } }, { { next, Game::RenderAccess::COLOR_ATTACHMENT } });
+			previous = next;
+		}
+
+		graph.Pass("present", { { previous, Game::RenderAccess::TRANSFER } }, {}, true);
+		return graph;
+	}
+
+	void CheckCompile()
+	{
+		{
+			// declared backwards, dependencies decide the order
+			auto graph = GraphDesc{};
+			const auto lit = graph.Texture("lit", kColor);
+			const auto albedo = graph.Texture("albedo", kColor);
+			const auto depth = graph.Texture("depth", kDepth);
+			graph.Pass("present", { { lit, Game::RenderAccess::TRANSFER } }, {}, true);
+			graph.Pass("light", { { albedo, Game::RenderAccess::SAMPLED }, { depth, Game::RenderAccess::SAMPLED } }, { { lit, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("gbuffer", {}, { { albedo, Game::RenderAccess::COLOR_ATTACHMENT }, { depth, Game::RenderAccess::DEPTH_ATTACHMENT } });
+			const auto compiled = graph.Compile();
+			Check("passes run after the writers of what they read", graph.Order(compiled) == std::vector<std::string>{ "gbuffer", "light", "present" });
+		}
+
+		{
+			// independent passes keep declaration order
+			auto graph = GraphDesc{};
+			const auto a = graph.Texture("a", kColor);
+			const auto b = graph.Texture("b", kColor);
+			graph.Pass("write_a", {}, { { a, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("write_b", {}, { { b, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("present", { { a, Game::RenderAccess::SAMPLED }, { b, Game::RenderAccess::SAMPLED } }, {}, true);
+			Check("independent passes keep declaration order", graph.Order(graph.Compile()) == std::vector<std::string>{ "write_a", "write_b", "present" });
+		}
+
+		{
+			auto graph = GraphDesc{};
+			const auto color = graph.Texture("color", kColor);
+			const auto debug = graph.Texture("debug", kColor);
+			graph.Pass("scene", {}, { { color, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("debug_view", { { color, Game::RenderAccess::SAMPLED } }, { { debug, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("present", { { color, Game::RenderAccess::TRANSFER } }, {}, true);
+			const auto compiled = graph.Compile();
+			Check("passes nothing presented depends on are culled", graph.Order(compiled) == std::vector<std::string>{ "scene", "present" });
+			Check("textures of culled passes get no memory", !compiled.lifetimes[debug] && !compiled.physicalTextures[debug] && compiled.physicalDescs.size() == 1zu);
+		}
+
+		{
+			const auto graph = Chain(4u);
+			const auto compiled = graph.Compile();
+			Check("ping pong chain aliases into two textures", compiled.physicalDescs.size() == 2zu);
+			Check("textures alive at the same time never alias", std::ranges::all_of(std::views::iota(1zu, graph.resources.size()), [&](auto resource)
+				{
+					return compiled.physicalTextures[resource] != compiled.physicalTextures[resource - 1zu];
+				}));
+			Check("lifetimes span writer to last reader", compiled.lifetimes[1] == Game::RenderResourceLifetime{ .first = 1u, .last = 2u });
+		}
+
+		{
+			// the normal target outlives the first color target but has another format, so only the colors alias
+			auto graph = GraphDesc{};
+			const auto first = graph.Texture("first", kColor);
+			const auto normal = graph.Texture("normal", kNormal);
+			const auto second = graph.Texture("second", kColor);
+			const auto third = graph.Texture("third", kColor);
+			graph.Pass("first", {}, { { first, Game::RenderAccess::COLOR_ATTACHMENT }, { normal, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("second", { { first, Game::RenderAccess::SAMPLED } }, { { second, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("third", { { second, Game::RenderAccess::SAMPLED }, { normal, Game::RenderAccess::SAMPLED } }, { { third, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("present", { { third, Game::RenderAccess::TRANSFER } }, {}, true);
+			const auto compiled = graph.Compile();
+			Check("only textures of the same description alias", compiled.physicalTextures[third] == compiled.physicalTextures[first] && compiled.physicalDescs.size() == 3zu);
+		}
+
+		{
+			auto graph = GraphDesc{};
+			const auto clusters = graph.Buffer("clusters");
+			const auto uploaded = graph.Buffer("uploaded");
+			const auto color = graph.Texture("color", kColor);
+			graph.Pass("assign", {}, { { clusters, Game::RenderAccess::STORAGE } });
+			graph.Pass("upload", {}, { { uploaded, Game::RenderAccess::TRANSFER } });
+			graph.Pass("shade", { { clusters, Game::RenderAccess::STORAGE }, { uploaded, Game::RenderAccess::STORAGE } }, { { color, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("present", { { color, Game::RenderAccess::TRANSFER } }, {}, true);
+			const auto compiled = graph.Compile();
+			Check("storage writes get a barrier before their readers", compiled.passes[2].barriers == GL_SHADER_STORAGE_BARRIER_BIT);
+			Check("attachment and transfer writes need no barrier", compiled.passes[0].barriers == 0u && compiled.passes[1].barriers == 0u && compiled.passes[3].barriers == 0u);
+			Check("buffers get no physical texture", !compiled.physicalTextures[clusters] && compiled.physicalDescs.size() == 1zu);
+		}
+
+		{
+			auto graph = GraphDesc{};
+			const auto a = graph.Texture("a", kColor);
+			const auto b = graph.Texture("b", kColor);
+			graph.Pass("first", { { b, Game::RenderAccess::SAMPLED } }, { { a, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("second", { { a, Game::RenderAccess::SAMPLED } }, { { b, Game::RenderAccess::COLOR_ATTACHMENT } }, true);
+			Check("cycles are rejected", Throws([&] { graph.Compile(); }));
+		}
+
+		{
+			auto graph = GraphDesc{};
+			const auto a = graph.Texture("a", kColor);
+			graph.Pass("first", {}, { { a, Game::RenderAccess::COLOR_ATTACHMENT } });
+			graph.Pass("second", {}, { { a, Game::RenderAccess::COLOR_ATTACHMENT } }, true);
+			Check("a second writer is rejected", Throws([&] { graph.Compile(); }));
+		}
+
+		{
+			auto graph = GraphDesc{};
+			const auto a = graph.Texture("a", kColor);
+			graph.Pass("present", { { a, Game::RenderAccess::SAMPLED } }, {}, true);
+			Check("reading what nothing writes is rejected", Throws([&] { graph.Compile(); }));
+		}
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunRenderGraphBenchmarks()
+	{
+		std::println("== render graph compile");
+
+		CheckCompile();
+
+		const auto chain = Chain(kChainLength);
+		const auto compiled = chain.Compile();
+		std::println("{} pass chain: {} textures in {} physical textures", kChainLength, chain.resources.size(), compiled.physicalDescs.size());
+
+		Run(std::format("compile {} pass chain", kChainLength), kCompileIterations, [&](auto)
+			{
+				DoNotOptimize(chain.Compile());
+			});
+	}
+
+}
@@ -0,0 +1,156 @@
+#include "Benchmark.h"
+
+#include "Core/Scene.h"
+#include "Graphics/Device.h"
+#include "Graphics/GPUMemory.h"
+#include "Graphics/MaterialManager.h"
+#include "Graphics/MeshManager.h"
+#include "Graphics/Renderer.h"
+#include "Graphics/TextureManager.h"
+#include "Graphics/Utils.h"
+#include "Resources/EmbeddedResourceLoader.h"
+#include "Utils/Formatter.h"
+
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	constexpr auto kEntityCount = 10'000zu;
+	constexpr auto kFrames = 200zu;
+	constexpr auto kRenderWidth = 1920u;
+	constexpr auto kRenderHeight = 1080u;
+	constexpr auto kTopCalls = 8zu;
+
+	// @brief Copies of the level's meshes on a grid around the camera, a quarter of them moved every frame
+	std::vector<Game::Entity> GridEntities(std::span<const Game::MeshView> meshViews, uint32_t materialIndex)
+	{
+		const auto side = static_cast<size_t>(std::sqrt(static_cast<float>(kEntityCount)));
+
+		return std::views::iota(0zu, kEntityCount) |
+			std::views::transform([&](auto index)
+								  {
+									  const auto position = Game::vec3{
+										  (static_cast<float>(index % side) - static_cast<float>(side) / 2.0f) * 10.0f,
+										  0.0f,
+										  (static_cast<float>(index / side) - static_cast<float>(side) / 2.0f) * 10.0f
+									  };
+									  return Game::Entity{
+										  .name = std::format("entity{}", index),
+										  .mesh = meshViews[index % meshViews.size()].handle,
+										  .transform = { position, { 0.01f }, { 0.0f, 0.0f, 1.0f, 0.0f } },
+										  .materialIndex = materialIndex
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	void RenderFrames(Game::Renderer& renderer, Game::Scene& scene, Game::CullingMode mode)
+	{
+		renderer.SetCullingMode(mode);
+		renderer.Render(scene);
+		Game::Device::ResetStats();
+		renderer.GetProfiler().ResetStats();
+
+		const auto start = std::chrono::steady_clock::now();
+		for (auto frame = 0zu; frame < kFrames; ++frame)
+		{
+			for (auto index = frame % 4zu; index < scene.entities.size(); index += 4zu)
+			{
+				scene.entities[index].transform.Position.y = static_cast<float>(frame % 8zu);
+			}
+
+			renderer.Render(scene);
+		}
+		const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		const auto stats = Game::Device::GetStats();
+		std::println("{} culling: {:.1f} us/frame", mode, elapsed / static_cast<double>(kFrames));
+		std::println("  per frame: {} calls, {} draws, {} dispatches, {} bytes uploaded, {} bytes copied",
+			stats.callCount / kFrames,
+			stats.drawCount / kFrames,
+			stats.dispatchCount / kFrames,
+			stats.bytesUploaded / kFrames,
+			stats.bytesCopied / kFrames);
+		for (const auto& [name, count] : Game::Device::GetCallCounts() | std::views::take(kTopCalls))
+		{
+			std::println("  {:<40} {:>8.1f} /frame", name, static_cast<double>(count) / static_cast<double>(kFrames));
+		}
+
+		// the recording backend stamps queries with the host clock, GPU zones measure command submission
+		const auto& profiler = renderer.GetProfiler();
+		std::println("  profiler zones in ms, {} dropped frames", profiler.GetDroppedFrames());
+		for (const auto& zone : profiler.GetZones() | std::views::filter([](const auto& zone) { return zone.gpu.count > 0zu; }))
+		{
+			std::println("  {:<40} gpu {} | cpu {}", std::format("{:{}}{}", "", zone.depth * 2u, zone.name), zone.gpu, zone.cpu);
+		}
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunRendererBenchmarks()
+	{
+		std::println("== headless renderer ({} entities, {} frames, recording device backend)", kEntityCount, kFrames);
+
+		Device::UseRecordingBackend();
+
+		auto resourceLoader = EmbeddedResourceLoader{};
+		auto models = LoadModel(resourceLoader.LoadDataBuffer("models\\de_dust2.glb"), resourceLoader);
+		const auto meshData = models |
+			std::views::transform([](auto& model) { return std::move(model.meshData); }) |
+			std::ranges::to<std::vector>();
+
+		auto meshManager = MeshManager{ VertexFormat::PACKED };
+		auto materialManager = MaterialManager{};
+		auto textureManager = TextureManager{};
+
+		const auto setupStart = std::chrono::steady_clock::now();
+		const auto meshViews = meshManager.LoadAll(meshData);
+		const auto material = materialManager.Add(0u, 0u, 0u);
+		auto renderer = Renderer{ kRenderWidth, kRenderHeight, resourceLoader, textureManager, meshManager };
+
+		auto scene = Scene{
+			.entities = GridEntities(meshViews, material),
+			.meshManager = meshManager,
+			.materialManager = materialManager,
+			.textureManager = textureManager,
+			.camera = {
+				{ 0.0f, 50.0f, 0.0f },
+				{ 0.0f, -0.5f, -1.0f },
+				{ 0.0f, 1.0f, 0.0f },
+				std::numbers::pi_v<float> / 4.0f,
+				static_cast<float>(kRenderWidth), static_cast<float>(kRenderHeight),
+				0.1f, 1000.0f
+			},
+			.lights = {}
+		};
+
+		renderer.Reserve({ .entityCount = scene.entities.size(), .meshCount = meshViews.size(), .lightCount = scene.lights.pointLights.size() });
+		const auto setupElapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupStart).count();
+
+		std::println("setup: {:.2f} ms, {}", setupElapsed, Device::GetStats());
+
+		RenderFrames(renderer, scene, CullingMode::CPU);
+		RenderFrames(renderer, scene, CullingMode::GPU);
+
+		// the level's textures are not loaded, the texture category is the render targets the graph created on the first frame
+		const auto textureBytes = GPUMemory::GetStats().categoryBytes[std::to_underlying(GPUMemoryCategory::TEXTURE)];
+		std::println("render targets: {:.2f} MiB, {:.1f} bytes per pixel", static_cast<double>(textureBytes) / (1024.0 * 1024.0), static_cast<double>(textureBytes) / (kRenderWidth * kRenderHeight));
+
+		// the reload takes the freed index, handles to the unloaded mesh must not find it
+		const auto unloaded = meshViews.front().handle;
+		meshManager.Unload(meshViews.front());
+		const auto reloaded = meshManager.Load(meshData.front()).handle;
+		Check("reloaded meshes reuse the index", reloaded.index == unloaded.index);
+		Check("stale handles are not loaded", !meshManager.IsLoaded(unloaded) && meshManager.IsLoaded(reloaded));
+	}
+
+}
@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+
+#include "Graphics/Utils.h"
+#include "Graphics/VertexData.h"
+#include "Math/Vector3.h"
+#include "Resources/EmbeddedResourceLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <ranges>
+#include <vector>
+
+namespace {
+
+	constexpr auto kIterations = 10'000'000zu;
+
+	struct RoundTripError
+	{
+		float position = 0.0f;			// absolute, object space
+		float positionRelative = 0.0f;	// fraction of the mesh extent on that axis
+		float normal = 0.0f;			// degrees
+		float tangent = 0.0f;
+		float bitangent = 0.0f;
+		float uv = 0.0f;
+	};
+
+	// @brief Angle between two directions, atan2 keeps precision for the tiny angles quantization produces
+	float AngleDegrees(const Game::vec3& a, const Game::vec3& b)
+	{
+		if (a.Length() == 0.0f || b.Length() == 0.0f)
+		{
+			return 0.0f;
+		}
+
+		const auto na = Game::vec3::Normalize(a);
+		const auto nb = Game::vec3::Normalize(b);
+		return std::atan2(Game::vec3::Cross(na, nb).Length(), Game::vec3::Dot(na, nb)) * 180.0f / std::numbers::pi_v<float>;
+	}
+
+	void Accumulate(RoundTripError& error, const Game::VertexData& original, const Game::VertexData& decoded, const Game::PositionQuantization& quantization)
+	{
+		const float deltas[] = {
+			std::abs(decoded.position.x - original.position.x),
+			std::abs(decoded.position.y - original.position.y),
+			std::abs(decoded.position.z - original.position.z)
+		};
+		const float extents[] = { quantization.scale.x, quantization.scale.y, quantization.scale.z };
+
+		for (const auto [delta, extent] : std::views::zip(deltas, extents))
+		{
+			error.position = std::max(error.position, delta);
+			if (extent > 0.0f)
+			{
+				error.positionRelative = std::max(error.positionRelative, delta / extent);
+			}
+		}
+
+		error.normal = std::max(error.normal, AngleDegrees(original.normal, decoded.normal));
+		error.tangent = std::max(error.tangent, AngleDegrees(original.tangent, decoded.tangent));
+		error.bitangent = std::max(error.bitangent, AngleDegrees(original.bitangent, decoded.bitangent));
+		error.uv = std::max({ error.uv, std::abs(decoded.uv.s - original.uv.s), std::abs(decoded.uv.t - original.uv.t) });
+	}
+
+}
+
+namespace Game::Bench {
+
+	void RunVertexBenchmarks()
+	{
+		std::println("== vertex compression ({} -> {} bytes per vertex)", sizeof(VertexData), sizeof(PackedVertexData));
+
+		auto halfMismatches = 0zu;
+		for (auto bits = 0u; bits <= 0xffffu; ++bits)
+		{
+			const auto half = static_cast<uint16_t>(bits);
+			const auto value = HalfToFloat(half);
+			if (!std::isnan(value) && FloatToHalf(value) != half)
+			{
+				++halfMismatches;
+			}
+		}
+		std::println("half round trip: {} mismatches over all 65536 values", halfMismatches);
+		Check("every half survives a float round trip", halfMismatches == 0zu);
+
+		auto resourceLoader = EmbeddedResourceLoader{};
+		const auto models = LoadModel(resourceLoader.LoadDataBuffer("models\\de_dust2.glb"), resourceLoader);
+
+		auto error = RoundTripError{};
+		auto vertices = std::vector<VertexData>{};
+		auto packed = std::vector<PackedVertexData>{};
+		auto quantizations = std::vector<PositionQuantization>{};
+
+		for (const auto& model : models)
+		{
+			const auto quantization = PositionQuantization::FromBounds(Bounds(model.meshData.vertices));
+			for (const auto& vertex : model.meshData.vertices)
+			{
+				const auto encoded = Pack(vertex, quantization);
+				Accumulate(error, vertex, Unpack(encoded, quantization), quantization);
+
+				vertices.push_back(vertex);
+				packed.push_back(encoded);
+				quantizations.push_back(quantization);
+			}
+		}
+
+		std::println("{} vertices in {} meshes, {} -> {} bytes", vertices.size(), models.size(), vertices.size() * sizeof(VertexData), packed.size() * sizeof(PackedVertexData));
+		std::println("max position error {} ({:.2e} of the mesh extent, bound {:.2e})", error.position, error.positionRelative, 0.5 / 65535.0);
+		std::println("max normal error {:.4f} deg, tangent {:.4f} deg, bitangent {:.4f} deg", error.normal, error.tangent, error.bitangent);
+		std::println("max uv error {}", error.uv);
+
+		if (vertices.empty())
+		{
+			return;
+		}
+
+		Run("Pack", kIterations, [&](auto i)
+			{
+				const auto index = i % vertices.size();
+				const auto result = Pack(vertices[index], quantizations[index]);
+				DoNotOptimize(result);
+			});
+
+		Run("Unpack", kIterations, [&](auto i)
+			{
+				const auto index = i % packed.size();
+				const auto result = Unpack(packed[index], quantizations[index]);
+				DoNotOptimize(result);
+			});
+	}
+
+}
@@ -0,0 +1,49 @@
+#include "Benchmark.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <functional>
+#include <print>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+	const std::pair<std::string_view, std::function<void()>> g_Benchmarks[] = {
+		{ "matrix", Game::Bench::RunMatrixBenchmarks },
+		{ "ray", Game::Bench::RunRayBenchmarks },
+		{ "vertex", Game::Bench::RunVertexBenchmarks },
+		{ "mesh", Game::Bench::RunMeshBenchmarks },
+		{ "culling", Game::Bench::RunCullingBenchmarks },
+		{ "renderer", Game::Bench::RunRendererBenchmarks },
+		{ "lights", Game::Bench::RunLightBenchmarks },
+		{ "rendergraph", Game::Bench::RunRenderGraphBenchmarks },
+		{ "dynamicresolution", Game::Bench::RunDynamicResolutionBenchmarks },
+	};
+
+}
+
+int main(int argc, char** argv)
+{
+	std::println("Benchmarks for game version: {}.{}.{}", Game::Version::MAJOR, Game::Version::MINOR, Game::Version::PATCH);
+
+	const auto filters = std::span{ argv + 1, argv + argc };
+
+	for (const auto& [name, benchmark] : g_Benchmarks)
+	{
+		if (filters.empty() || std::ranges::contains(filters, name, [](const char* arg) { return std::string_view{ arg }; }))
+		{
+			benchmark();
+		}
+	}
+
+	if (const auto failed = Game::Bench::GetFailedChecks(); failed > 0zu)
+	{
+		std::println("{} checks FAILED", failed);
+		return 1;
+	}
+
+	return 0;
+}
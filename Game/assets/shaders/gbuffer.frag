@@ -13,7 +13,10 @@ struct VertexData
 struct ObjectData
 {
 	mat4 model;
+	float position_offset[3];
 	uint material_index;
+	float position_scale[3];
+	uint pad;
 };
 
 struct MaterialData
@@ -53,13 +56,23 @@ layout(binding = 4, std430) readonly buffer textures_buffer
 
 layout(location = 0) in flat uint in_material_index;
 layout(location = 1) in vec2 in_uv;
-layout(location = 2) in vec4 in_frag_position;
-layout(location = 3) in mat3 in_tbn;
+layout(location = 2) in mat3 in_tbn;
 
-layout(location = 0) out vec4 out_color;
-layout(location = 1) out vec4 out_normal;
-layout(location = 2) out vec4 out_pos;
-layout(location = 3) out vec4 out_specular;
+// see the gbuffer pass in Game::Renderer::Render, positions are not stored as the light pass reconstructs them from depth
+layout(location = 0) out vec4 out_albedo_specular;
+layout(location = 1) out vec2 out_normal;
+
+// inverse of oct_decode in gbuffer.vert, the snorm target stores it with 16 bits per component
+vec2 oct_encode(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	if (n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return n.xy;
+}
 
 void main()
 {
@@ -71,8 +84,6 @@ void main()
 	n = (n * 2.0) - 1.0;
 	n = normalize(in_tbn * n);
 
-	out_color = vec4(texture(textures[albedoTexIndex], in_uv).rgb, 1.0);
-	out_normal = vec4(n, 1.0);
-	out_pos = in_frag_position;
-	out_specular = vec4(texture(textures[specularTexIndex], in_uv).r, 0.0, 0.0, 1.0);
+	out_albedo_specular = vec4(texture(textures[albedoTexIndex], in_uv).rgb, texture(textures[specularTexIndex], in_uv).r);
+	out_normal = oct_encode(n);
 }
\ No newline at end of file
@@ -9,10 +9,23 @@ struct VertexData
 	float uv[2];
 };
 
+// see PackedVertexData, two 16 bit values per word with the first one in the low bits
+struct PackedVertexData
+{
+	uint position_xy;
+	uint position_z_bitangent_sign;
+	uint normal;
+	uint tangent;
+	uint uv;
+};
+
 struct ObjectData
 {
 	mat4 model;
+	float position_offset[3];
 	uint material_index;
+	float position_scale[3];
+	uint pad;
 };
 
 struct MaterialData
@@ -27,6 +40,11 @@ layout(binding = 0, std430) readonly buffer vertices
 	VertexData data[];
 };
 
+layout(binding = 0, std430) readonly buffer packed_vertices
+{
+	PackedVertexData packedData[];
+};
+
 layout(binding = 1, std430) readonly buffer camera
 {
 	mat4 view;
@@ -40,52 +58,103 @@ layout(binding = 2, std430) readonly buffer objects
 	ObjectData objectData[];
 };
 
+layout(binding = 6, std430) readonly buffer instances
+{
+	uint instanceEntities[];
+};
+
 layout(binding = 3, std430) readonly buffer materials
 {
 	MaterialData materialData[];
 };
 
+const uint VERTEX_FORMAT_FULL = 0;
+const uint VERTEX_FORMAT_PACKED = 1;
+
+layout(location = 0) uniform uint vertex_format;
+
+vec3 oct_decode(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (v.z < 0.0)
+	{
+		v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return normalize(v);
+}
+
+// position before applying the per object offset and scale, in [0, 1] for packed vertices
 vec3 get_position(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return vec3(unpackUnorm2x16(packedData[index].position_xy), unpackUnorm2x16(packedData[index].position_z_bitangent_sign).x);
+	}
+
 	return vec3(data[index].position[0], data[index].position[1], data[index].position[2]);
 }
 
 vec3 get_normal(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return oct_decode(unpackSnorm2x16(packedData[index].normal));
+	}
+
 	return vec3(data[index].normal[0], data[index].normal[1], data[index].normal[2]);
 }
 
 vec3 get_tangent(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return oct_decode(unpackSnorm2x16(packedData[index].tangent));
+	}
+
 	return vec3(data[index].tangent[0], data[index].tangent[1], data[index].tangent[2]);
 }
 
 vec3 get_bitangent(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		float bitangentSign = unpackSnorm2x16(packedData[index].position_z_bitangent_sign).y;
+		return cross(get_normal(index), get_tangent(index)) * bitangentSign;
+	}
+
 	return vec3(data[index].bitangent[0], data[index].bitangent[1], data[index].bitangent[2]);
 }
 
 vec2 get_uv(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return unpackHalf2x16(packedData[index].uv);
+	}
+
 	return vec2(data[index].uv[0], data[index].uv[1]);
 }
 
 layout(location = 0) out flat uint out_material_index;
 layout(location = 1) out vec2 out_uv;
-layout(location = 2) out vec4 out_frag_position;
-layout(location = 3) out mat3 out_tbn;
+layout(location = 2) out mat3 out_tbn;
 
 void main()
 {
-	mat3 normalMat = transpose(inverse(mat3(objectData[gl_DrawID].model)));
+	// instance slots map to entities, gl_DrawID restarts with every multi draw call
+	uint object_index = instanceEntities[gl_BaseInstance + gl_InstanceID];
+
+	vec3 positionOffset = vec3(objectData[object_index].position_offset[0], objectData[object_index].position_offset[1], objectData[object_index].position_offset[2]);
+	vec3 positionScale = vec3(objectData[object_index].position_scale[0], objectData[object_index].position_scale[1], objectData[object_index].position_scale[2]);
 
-	out_frag_position = objectData[gl_DrawID].model * vec4(get_position(gl_VertexID), 1.0);
-	gl_Position = projection * view * out_frag_position;
-	out_material_index = objectData[gl_DrawID].material_index;
+	vec4 worldPosition = objectData[object_index].model * vec4(positionOffset + positionScale * get_position(gl_VertexID), 1.0);
+	gl_Position = projection * view * worldPosition;
+	out_material_index = objectData[object_index].material_index;
 	out_uv = get_uv(gl_VertexID);
 
-	vec3 t = normalize(vec3(objectData[gl_DrawID].model * vec4(get_tangent(gl_VertexID), 0.0)));
-	vec3 b = normalize(vec3(objectData[gl_DrawID].model * vec4(get_bitangent(gl_VertexID), 0.0)));
-	vec3 n = normalize(vec3(objectData[gl_DrawID].model * vec4(get_normal(gl_VertexID), 0.0)));
+	vec3 t = normalize(vec3(objectData[object_index].model * vec4(get_tangent(gl_VertexID), 0.0)));
+	vec3 b = normalize(vec3(objectData[object_index].model * vec4(get_bitangent(gl_VertexID), 0.0)));
+	vec3 n = normalize(vec3(objectData[object_index].model * vec4(get_normal(gl_VertexID), 0.0)));
 	out_tbn = mat3(t, b, n);
 }
\ No newline at end of file
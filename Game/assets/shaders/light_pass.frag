@@ -20,13 +20,21 @@ layout(binding = 1, std430) readonly buffer textures_buffer
 	sampler2D textures[];
 };
 
+struct PointLight
+{
+	float position[3];
+	float color[3];
+	float constant_attenuation;
+	float linear_attenuation;
+	float quadratic_attenuation;
+	float specular_power;
+};
+
 layout(binding = 2, std430) readonly buffer lights
 {
 	float ambientColor[3];
-	float pointLightPos[3];
-	float pointLightColor[3];
-	float pointLightAttenuation[3];
-	float pointLightSpecularPower;
+	uint lightCount;
+	PointLight pointLights[];
 };
 
 layout(binding = 3, std430) readonly buffer camera
@@ -37,40 +45,91 @@ layout(binding = 3, std430) readonly buffer camera
 	float pad;
 };
 
-layout(location = 0) uniform uint albedo_tex_index;
+// light index range per cluster, written by Game::AssignLights or light_cluster.comp
+layout(binding = 4, std430) readonly buffer clusters
+{
+	uvec2 clusterRanges[];
+};
+
+layout(binding = 5, std430) readonly buffer light_indices
+{
+	uint lightIndices[];
+};
+
+layout(location = 0) uniform uint albedo_specular_tex_index;
 layout(location = 1) uniform uint normal_tex_index;
-layout(location = 2) uniform uint position_tex_index;
-layout(location = 3) uniform uint specular_tex_index;
+layout(location = 2) uniform uint depth_tex_index;
+layout(location = 3) uniform mat4 inverse_view_projection;
+// locations 4 to 6 are used by the vertex shader
+layout(location = 7) uniform uvec3 cluster_dims;
+layout(location = 8) uniform vec2 cluster_tile_size;
+layout(location = 9) uniform vec2 cluster_depth;	// near plane, slices per unit of log depth
 
-layout(location = 0) in vec4 in_frag_position;
 layout(location = 1) in vec2 in_uv;
 
 layout(location = 0) out vec4 out_color;
 
-void main()
+// same froxel as Game::ClusterGrid, tiles are counted from the bottom left like gl_FragCoord
+uint cluster_index(vec3 fragPos)
 {
-	vec3 albedo = texture(textures[albedo_tex_index], in_uv).rgb;
-	vec3 normal = texture(textures[normal_tex_index], in_uv).xyz;
-	vec3 fragPos = texture(textures[position_tex_index], in_uv).xyz;
-	float specular = texture(textures[specular_tex_index], in_uv).r;
+	float depth = max(-(view * vec4(fragPos, 1.0)).z, cluster_depth.x);
+	uint slice = min(uint(log(depth / cluster_depth.x) * cluster_depth.y), cluster_dims.z - 1u);
+	uvec2 tile = min(uvec2(gl_FragCoord.xy / cluster_tile_size), cluster_dims.xy - 1u);
 
-	vec3 pointPos = vec3(pointLightPos[0], pointLightPos[1], pointLightPos[2]);
-	vec3 pointColor = vec3(pointLightColor[0], pointLightColor[1], pointLightColor[2]);
-	vec3 pointAttenuation = vec3(pointLightAttenuation[0], pointLightAttenuation[1], pointLightAttenuation[2]);
+	return tile.x + (tile.y * cluster_dims.x) + (slice * cluster_dims.x * cluster_dims.y);
+}
 
-	vec3 ambient = vec3(ambientColor[0], ambientColor[1], ambientColor[2]);
-	vec3 lightDir = normalize(pointPos - fragPos);
-	float diffuse = max(dot(normal, lightDir), 0.0);
+vec3 oct_decode(vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (v.z < 0.0)
+	{
+		v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return normalize(v);
+}
+
+// world space position of the g-buffer texel from its window depth
+vec3 reconstruct_position(vec2 uv, float depth)
+{
+	vec4 position = inverse_view_projection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	return position.xyz / position.w;
+}
+
+void main()
+{
+	vec4 albedoSpecular = texture(textures[albedo_specular_tex_index], in_uv);
+	vec3 albedo = albedoSpecular.rgb;
+	float specular = albedoSpecular.a;
+	vec3 normal = oct_decode(texture(textures[normal_tex_index], in_uv).xy);
+	vec3 fragPos = reconstruct_position(in_uv, texture(textures[depth_tex_index], in_uv).r);
 
+	vec3 ambient = vec3(ambientColor[0], ambientColor[1], ambientColor[2]);
 	vec3 cameraPos = vec3(cameraPosition[0], cameraPosition[1], cameraPosition[2]);
+	vec3 viewDir = normalize(cameraPos - fragPos);
+
+	vec3 lighting = ambient * albedo;
+
+	uvec2 range = clusterRanges[cluster_index(fragPos)];
+	for (uint i = 0u; i < range.y; ++i)
+	{
+		PointLight light = pointLights[lightIndices[range.x + i]];
+
+		vec3 pointPos = vec3(light.position[0], light.position[1], light.position[2]);
+		vec3 pointColor = vec3(light.color[0], light.color[1], light.color[2]);
+
+		vec3 lightDir = normalize(pointPos - fragPos);
+		float diffuse = max(dot(normal, lightDir), 0.0);
 
-	vec3 reflectDir = reflect(-lightDir, normal);
-	float spec = pow(max(dot(normalize(cameraPos - fragPos), reflectDir), 0.0), pointLightSpecularPower) * specular;
+		vec3 reflectDir = reflect(-lightDir, normal);
+		float spec = pow(max(dot(viewDir, reflectDir), 0.0), light.specular_power) * specular;
 
-	float distance = length(pointPos - fragPos);
-	float att = 1.0 / (pointAttenuation.x + (pointAttenuation.y * distance) + (pointAttenuation.z * (distance * distance)));
+		float distance = length(pointPos - fragPos);
+		float att = 1.0 / (light.constant_attenuation + (light.linear_attenuation * distance) + (light.quadratic_attenuation * (distance * distance)));
 
-	vec3 lighting = (ambient * albedo) + ((diffuse + spec) * att) * pointColor * albedo;
+		lighting += ((diffuse + spec) * att) * pointColor * albedo;
+	}
 
 	out_color = vec4(lighting, 1.0);
 }
\ No newline at end of file
@@ -9,26 +9,57 @@ struct VertexData
 	float uv[2];
 };
 
+struct PackedVertexData
+{
+	uint position_xy;
+	uint position_z_bitangent_sign;
+	uint normal;
+	uint tangent;
+	uint uv;
+};
+
 layout(binding = 0, std430) readonly buffer vertices
 {
 	VertexData data[];
 };
 
+layout(binding = 0, std430) readonly buffer packed_vertices
+{
+	PackedVertexData packedData[];
+};
+
+const uint VERTEX_FORMAT_FULL = 0;
+const uint VERTEX_FORMAT_PACKED = 1;
+
+// locations 0 to 3 are the g-buffer texture indices and the inverse view projection of the fragment shader
+layout(location = 4) uniform uint vertex_format;
+layout(location = 5) uniform vec3 position_offset;
+layout(location = 6) uniform vec3 position_scale;
+
 vec3 get_position(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return vec3(unpackUnorm2x16(packedData[index].position_xy), unpackUnorm2x16(packedData[index].position_z_bitangent_sign).x);
+	}
+
 	return vec3(data[index].position[0], data[index].position[1], data[index].position[2]);
 }
 
 vec2 get_uv(uint index)
 {
+	if (vertex_format == VERTEX_FORMAT_PACKED)
+	{
+		return unpackHalf2x16(packedData[index].uv);
+	}
+
 	return vec2(data[index].uv[0], data[index].uv[1]);
 }
 
-layout(location = 0) out vec4 out_frag_position;
 layout(location = 1) out vec2 out_uv;
 
 void main()
 {
-	gl_Position = vec4(get_position(gl_VertexID), 1.0);
+	gl_Position = vec4(position_offset + position_scale * get_position(gl_VertexID), 1.0);
 	out_uv = get_uv(gl_VertexID);
 }
\ No newline at end of file
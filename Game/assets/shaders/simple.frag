@@ -13,7 +13,10 @@ struct VertexData
 struct ObjectData
 {
 	mat4 model;
+	float position_offset[3];
 	uint material_index;
+	float position_scale[3];
+	uint pad;
 };
 
 struct MaterialData
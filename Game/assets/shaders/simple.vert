@@ -12,7 +12,10 @@ struct VertexData
 struct ObjectData
 {
 	mat4 model;
+	float position_offset[3];
 	uint material_index;
+	float position_scale[3];
+	uint pad;
 };
 
 struct MaterialData
@@ -40,6 +43,11 @@ layout(binding = 2, std430) readonly buffer objects
 	ObjectData objectData[];
 };
 
+layout(binding = 6, std430) readonly buffer instances
+{
+	uint instanceEntities[];
+};
+
 layout(binding = 3, std430) readonly buffer materials
 {
 	MaterialData materialData[];
@@ -86,15 +94,18 @@ layout(location = 3) out mat3 out_tbn;
 
 void main()
 {
-	mat3 normalMat = transpose(inverse(mat3(objectData[gl_DrawID].model)));
+	// instance slots map to entities, gl_DrawID restarts with every multi draw call
+	uint object_index = instanceEntities[gl_BaseInstance + gl_InstanceID];
+
+	mat3 normalMat = transpose(inverse(mat3(objectData[object_index].model)));
 
-	out_frag_position = objectData[gl_DrawID].model * vec4(get_position(gl_VertexID), 1.0);
+	out_frag_position = objectData[object_index].model * vec4(get_position(gl_VertexID), 1.0);
 	gl_Position = projection * view * out_frag_position;
-	out_material_index = objectData[gl_DrawID].material_index;
+	out_material_index = objectData[object_index].material_index;
 	out_uv = get_uv(gl_VertexID);
 
-	vec3 t = normalize(vec3(objectData[gl_DrawID].model * vec4(get_tangent(gl_VertexID), 0.0)));
-	vec3 b = normalize(vec3(objectData[gl_DrawID].model * vec4(get_bitangent(gl_VertexID), 0.0)));
-	vec3 n = normalize(vec3(objectData[gl_DrawID].model * vec4(get_normal(gl_VertexID), 0.0)));
+	vec3 t = normalize(vec3(objectData[object_index].model * vec4(get_tangent(gl_VertexID), 0.0)));
+	vec3 b = normalize(vec3(objectData[object_index].model * vec4(get_bitangent(gl_VertexID), 0.0)));
+	vec3 n = normalize(vec3(objectData[object_index].model * vec4(get_normal(gl_VertexID), 0.0)));
 	out_tbn = mat3(t, b, n);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Graphics/Shader.h"
 #include "Graphics/Renderer.h"
 #include "Graphics/MeshData.h"
+#include "Graphics/MeshOptimizer.h"
 #include "Graphics/DebugRenderer.h"
 #include "Graphics/TextureManager.h"
 #include "Graphics/Utils.h"
@@ -13,12 +14,19 @@
 #include "Utils/Log.h"
 #include "Utils/SystemInfo.h"
 
+#include <algorithm>
 #include <numbers>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <unordered_map>
 
 namespace {
 
+	// meshes are only unloaded now and then, most frames have nothing to move
+	constexpr auto kDefragmentThreshold = 0.25f;
+	constexpr auto kDefragmentBytesPerFrame = 1024zu * 1024zu;
+
 	Game::MeshData Cube()
 	{
 		const Game::vec3 positions[] = {
@@ -126,10 +134,17 @@ namespace {
 		return Game::vec3::Normalize(direction) * speed;
 	}
 
+	bool HasSwitch(std::span<char*> args, std::string_view name)
+	{
+		return std::ranges::any_of(args, [name](const auto* arg) { return name == arg; });
+	}
+
 }
 
-int main()
+int main(int argc, char** argv)
 {
+	const auto args = std::span{ argv, static_cast<size_t>(argc) }.subspan(1zu);
+
 	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
 
 	Game::Log::Info("Game version: {}.{}.{}", Game::Version::MAJOR, Game::Version::MINOR, Game::Version::PATCH);
@@ -154,7 +169,11 @@ int main()
 	const auto diamondFloorSpecular = Game::LoadTexture(diamondFloorSpecularData);
 	textures.push_back(Game::Texture{ diamondFloorSpecular, "diamond_floor_specular", sampler });
 
-	auto meshManager = Game::MeshManager{};
+	// packed vertices quantize uvs and tangents, opt in once the content was checked to survive it
+	const auto vertexFormat = HasSwitch(args, "--packed-vertices") ? Game::VertexFormat::PACKED : Game::VertexFormat::FULL;
+	Game::Log::Info("Vertex format {}", vertexFormat);
+
+	auto meshManager = Game::MeshManager{ vertexFormat };
 	auto materialManager = Game::MaterialManager{};
 	auto textureManager = Game::TextureManager{};
 
@@ -167,7 +186,20 @@ int main()
 	const auto materialIndexBlue = materialManager.Add(texIndex, texIndex + 1u, texIndex + 2u);
 	const auto materialIndexGreen = materialManager.Add(texIndex, texIndex + 1u, texIndex + 2u);
 
-	const auto models = Game::LoadModel(resourceLoader->LoadDataBuffer("models\\de_dust2.glb"), *resourceLoader);
+	auto models = Game::LoadModel(resourceLoader->LoadDataBuffer("models\\de_dust2.glb"), *resourceLoader);
+	auto meshData = models |
+		std::views::transform([](auto& model) { return std::move(model.meshData); }) |
+		std::ranges::to<std::vector>();
+	auto weldTotal = Game::WeldStats{ .verticesBefore = 0u, .verticesAfter = 0u };
+	for (const auto& [index, weld] : Game::WeldMeshes(meshData) | std::views::enumerate)
+	{
+		Game::Log::Trace("model{} welded {}", index, weld);
+		weldTotal += weld;
+	}
+	Game::Log::Info("Vertex welding {}", weldTotal);
+	Game::Log::Info("Mesh optimization {}", Game::OptimizeMeshes(meshData));
+	const auto meshViews = meshManager.LoadAll(meshData);
+	Game::Log::Info("{}", meshManager);
 
 	auto scene = Game::Scene{
 		.entities = {},
@@ -184,13 +216,15 @@ int main()
 		},
 		.lights = {
 			.ambient = {0.5f, 0.5f, 0.5f},
-			.light = {
-				.position = {},
-				.color = { 1.0f, 1.0f, 1.0f },
-				.constantAttenuation = 1.0f,
-				.linearAttenuation = 0.007f,
-				.quadraticAttenuation = 0.0002f,
-				.specularPower = 32.0f
+			.pointLights = {
+				{
+					.position = {},
+					.color = { 1.0f, 1.0f, 1.0f },
+					.constantAttenuation = 1.0f,
+					.linearAttenuation = 0.007f,
+					.quadraticAttenuation = 0.0002f,
+					.specularPower = 32.0f
+				}
 			}
 		}
 	};
@@ -205,14 +239,28 @@ int main()
 		}
 		const auto modelMat = materialManager.Add(albedoIndex, texIndex + 1u, texIndex + 2u);
 
-		scene.entities.push_back({
+		scene.AddEntity({
 			.name = std::format("model{}", index),
-			.meshView = meshManager.Load(model.meshData),
+			.mesh = meshViews[index].handle,
 			.transform = {{}, {0.1f}, {0.0f, 0.0f, 1.0f, 0.0f}},
 			.materialIndex = modelMat
 		});
 	}
 
+	// sized for the level up front so no per frame buffer grows once play starts
+	renderer.Reserve({ .entityCount = scene.entities.size(), .meshCount = meshViews.size(), .lightCount = scene.lights.pointLights.size() });
+
+	// holds 144 Hz on the GPU by rendering down to half the window size
+	renderer.SetDynamicResolution(Game::DynamicResolutionConfig{
+		.targetFrameTime = 1000.0f / 144.0f,
+		.minScale = 0.5f,
+		.maxScale = 1.0f,
+		.scaleStep = 0.05f,
+		.headroom = 0.9f,
+		.growFrames = 30u,
+		.settleFrames = static_cast<uint32_t>(Game::GPUProfiler::kFrameSlots)
+	});
+
 	auto keyState = std::unordered_map<Game::Key, bool>{
 		{Game::Key::W, false},
 		{Game::Key::A, false},
@@ -269,6 +317,11 @@ int main()
 		}
 
 		scene.camera.Translate(WalkDirection(keyState, scene.camera));
+		scene.UpdateAccelerationStructure();
+		if (meshManager.GetFragmentation() > kDefragmentThreshold)
+		{
+			meshManager.Defragment(kDefragmentBytesPerFrame);
+		}
 
 		renderer.Render(scene);
 
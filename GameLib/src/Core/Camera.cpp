@@ -161,6 +161,11 @@ namespace Game {
 		return m_Data;
 	}
 
+	Frustum Camera::GetFrustum() const
+	{
+		return Frustum::FromMatrix(m_Data.projection * m_Data.view);
+	}
+
 	DataBufferView Camera::GetDataView() const
 	{
 		return { reinterpret_cast<const std::byte*>(&m_Data), sizeof(m_Data) };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Math/Frustum.h"
 #include "Math/Matrix4.h"
 #include "Math/Vector3.h"
 #include "Utils/DataBuffer.h"
@@ -47,6 +48,7 @@ namespace Game {
 		float GetNearPlane() const;
 		float GetFarPlane() const;
 		const CameraData& GetData() const;
+		Frustum GetFrustum() const;
 		DataBufferView GetDataView() const;
 
 	private:
@@ -11,7 +11,7 @@ namespace Game {
 	struct Entity
 	{
 		std::string name;
-		MeshView meshView;
+		MeshHandle mesh;
 		Transform transform;
 		uint32_t materialIndex;
 	};
@@ -0,0 +1,259 @@
+#include "Scene.h"
+
+#include "Math/RayPacket.h"
+#include "Math/SIMD.h"
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <utility>
+
+namespace {
+
+	constexpr auto kRaysPerTask = 256zu;
+
+	// @brief Calls trace(indices) for coherent groups of up to RayPacket::kSize rays, spread across worker threads
+	template<class F>
+	void ForEachPacket(std::span<const Game::Ray> rays, F&& trace)
+	{
+		const auto order = Game::CoherentOrder(rays);
+
+		auto tasks = std::vector<size_t>((order.size() + kRaysPerTask - 1zu) / kRaysPerTask);
+		std::iota(std::ranges::begin(tasks), std::ranges::end(tasks), 0zu);
+
+		std::for_each(std::execution::par, std::ranges::begin(tasks), std::ranges::end(tasks), [&](auto task)
+			{
+				const auto first = task * kRaysPerTask;
+				const auto taskOrder = std::span{ order }.subspan(first, std::min(kRaysPerTask, order.size() - first));
+
+				for (const auto indices : taskOrder | std::views::chunk(Game::RayPacket::kSize))
+				{
+					trace(std::span<const uint32_t>{ indices });
+				}
+			});
+	}
+
+	Game::RayPacket MakePacket(std::span<const Game::Ray> rays, std::span<const uint32_t> indices)
+	{
+		auto packet = Game::RayPacket{};
+		for (auto lane = 0u; lane < Game::RayPacket::kSize; ++lane)
+		{
+			packet.SetRay(lane, rays[indices[lane < indices.size() ? lane : 0u]]);
+		}
+
+		return packet;
+	}
+
+	void ExpectCurrentBVH(const Game::Scene& scene)
+	{
+		Game::Expect(
+			scene.entityBVHVersion == scene.entitiesVersion && scene.entityBVH.GetItemCount() == scene.entities.size(),
+			"Entity BVH is out of date, call UpdateAccelerationStructure");
+	}
+
+}
+
+namespace Game {
+
+	void Scene::SetTransform(uint32_t index, const Transform& transform)
+	{
+		Expect(index < entities.size(), "Entity {} is not part of the scene of {} entities", index, entities.size());
+
+		entities[index].transform = transform;
+		dirtyEntities.push_back(index);
+	}
+
+	uint32_t Scene::AddEntity(Entity entity)
+	{
+		entities.push_back(std::move(entity));
+		MarkEntitiesChanged();
+
+		return static_cast<uint32_t>(entities.size() - 1zu);
+	}
+
+	void Scene::MarkEntitiesChanged()
+	{
+		++entitiesVersion;
+	}
+
+	void Scene::UpdateAccelerationStructure()
+	{
+		// the count alone misses entities replaced or erased and appended in between
+		if (entityBVHVersion != entitiesVersion || entityBVH.GetItemCount() != entities.size())
+		{
+			const auto bounds = entities |
+				std::views::transform([this](const auto& entity) { return GetWorldBounds(entity); }) |
+				std::ranges::to<std::vector>();
+			entityBVH.Build(bounds);
+			entityBVHVersion = entitiesVersion;
+		}
+		else
+		{
+			for (const auto index : dirtyEntities)
+			{
+				entityBVH.Update(index, GetWorldBounds(entities[index]));
+			}
+
+			entityBVH.RebuildIfDegraded();
+		}
+
+		dirtyEntities.clear();
+	}
+
+	AABB Scene::GetWorldBounds(const Entity& entity) const
+	{
+		return meshManager.GetBVH(entity.mesh).GetBounds().Transform(mat4{ entity.transform });
+	}
+
+	std::optional<IntersectionResult> Scene::IntersectRay(const Ray& ray) const
+	{
+		ExpectCurrentBVH(*this);
+
+		auto result = std::optional<IntersectionResult>{};
+
+		entityBVH.Intersect(ray, std::numeric_limits<float>::max(), [&](auto index, auto closest)
+			{
+				const auto& entity = entities[index];
+				const auto hit = meshManager.GetBVH(entity.mesh).Intersect(ray, mat4{ entity.transform }, closest);
+				if (hit)
+				{
+					result = IntersectionResult{ .entity = &entity, .position = ray.origin + ray.direction * hit->distance, .distance = hit->distance };
+				}
+
+				return hit.transform([](const auto& h) { return h.distance; });
+			});
+
+		return result;
+	}
+
+	void Scene::IntersectRays(std::span<const Ray> rays, std::span<std::optional<IntersectionResult>> results) const
+	{
+		Expect(rays.size() == results.size(), "Ray count {} does not match result count {}", rays.size(), results.size());
+		ExpectCurrentBVH(*this);
+
+		const auto usePackets = SIMD::GetBackend() != SIMD::Backend::SCALAR;
+
+		ForEachPacket(rays, [&](std::span<const uint32_t> indices)
+			{
+				if (!usePackets)
+				{
+					for (const auto index : indices)
+					{
+						results[index] = IntersectRay(rays[index]);
+					}
+
+					return;
+				}
+
+				const auto packet = MakePacket(rays, indices);
+				auto closest = PacketDistances{};
+				closest.fill(std::numeric_limits<float>::max());
+				auto hitEntities = std::array<const Entity*, RayPacket::kSize>{};
+				auto activeMask = (1u << indices.size()) - 1u;
+
+				entityBVH.IntersectPacket(packet, closest, activeMask, [&](auto entityIndex, auto mask)
+					{
+						const auto& entity = entities[entityIndex];
+						const auto hits = meshManager.GetBVH(entity.mesh).IntersectPacket(packet, mat4{ entity.transform }, closest, mask);
+
+						for (auto lane = 0u; lane < RayPacket::kSize; ++lane)
+						{
+							if (hits & (1u << lane))
+							{
+								hitEntities[lane] = &entity;
+							}
+						}
+					});
+
+				for (const auto& [lane, index] : indices | std::views::enumerate)
+				{
+					const auto& ray = rays[index];
+					results[index] = hitEntities[lane]
+						? std::make_optional(IntersectionResult{ .entity = hitEntities[lane], .position = ray.origin + ray.direction * closest[lane], .distance = closest[lane] })
+						: std::nullopt;
+				}
+			});
+	}
+
+	bool Scene::Occluded(const Ray& ray, float maxDistance) const
+	{
+		ExpectCurrentBVH(*this);
+
+		auto occluded = false;
+
+		// reporting a hit at distance 0 ends the traversal
+		entityBVH.Intersect(ray, maxDistance, [&](auto index, auto closest)
+			{
+				const auto& entity = entities[index];
+				if (!meshManager.GetBVH(entity.mesh).Occluded(ray, mat4{ entity.transform }, closest))
+				{
+					return std::optional<float>{};
+				}
+
+				occluded = true;
+				return std::make_optional(0.0f);
+			});
+
+		return occluded;
+	}
+
+	void Scene::OccludedRays(std::span<const Ray> rays, std::span<const float> maxDistances, std::span<bool> occluded) const
+	{
+		Expect(rays.size() == maxDistances.size() && rays.size() == occluded.size(), "Ray count {} does not match distance count {} or result count {}", rays.size(), maxDistances.size(), occluded.size());
+		ExpectCurrentBVH(*this);
+
+		const auto usePackets = SIMD::GetBackend() != SIMD::Backend::SCALAR;
+
+		ForEachPacket(rays, [&](std::span<const uint32_t> indices)
+			{
+				if (!usePackets)
+				{
+					for (const auto index : indices)
+					{
+						occluded[index] = Occluded(rays[index], maxDistances[index]);
+					}
+
+					return;
+				}
+
+				const auto packet = MakePacket(rays, indices);
+				auto maxDistance = PacketDistances{};
+				for (const auto& [lane, index] : indices | std::views::enumerate)
+				{
+					maxDistance[lane] = maxDistances[index];
+				}
+
+				auto activeMask = (1u << indices.size()) - 1u;
+				auto occludedMask = 0u;
+
+				entityBVH.IntersectPacket(packet, maxDistance, activeMask, [&](auto entityIndex, auto mask)
+					{
+						const auto& entity = entities[entityIndex];
+						const auto hits = meshManager.GetBVH(entity.mesh).OccludedPacket(packet, mat4{ entity.transform }, maxDistance, mask);
+
+						occludedMask |= hits;
+						activeMask &= ~hits;
+					});
+
+				for (const auto& [lane, index] : indices | std::views::enumerate)
+				{
+					occluded[index] = (occludedMask & (1u << lane)) != 0u;
+				}
+			});
+	}
+
+	std::vector<const Entity*> Scene::Overlapping(const AABB& bounds) const
+	{
+		ExpectCurrentBVH(*this);
+
+		auto result = std::vector<const Entity*>{};
+		entityBVH.Query(bounds, [&](auto index) { result.push_back(&entities[index]); });
+
+		return result;
+	}
+
+}
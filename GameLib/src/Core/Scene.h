@@ -6,14 +6,16 @@
 #include "Graphics/MeshManager.h"
 #include "Graphics/MaterialManager.h"
 #include "Graphics/Texture.h"
-#include "Math/Utils.h"
+#include "Math/AABB.h"
+#include "Math/DynamicBVH.h"
 #include "Math/Ray.h"
-#include "Math/Vector4.h"
+#include "Math/Transform.h"
 
 #include "Graphics/PointLight.h"
 
+#include <cstdint>
 #include <optional>
-#include <ranges>
+#include <span>
 #include <vector>
 
 namespace Game {
@@ -22,50 +24,40 @@ namespace Game {
 	{
 		const Entity* entity;
 		vec3 position;
+		float distance;
 	};
 
 	struct LightData
 	{
 		Color ambient;
-		PointLight light;
+		std::vector<PointLight> pointLights;
 	};
 
 	struct Scene
 	{
-		constexpr std::optional<IntersectionResult> IntersectRay(const Ray& ray) const
-		{
-			auto result = std::optional<IntersectionResult>{};
-			auto minDistance = std::numeric_limits<float>::max();
+		// @brief Records a transform change, the entity BVH picks it up in the next UpdateAccelerationStructure
+		void SetTransform(uint32_t index, const Transform& transform);
 
-			for (const auto& entity : entities)
-			{
-				const auto invTransform = mat4::Invert(entity.transform);
-				const auto transformedRay = Ray{ invTransform * vec4{ray.origin, 1.0f}, invTransform * vec4{ray.direction, 0.0f} };
+		// @brief Appends an entity, the entity BVH is rebuilt in the next UpdateAccelerationStructure
+		uint32_t AddEntity(Entity entity);
+		// @brief Call after adding, erasing or replacing entities directly, their indices no longer match the entity BVH
+		void MarkEntitiesChanged();
 
-				const auto indices = meshManager.GetIndexData(entity.meshView);
-				const auto vertices = meshManager.GetVertexData(entity.meshView);
+		// @brief Refits the entity BVH for entities moved since the last call, or rebuilds it when entities changed
+		void UpdateAccelerationStructure();
 
-				for (const auto& indices : std::views::chunk(indices, 3))
-				{
-					const auto v0 = vertices[indices[0]].position;
-					const auto v1 = vertices[indices[1]].position;
-					const auto v2 = vertices[indices[2]].position;
+		AABB GetWorldBounds(const Entity& entity) const;
+		std::optional<IntersectionResult> IntersectRay(const Ray& ray) const;
 
-					if (const auto distance = Intersect(transformedRay, v0, v1, v2); distance)
-					{
-						const auto intersectionPoint = transformedRay.origin + transformedRay.direction * (*distance);
+		// @brief Closest hits for a batch of rays, results[i] belongs to rays[i]. Rays are sorted for coherence,
+		// traced in packets of four and large batches are split across worker threads.
+		void IntersectRays(std::span<const Ray> rays, std::span<std::optional<IntersectionResult>> results) const;
 
-						if (*distance < minDistance)
-						{
-							result = IntersectionResult{ .entity = &entity, .position = intersectionPoint };
-							minDistance = *distance;
-						}
-					}
-				}
-			}
+		// @brief Any-hit queries for line of sight and occlusion, true when something lies closer than maxDistance
+		bool Occluded(const Ray& ray, float maxDistance) const;
+		void OccludedRays(std::span<const Ray> rays, std::span<const float> maxDistances, std::span<bool> occluded) const;
 
-			return result;
-		}
+		std::vector<const Entity*> Overlapping(const AABB& bounds) const;
 
 		std::vector<Entity> entities;
 		MeshManager& meshManager;
@@ -73,6 +65,10 @@ namespace Game {
 		TextureManager& textureManager;
 		Camera camera;
 		LightData lights;
+		DynamicBVH entityBVH = {};
+		std::vector<uint32_t> dirtyEntities = {};
+		uint64_t entitiesVersion = 1u;	// bumped by every change to which entity has which index
+		uint64_t entityBVHVersion = 0u;	// of the entities the entity BVH was built for
 	};
 
 }
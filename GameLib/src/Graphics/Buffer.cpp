@@ -1,13 +1,17 @@
 #include "Buffer.h"
 
+#include "GPUMemory.h"
 #include "Utils/Error.h"
 
+#include <algorithm>
+
 namespace Game {
 
 	Buffer::Buffer(size_t size, std::string_view name)
 		: m_Buffer{ 0u, [](auto buffer) { glDeleteBuffers(1, &buffer); } }
 		, m_Size{ size }
 		, m_Name{ name }
+		, m_MemoryRegistration{ GPUMemory::Register(GPUMemoryCategory::BUFFER, name, size) }
 	{
 		glCreateBuffers(1, &m_Buffer);
 		glNamedBufferStorage(m_Buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT);
@@ -20,6 +24,18 @@ namespace Game {
 		glNamedBufferSubData(m_Buffer, offset, data.size(), data.data());
 	}
 
+	void Buffer::Copy(size_t readOffset, size_t writeOffset, size_t size) const
+	{
+		Expect(m_Size >= readOffset + size && m_Size >= writeOffset + size, "Buffer is too small");
+		Expect(readOffset + size <= writeOffset || writeOffset + size <= readOffset, "Copy ranges overlap");
+		glCopyNamedBufferSubData(m_Buffer, m_Buffer, readOffset, writeOffset, size);
+	}
+
+	void Buffer::CopyTo(const Buffer& destination) const
+	{
+		glCopyNamedBufferSubData(m_Buffer, destination.m_Buffer, 0, 0, std::min(m_Size, destination.m_Size));
+	}
+
 	GLuint Buffer::GetNativeHandle() const
 	{
 		return m_Buffer;
@@ -4,6 +4,8 @@
 #include "Utils/DataBuffer.h"
 #include "OpenGL.h"
 
+#include <cstdint>
+
 #include <string>
 #include <string_view>
 
@@ -16,6 +18,12 @@ namespace Game {
 
 		void Write(DataBufferView data, size_t offset) const;
 
+		// @brief GPU side copy between two non-overlapping ranges of this buffer
+		void Copy(size_t readOffset, size_t writeOffset, size_t size) const;
+
+		// @brief GPU side copy of the start of this buffer into another, as much as fits in the smaller of the two
+		void CopyTo(const Buffer& destination) const;
+
 		GLuint GetNativeHandle() const;
 
 		size_t GetSize() const;
@@ -26,6 +34,7 @@ namespace Game {
 		AutoRelease<GLuint> m_Buffer;
 		size_t m_Size;
 		std::string m_Name;
+		AutoRelease<uint64_t> m_MemoryRegistration;
 	};
 
 }
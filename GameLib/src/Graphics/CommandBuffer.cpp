@@ -3,69 +3,144 @@
 #include "Utils.h"
 #include "Utils/Log.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <ranges>
+#include <span>
 #include <format>
 
 namespace {
 
-	struct IndirectCommand
+	Game::IndirectCommand CreateCommand(const Game::MeshView& meshView, uint32_t baseInstance, uint32_t instanceCount)
 	{
-		uint32_t count;
-		uint32_t instanceCount;
-		uint32_t first;
-		int32_t baseVertex;
-		uint32_t baseInstance;
-	};
+		return {
+			.count = meshView.indexCount,
+			.instanceCount = instanceCount,
+			.first = meshView.indexOffset,
+			.baseVertex = static_cast<int32_t>(meshView.vertexOffset),
+			.baseInstance = baseInstance
+		};
+	}
 
 }
 
 namespace Game {
 
+	std::string CommandBufferStats::to_string() const
+	{
+		return std::format("{} of {} commands written in {} writes, {} visible and {} culled entities", commandsWritten, commandCount, writeCount, visibleEntities, culledEntities);
+	}
+
 	CommandBuffer::CommandBuffer(std::string_view name)
 		: m_CommandBuffer{ 1u, name }
+		, m_Commands{}
+		, m_ChangedAt{}
+		, m_SlotBuiltAt{}
+		, m_Layout{}
+		, m_Result{}
+		, m_Transforms{}
+		, m_BuildIndex{}
+		, m_Stats{}
 	{}
 
-	uint32_t CommandBuffer::Build(const Scene& scene)
+	std::vector<DrawBatch> CommandBuffer::Build(const Scene& scene)
 	{
-		const auto command = scene.entities | std::views::transform(
-			[](const auto& e)
+		++m_BuildIndex;
+
+		BuildCullLayout(scene.entities, [&](auto handle) { return scene.meshManager.GetView(handle); }, m_Layout);
+
+		m_Transforms.resize(scene.entities.size());
+		std::ranges::transform(scene.entities, std::ranges::begin(m_Transforms), [](const auto& entity) { return mat4{ entity.transform }; });
+
+		Cull(m_Layout, scene.camera.GetFrustum(), m_Transforms, m_Result);
+
+		// the layout only changes when entities are added, removed or switch meshes and commands only when visibility changes too,
+		// so comparing against the retained list finds the few commands that need writing
+		const auto commandCount = m_Result.commands.size();
+		m_Commands.resize(commandCount);
+		m_ChangedAt.resize(commandCount, m_BuildIndex);
+		for (const auto [command, retained, changedAt] : std::views::zip(m_Result.commands, m_Commands, m_ChangedAt))
+		{
+			if (retained != command)
+			{
+				retained = command;
+				changedAt = m_BuildIndex;
+			}
+		}
+
+		auto batches = std::vector<DrawBatch>{};
+		for (const auto [batch, drawCount] : std::views::zip(m_Layout.batches, m_Result.drawCounts))
+		{
+			if (drawCount > 0u)
 			{
-				const auto cmd = IndirectCommand{
-					.count = e.meshView.indexCount,
-					.instanceCount = 1u,
-					.first = e.meshView.indexOffset,
-					.baseVertex = static_cast<int32_t>(e.meshView.vertexOffset),
-					.baseInstance = 0u
-				};
-				return cmd;
-			}) | std::ranges::to<std::vector>();
+				batches.push_back({
+					.indexType = batch.indexType,
+					.commandCount = drawCount,
+					.offsetBytes = batch.firstTemplate * sizeof(IndirectCommand)
+				});
+			}
+		}
+
+		const auto visibleEntities = std::ranges::fold_left(
+			m_Result.commands | std::views::transform([](const auto& command) { return command.instanceCount; }),
+			0u,
+			std::plus{});
+
+		if (ResizeGPUBuffer(m_Commands, m_CommandBuffer))
+		{
+			// a new buffer holds nothing, every slot has to be written in full
+			m_SlotBuiltAt.fill(0u);
+		}
+
+		const auto slot = m_CommandBuffer.FrameIndex();
+		const auto changedSinceSlot = [builtAt = m_SlotBuiltAt[slot]](auto changedAt) { return changedAt > builtAt; };
+
+		m_Stats = {
+			.commandsWritten = 0u,
+			.commandCount = static_cast<uint32_t>(commandCount),
+			.writeCount = 0u,
+			.visibleEntities = visibleEntities,
+			.culledEntities = static_cast<uint32_t>(scene.entities.size()) - visibleEntities
+		};
+
+		const auto mapped = m_CommandBuffer.MapFrame<IndirectCommand>(commandCount);
+		const auto end = std::ranges::end(m_ChangedAt);
+		for (auto run = std::ranges::find_if(m_ChangedAt, changedSinceSlot); run != end; )
+		{
+			const auto runEnd = std::find_if_not(run, end, changedSinceSlot);
+			const auto offset = static_cast<size_t>(run - std::ranges::begin(m_ChangedAt));
+			const auto count = static_cast<size_t>(runEnd - run);
 
-		const auto commandView = DataBufferView{ reinterpret_cast<const std::byte*>(command.data()), command.size() * sizeof(IndirectCommand) };
+			std::ranges::copy(std::span{ m_Commands }.subspan(offset, count), std::ranges::begin(mapped) + offset);
+			m_Stats.commandsWritten += static_cast<uint32_t>(count);
+			++m_Stats.writeCount;
 
-		ResizeGPUBuffer(command, m_CommandBuffer);
+			run = std::find_if(runEnd, end, changedSinceSlot);
+		}
 
-		m_CommandBuffer.Write(commandView, 0u);
+		m_SlotBuiltAt[slot] = m_BuildIndex;
 
-		return command.size();
+		return batches;
 	}
 
-	uint32_t CommandBuffer::Build(const Entity& entity)
+	DrawBatch CommandBuffer::Build(const Entity& entity, const MeshManager& meshManager)
 	{
-		const auto cmd = IndirectCommand{
-			.count = entity.meshView.indexCount,
-			.instanceCount = 1u,
-			.first = entity.meshView.indexOffset,
-			.baseVertex = 0u,
-			.baseInstance = 0u
-		};
-		const auto commandView = std::as_bytes(std::span{&cmd, 1});
+		const auto meshView = meshManager.GetView(entity.mesh);
 
-		ResizeGPUBuffer(std::vector<IndirectCommand>{ cmd }, m_CommandBuffer);
+		ResizeGPUBuffer<IndirectCommand>(1zu, m_CommandBuffer);
 
-		m_CommandBuffer.Write(commandView, 0u);
+		m_CommandBuffer.MapFrame<IndirectCommand>(1zu).front() = CreateCommand(meshView, 0u, 1u);
+		m_Stats = { .commandsWritten = 1u, .commandCount = 1u, .writeCount = 1u, .visibleEntities = 1u, .culledEntities = 0u };
 
-		return 1u;
+		return { .indexType = meshView.indexType, .commandCount = 1u, .offsetBytes = 0zu };
+	}
+
+	void CommandBuffer::Reserve(size_t commandCount)
+	{
+		if (ResizeGPUBuffer<IndirectCommand>(commandCount, m_CommandBuffer))
+		{
+			m_SlotBuiltAt.fill(0u);
+		}
 	}
 
 	void CommandBuffer::Advance()
@@ -88,9 +163,24 @@ namespace Game {
 		return m_CommandBuffer.GetName();
 	}
 
+	std::span<const uint32_t> CommandBuffer::GetInstances() const
+	{
+		return m_Result.instances;
+	}
+
+	CommandBufferStats CommandBuffer::GetStats() const
+	{
+		return m_Stats;
+	}
+
+	std::chrono::nanoseconds CommandBuffer::GetFenceWaitTime() const
+	{
+		return m_CommandBuffer.GetFenceWaitTime();
+	}
+
 	std::string CommandBuffer::to_string() const
 	{
-		return std::format("Command buffer {} size", m_CommandBuffer.GetSize());
+		return std::format("Command buffer {} size, {}", m_CommandBuffer.GetSize(), m_Stats);
 	}
 
 }
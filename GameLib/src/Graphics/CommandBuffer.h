@@ -1,31 +1,73 @@
 #pragma once
 
 #include "Core/Scene.h"
+#include "Culling.h"
 #include "MultiBuffer.h"
 #include "PersistentBuffer.h"
 #include "OpenGL.h"
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace Game {
 
+	struct CommandBufferStats
+	{
+		uint32_t commandsWritten;	// into the current frame slot during the last Build
+		uint32_t commandCount;
+		uint32_t writeCount;		// separate writes the changed commands were merged into
+		uint32_t visibleEntities;
+		uint32_t culledEntities;
+
+		std::string to_string() const;
+	};
+
+	// @brief Consecutive commands drawn with one multi draw call, all indexing the same index pool
+	struct DrawBatch
+	{
+		IndexType indexType;
+		uint32_t commandCount;
+		size_t offsetBytes;	// relative to OffsetBytes()
+	};
+
 	class CommandBuffer
 	{
 	public:
 		CommandBuffer(std::string_view name);
 
-		uint32_t Build(const Scene& scene);
-		uint32_t Build(const Entity& entity);
+		// @brief Culls on the CPU with the reference implementation of the GPU cull pass and updates the retained command list,
+		// one instanced command per mesh with visible instances grouped by index type.
+		// Only commands that changed since the current frame slot was last built are written to it, a static scene writes nothing.
+		std::vector<DrawBatch> Build(const Scene& scene);
+		DrawBatch Build(const Entity& entity, const MeshManager& meshManager);
+		// @brief Grows the buffer up front so building up to commandCount commands never has to
+		void Reserve(size_t commandCount);
 		void Advance();
 		size_t OffsetBytes() const;
 
+		// @brief Entity index per instance slot of the last Build, instance i of a command draws the entity in slot baseInstance + i
+		std::span<const uint32_t> GetInstances() const;
+
 		GLuint GetNativeHandle() const;
 		std::string_view GetName() const;
+		CommandBufferStats GetStats() const;
+		std::chrono::nanoseconds GetFenceWaitTime() const;
 		std::string to_string() const;
 
 	private:
 		MultiBuffer<PersistentBuffer> m_CommandBuffer;
+		std::vector<IndirectCommand> m_Commands;
+		std::vector<uint64_t> m_ChangedAt;	// build in which each command last changed
+		std::array<uint64_t, MultiBuffer<PersistentBuffer>::FrameCount()> m_SlotBuiltAt;
+		CullLayout m_Layout;
+		CullResult m_Result;
+		std::vector<mat4> m_Transforms;
+		uint64_t m_BuildIndex;
+		CommandBufferStats m_Stats;
 	};
 
 }
@@ -0,0 +1,126 @@
+#include "Culling.h"
+
+#include "Math/AABB.h"
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <ranges>
+
+namespace Game {
+
+	void BuildCullLayout(std::span<const Entity> entities, const std::function<MeshView(MeshHandle)>& getView, CullLayout& layout)
+	{
+		layout.templates.clear();
+		layout.instances.clear();
+		layout.batches.clear();
+
+		const auto meshCount = std::ranges::fold_left(
+			entities | std::views::transform([](const auto& entity) { return entity.mesh.index + 1u; }),
+			0u,
+			[](auto a, auto b) { return std::max(a, b); });
+
+		auto instanceCounts = std::vector<uint32_t>(meshCount, 0u);
+		auto handles = std::vector<MeshHandle>(meshCount);
+		for (const auto& entity : entities)
+		{
+			const auto mesh = entity.mesh.index;
+			Expect(instanceCounts[mesh] == 0u || handles[mesh] == entity.mesh, "Entities use generations {} and {} of mesh {}", handles[mesh].generation, entity.mesh.generation, mesh);
+			handles[mesh] = entity.mesh;
+			++instanceCounts[mesh];
+		}
+
+		auto views = std::vector<MeshView>(meshCount);
+		for (const auto [mesh, instanceCount] : instanceCounts | std::views::enumerate)
+		{
+			if (instanceCount > 0u)
+			{
+				views[mesh] = getView(handles[mesh]);
+			}
+		}
+
+		auto templateOf = std::vector<uint32_t>(meshCount);
+		auto nextSlot = std::vector<uint32_t>(meshCount);
+		auto slot = 0u;
+
+		for (const auto indexType : { IndexType::UINT16, IndexType::UINT32 })
+		{
+			const auto firstTemplate = static_cast<uint32_t>(layout.templates.size());
+			for (const auto [mesh, instanceCount] : instanceCounts | std::views::enumerate)
+			{
+				const auto& view = views[mesh];
+				if (instanceCount == 0u || view.indexType != indexType)
+				{
+					continue;
+				}
+
+				templateOf[mesh] = static_cast<uint32_t>(layout.templates.size());
+				nextSlot[mesh] = slot;
+				layout.templates.push_back({
+					.count = view.indexCount,
+					.instanceCount = instanceCount,
+					.first = view.indexOffset,
+					.baseVertex = static_cast<int32_t>(view.vertexOffset),
+					.baseInstance = slot
+				});
+				slot += instanceCount;
+			}
+
+			if (const auto templateCount = static_cast<uint32_t>(layout.templates.size()) - firstTemplate; templateCount > 0u)
+			{
+				layout.batches.push_back({ .indexType = indexType, .firstTemplate = firstTemplate, .templateCount = templateCount });
+			}
+		}
+
+		layout.instances.resize(entities.size());
+		for (const auto& [index, entity] : entities | std::views::enumerate)
+		{
+			const auto mesh = entity.mesh.index;
+			const auto& bounds = views[mesh].bounds;
+			layout.instances[nextSlot[mesh]++] = {
+				.boundsMin = bounds.min,
+				.templateIndex = templateOf[mesh],
+				.boundsMax = bounds.max,
+				.entityIndex = static_cast<uint32_t>(index)
+			};
+		}
+	}
+
+	void Cull(const CullLayout& layout, const Frustum& frustum, std::span<const mat4> transforms, CullResult& result)
+	{
+		result.commands.assign(layout.templates.size(), IndirectCommand{});
+		result.drawCounts.assign(layout.batches.size(), 0u);
+		result.instances.resize(layout.instances.size());
+
+		// cull.comp, one invocation per instance appending visible ones to their template's instance range
+		auto visibleCounts = std::vector<uint32_t>(layout.templates.size(), 0u);
+		for (const auto& instance : layout.instances)
+		{
+			if (frustum.Intersects(AABB{ instance.boundsMin, instance.boundsMax }, transforms[instance.entityIndex]))
+			{
+				const auto slot = layout.templates[instance.templateIndex].baseInstance + visibleCounts[instance.templateIndex]++;
+				result.instances[slot] = instance.entityIndex;
+			}
+		}
+
+		// cull_compact.comp, templates with visible instances move to the front of their batch in template order
+		for (const auto& [batchIndex, batch] : layout.batches | std::views::enumerate)
+		{
+			auto written = 0u;
+			for (auto index = batch.firstTemplate; index < batch.firstTemplate + batch.templateCount; ++index)
+			{
+				if (visibleCounts[index] == 0u)
+				{
+					continue;
+				}
+
+				auto command = layout.templates[index];
+				command.instanceCount = visibleCounts[index];
+				result.commands[batch.firstTemplate + written] = command;
+				++written;
+			}
+
+			result.drawCounts[batchIndex] = written;
+		}
+	}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Core/Entity.h"
+#include "MeshView.h"
+#include "Math/Frustum.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Game {
+
+	// @brief Layout consumed by glMultiDrawElementsIndirect
+	struct IndirectCommand
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t first;
+		int32_t baseVertex;
+		uint32_t baseInstance;
+
+		constexpr bool operator==(const IndirectCommand&) const = default;
+	};
+
+	// @brief Per instance input of the cull pass, std430 layout mirrored in cull.comp
+	struct CullInstance
+	{
+		vec3 boundsMin;
+		uint32_t templateIndex;
+		vec3 boundsMax;
+		uint32_t entityIndex;
+	};
+
+	static_assert(sizeof(CullInstance) == 32zu);
+
+	// @brief Range of templates drawn with one multi draw call
+	struct CullBatch
+	{
+		IndexType indexType;
+		uint32_t firstTemplate;
+		uint32_t templateCount;
+	};
+
+	// @brief Everything culling needs that does not depend on the camera. There is one template per mesh, its instanceCount
+	// counting every entity using the mesh and baseInstance pointing at its first instance slot. Templates are ordered by index
+	// type then mesh handle and instances are grouped by template in entity order.
+	struct CullLayout
+	{
+		std::vector<IndirectCommand> templates;
+		std::vector<CullInstance> instances;
+		std::vector<CullBatch> batches;
+	};
+
+	struct CullResult
+	{
+		// one entry per template, the visible commands of each batch compacted to the front of its range and the rest zeroed
+		std::vector<IndirectCommand> commands;
+		std::vector<uint32_t> drawCounts;	// per batch
+		// entity index per instance slot, only the first instanceCount slots from each command's baseInstance are meaningful
+		std::vector<uint32_t> instances;
+	};
+
+	void BuildCullLayout(std::span<const Entity> entities, const std::function<MeshView(MeshHandle)>& getView, CullLayout& layout);
+
+	// @brief CPU reference of cull.comp and cull_compact.comp. For the same visibility the command stream and draw counts are
+	// byte-identical to what the GPU writes, only the order of instances within a command may differ as the GPU appends them atomically.
+	void Cull(const CullLayout& layout, const Frustum& frustum, std::span<const mat4> transforms, CullResult& result);
+
+}
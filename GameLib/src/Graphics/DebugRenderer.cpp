@@ -1,12 +1,15 @@
 #include "DebugRenderer.h"
 
+#include "GPUMemory.h"
 #include "Math/Ray.h"
 #include "Math/Matrix4.h"
 #include "Math/Vector4.h"
 #include "Utils/Log.h"
 
+#include <chrono>
 #include <string>
 #include <format>
+#include <ranges>
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <imgui.h>
@@ -39,10 +42,12 @@ namespace {
 namespace Game {
 
 	DebugRenderer::DebugRenderer(const Window& window, ResourceLoader& resourceLoader, TextureManager& textureManager, MeshManager& meshManager)
-		: Renderer{ window, resourceLoader, textureManager, meshManager }
+		: Renderer{ window.GetRenderWidth(), window.GetRenderHeight(), resourceLoader, textureManager, meshManager }
+		, m_Window{ window }
 		, m_Enabled{ false }
 		, m_Click{}
 		, m_SelectedEntity{}
+		, m_SelectedLight{}
 	{
 		IMGUI_CHECKVERSION();
 		ImGui::CreateContext();
@@ -90,8 +95,26 @@ namespace Game {
 		ImGui::Begin("Scene");
 
 		ImGui::LabelText("FPS", "%0.1f", io.Framerate);
+		ImGui::LabelText("fence wait", "%0.3f ms", std::chrono::duration<double, std::milli>(GetFenceWaitTime()).count());
+		ImGui::LabelText("transient buffer", "%s", m_TransientAllocator.GetStats().to_string().c_str());
+		ImGui::LabelText("vertex pool", "%s", scene.meshManager.GetVertexPoolStats().to_string().c_str());
+		ImGui::LabelText("16 bit index pool", "%s", scene.meshManager.GetIndexPoolStats(IndexType::UINT16).to_string().c_str());
+		ImGui::LabelText("32 bit index pool", "%s", scene.meshManager.GetIndexPoolStats(IndexType::UINT32).to_string().c_str());
+		auto gpuCulling = m_CullingMode == CullingMode::GPU;
+		if (ImGui::Checkbox("GPU culling", &gpuCulling))
+		{
+			SetCullingMode(gpuCulling ? CullingMode::GPU : CullingMode::CPU);
+		}
+		if (m_CullingMode == CullingMode::GPU)
+		{
+			ImGui::LabelText("draw commands", "%s", m_GPUCuller.to_string().c_str());
+		}
+		else
+		{
+			ImGui::LabelText("draw commands", "%s", m_CommandBuffer.GetStats().to_string().c_str());
+		}
 
-		for (auto& entity : scene.entities)
+		for (const auto& [index, entity] : scene.entities | std::views::enumerate)
 		{
 			ImGui::CollapsingHeader(entity.name.c_str());
 
@@ -100,7 +123,7 @@ namespace Game {
 				auto transform = mat4{ entity.transform };
 				const auto& cameraData = scene.camera.GetData();
 
-				ImGuizmo::Manipulate(
+				const auto manipulated = ImGuizmo::Manipulate(
 					cameraData.view.Data().data(),
 					cameraData.projection.Data().data(),
 					ImGuizmo::TRANSLATE | ImGuizmo::SCALE | ImGuizmo::BOUNDS | ImGuizmo::ROTATE,
@@ -111,7 +134,10 @@ namespace Game {
 					nullptr,
 					nullptr);
 
-				entity.transform = Transform{ transform };
+				if (manipulated)
+				{
+					scene.SetTransform(static_cast<uint32_t>(index), Transform{ transform });
+				}
 			}
 		}
 
@@ -125,48 +151,79 @@ namespace Game {
 				std::memcpy(&scene.lights.ambient, ambColor, sizeof(ambColor));
 			}
 
-			float pos[] = { scene.lights.light.position.x, scene.lights.light.position.y, scene.lights.light.position.z };
-			if (ImGui::SliderFloat3("position", pos, -100.0f, 100.0f))
+			auto gpuClusters = m_ClusterAssignment == ClusterAssignment::GPU;
+			if (ImGui::Checkbox("GPU light clusters", &gpuClusters))
 			{
-				scene.lights.light.position = { pos[0], pos[1], pos[2] };
+				SetClusterAssignment(gpuClusters ? ClusterAssignment::GPU : ClusterAssignment::CPU);
 			}
-
-			float color[3]{};
-			std::memcpy(color, &scene.lights.light.color, sizeof(color));
-
-			if (ImGui::ColorPicker3("light color", color))
+			if (m_ClusterAssignment == ClusterAssignment::CPU)
 			{
-				std::memcpy(&scene.lights.light.color, color, sizeof(color));
+				ImGui::LabelText("light clusters", "%s", m_ClusterStats.to_string().c_str());
 			}
 
-			ImGui::SliderFloat("power", &scene.lights.light.specularPower, 0.0f, 100.0f);
-
-			float atten[] = { scene.lights.light.constantAttenuation, scene.lights.light.linearAttenuation, scene.lights.light.quadraticAttenuation };
-			if (ImGui::SliderFloat3("attenuation", atten, 0.0f, 2.0f))
+			auto& pointLights = scene.lights.pointLights;
+			if (ImGui::Button("add light"))
 			{
-				scene.lights.light.constantAttenuation = atten[0];
-				scene.lights.light.linearAttenuation = atten[1];
-				scene.lights.light.quadraticAttenuation = atten[2];
+				pointLights.push_back(pointLights.empty() ?
+					PointLight{ .position = {}, .color = Colors::White, .constantAttenuation = 1.0f, .linearAttenuation = 0.007f, .quadraticAttenuation = 0.0002f, .specularPower = 32.0f } :
+					pointLights.back());
+				m_SelectedLight = pointLights.size() - 1zu;
 			}
 
-			if (!m_SelectedEntity)
+			if (!pointLights.empty())
 			{
-				auto transform = mat4{ scene.lights.light.position };
-				const auto& cameraData = scene.camera.GetData();
-
-				ImGuizmo::Manipulate(
-					cameraData.view.Data().data(),
-					cameraData.projection.Data().data(),
-					ImGuizmo::TRANSLATE | ImGuizmo::SCALE | ImGuizmo::BOUNDS | ImGuizmo::ROTATE,
-					ImGuizmo::WORLD,
-					const_cast<float*>(transform.Data().data()),
-					nullptr,
-					nullptr,
-					nullptr,
-					nullptr);
-
-				const auto newTransform = Transform{ transform };
-				scene.lights.light.position = newTransform.Position;
+				m_SelectedLight = std::min(m_SelectedLight, pointLights.size() - 1zu);
+				auto selected = static_cast<int>(m_SelectedLight);
+				if (ImGui::SliderInt("light", &selected, 0, static_cast<int>(pointLights.size()) - 1))
+				{
+					m_SelectedLight = static_cast<size_t>(selected);
+				}
+
+				auto& light = pointLights[m_SelectedLight];
+
+				float pos[] = { light.position.x, light.position.y, light.position.z };
+				if (ImGui::SliderFloat3("position", pos, -100.0f, 100.0f))
+				{
+					light.position = { pos[0], pos[1], pos[2] };
+				}
+
+				float color[3]{};
+				std::memcpy(color, &light.color, sizeof(color));
+
+				if (ImGui::ColorPicker3("light color", color))
+				{
+					std::memcpy(&light.color, color, sizeof(color));
+				}
+
+				ImGui::SliderFloat("power", &light.specularPower, 0.0f, 100.0f);
+
+				float atten[] = { light.constantAttenuation, light.linearAttenuation, light.quadraticAttenuation };
+				if (ImGui::SliderFloat3("attenuation", atten, 0.0f, 2.0f))
+				{
+					light.constantAttenuation = atten[0];
+					light.linearAttenuation = atten[1];
+					light.quadraticAttenuation = atten[2];
+				}
+
+				if (!m_SelectedEntity)
+				{
+					auto transform = mat4{ light.position };
+					const auto& cameraData = scene.camera.GetData();
+
+					const auto manipulated = ImGuizmo::Manipulate(
+						cameraData.view.Data().data(),
+						cameraData.projection.Data().data(),
+						ImGuizmo::TRANSLATE | ImGuizmo::SCALE | ImGuizmo::BOUNDS | ImGuizmo::ROTATE,
+						ImGuizmo::WORLD,
+						const_cast<float*>(transform.Data().data()),
+						nullptr,
+						nullptr,
+						nullptr,
+						nullptr);
+
+					const auto newTransform = Transform{ transform };
+					light.position = newTransform.Position;
+				}
 			}
 		}
 
@@ -191,19 +248,105 @@ namespace Game {
 
 		ImGui::Begin("RenderTargets");
 		const auto aspectRatio = static_cast<float>(m_Window.GetRenderWidth()) / static_cast<float>(m_Window.GetRenderHeight());
-		for (auto i = 0u; i < m_GBufferRT.colorAttachmentCount; ++i)
+		for (const auto resource : m_GBufferTextures)
 		{
-			const auto tex = scene.textureManager.GetTexture(m_GBufferRT.firstColorAttachmentIndex + i);
+			const auto tex = scene.textureManager.GetTexture(m_RenderGraph.GetTextureIndex(resource));
 			ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(tex->GetNativeHandle())), ImVec2(200.0f * aspectRatio, 200.0f), ImVec2(0.0f, 1.0f), ImVec2(1.0f, 0.0f));
 			ImGui::SameLine();
 		}
 		ImGui::End();
 
+		ImGui::Begin("Render graph");
+		const auto& compiled = m_RenderGraph.GetCompiled();
+		const auto passes = m_RenderGraph.GetPasses();
+		ImGui::Text("%zu of %zu passes, %zu physical textures", compiled.passes.size(), passes.size(), compiled.physicalDescs.size());
+		for (const auto& [pass, barriers] : compiled.passes)
+		{
+			ImGui::Text("%s, barriers 0x%x", passes[pass].name.c_str(), barriers);
+		}
+		for (const auto [resource, desc] : m_RenderGraph.GetResources() | std::views::enumerate)
+		{
+			const auto& lifetime = compiled.lifetimes[resource];
+			const auto& physical = compiled.physicalTextures[resource];
+			if (lifetime && physical)
+			{
+				ImGui::Text("%s: passes %u to %u, texture %u", desc.name.c_str(), lifetime->first, lifetime->last, *physical);
+			}
+			else if (lifetime)
+			{
+				ImGui::Text("%s: passes %u to %u", desc.name.c_str(), lifetime->first, lifetime->last);
+			}
+		}
+		ImGui::End();
+
+		ImGui::Begin("Profiler");
+		const auto frameHistory = m_Profiler.GetGPUHistory("frame");
+		ImGui::PlotLines("frame GPU ms", frameHistory.data(), static_cast<int>(frameHistory.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+		ImGui::Text("%zu dropped frames", m_Profiler.GetDroppedFrames());
+		ImGui::Text("render scale %.2f", GetRenderScale());
+		if (ImGui::BeginTable("zones", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("zone");
+			ImGui::TableSetupColumn("GPU avg ms");
+			ImGui::TableSetupColumn("GPU p99 ms");
+			ImGui::TableSetupColumn("CPU avg ms");
+			ImGui::TableSetupColumn("CPU p99 ms");
+			ImGui::TableHeadersRow();
+			for (const auto& zone : m_Profiler.GetZones())
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%*s%s", static_cast<int>(zone.depth * 2u), "", zone.name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.gpu.avg);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.gpu.p99);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.cpu.avg);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", zone.cpu.p99);
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+
+		ImGui::Begin("GPU memory");
+		const auto memoryStats = GPUMemory::GetStats();
+		ImGui::LabelText("total", "%s", memoryStats.to_string().c_str());
+		for (const auto [category, bytes] : memoryStats.categoryBytes | std::views::enumerate)
+		{
+			ImGui::LabelText(to_string(static_cast<GPUMemoryCategory>(category)).c_str(), "%0.2f MiB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+		}
+		if (ImGui::BeginTable("allocations", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn("name");
+			ImGui::TableSetupColumn("category");
+			ImGui::TableSetupColumn("count");
+			ImGui::TableSetupColumn("KiB");
+			ImGui::TableHeadersRow();
+			for (const auto& usage : GPUMemory::GetUsage())
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(usage.name.c_str());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(to_string(usage.category).c_str());
+				ImGui::TableNextColumn();
+				ImGui::Text("%zu", usage.count);
+				ImGui::TableNextColumn();
+				ImGui::Text("%zu", usage.bytes >> 10zu);
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 		if (m_Click)
 		{
+			scene.UpdateAccelerationStructure();
+
 			const auto pickRay = ScreenRay(*m_Click, m_Window, scene.camera);
 			const auto intersection = scene.IntersectRay(pickRay);
 			m_SelectedEntity = intersection.transform([](const auto& e) { return e.entity; }).value_or(nullptr);
@@ -26,9 +26,11 @@ namespace Game {
 		void PostRender(Scene& scene) override;
 
 	private:
+		const Window& m_Window;
 		bool m_Enabled;
 		std::optional<MouseButtonEvent> m_Click;
 		const Entity* m_SelectedEntity;
+		size_t m_SelectedLight;
 	};
 
 }
@@ -0,0 +1,65 @@
+#include "DeferredDeletion.h"
+
+#include "Utils/AutoRelease.h"
+#include "OpenGL.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	struct RetiredFrame
+	{
+		Game::AutoRelease<GLsync> fence;
+		std::vector<std::shared_ptr<void>> resources;
+	};
+
+	auto g_Retired = std::vector<std::shared_ptr<void>>{};
+	auto g_Pending = std::deque<RetiredFrame>{};
+
+}
+
+namespace Game::DeferredDeletion {
+
+	void Retire(std::shared_ptr<void> resource)
+	{
+		g_Retired.push_back(std::move(resource));
+	}
+
+	void EndFrame()
+	{
+		if (!g_Retired.empty())
+		{
+			g_Pending.push_back({
+				.fence = { glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u), glDeleteSync },
+				.resources = std::exchange(g_Retired, {})
+			});
+		}
+
+		// fences signal in submission order so the oldest frame is the only one worth polling
+		while (!g_Pending.empty())
+		{
+			const auto result = glClientWaitSync(g_Pending.front().fence, 0u, 0u);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+			{
+				break;
+			}
+
+			g_Pending.pop_front();
+		}
+	}
+
+	void ReleaseAll()
+	{
+		g_Retired.clear();
+		g_Pending.clear();
+	}
+
+	size_t PendingCount()
+	{
+		return std::ranges::fold_left(g_Pending, g_Retired.size(), [](auto count, const auto& frame) { return count + frame.resources.size(); });
+	}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace Game::DeferredDeletion {
+
+	// @brief Keeps a GPU resource alive until the GPU has finished every command issued before the frame it was retired in ends
+	void Retire(std::shared_ptr<void> resource);
+
+	// @brief Fences the resources retired this frame and releases those whose fence has signalled, never blocks
+	void EndFrame();
+
+	// @brief Releases everything immediately, call while the context is still current and the GPU is idle
+	void ReleaseAll();
+
+	size_t PendingCount();
+
+}
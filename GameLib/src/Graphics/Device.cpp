@@ -0,0 +1,271 @@
+#include "Device.h"
+
+#include "OpenGL.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+	enum class Function : size_t
+	{
+#define DO_FUNCTION_ID(TYPE, NAME) NAME,
+		FOR_OPENGL_FUNCTIONS(DO_FUNCTION_ID)
+	};
+
+#define DO_FUNCTION_NAME(TYPE, NAME) #NAME,
+	constexpr std::string_view g_FunctionNames[] = { FOR_OPENGL_FUNCTIONS(DO_FUNCTION_NAME) };
+	constexpr auto kFunctionCount = std::size(g_FunctionNames);
+
+	// the largest offset alignment drivers report, headless layouts are never tighter than real ones
+	constexpr auto kStorageBufferAlignment = GLint64{ 256 };
+
+	auto g_Backend = Game::DeviceBackend::OPENGL;
+	auto g_Calls = std::array<uint64_t, kFunctionCount>{};
+	auto g_Stats = Game::DeviceStats{};
+	auto g_NextName = GLuint{ 1u };
+	auto g_NextFence = uintptr_t{ 1u };
+	auto g_BufferStorage = std::unordered_map<GLuint, std::vector<std::byte>>{};
+	auto g_QueryTimestamps = std::unordered_map<GLuint, GLuint64>{};
+
+	void Record(Function function)
+	{
+		++g_Calls[std::to_underlying(function)];
+	}
+
+	template<Function F, class T>
+	struct Recorder;
+
+	// @brief Entry point that only counts its calls, anything returned is zero
+	template<Function F, class R, class... Args>
+	struct Recorder<F, R(APIENTRYP)(Args...)>
+	{
+		static R APIENTRY Call(Args...)
+		{
+			Record(F);
+			if constexpr (!std::is_void_v<R>)
+			{
+				return R{};
+			}
+		}
+	};
+
+	void GenerateNames(GLsizei count, GLuint* names)
+	{
+		std::ranges::generate(std::span{ names, static_cast<size_t>(count) }, [] { return g_NextName++; });
+	}
+
+	uint64_t PixelBytes(GLenum format, GLenum type)
+	{
+		const auto components = [&]
+			{
+				switch (format)
+				{
+					case GL_RED: return 1u;
+					case GL_RG: return 2u;
+					case GL_RGB: return 3u;
+					default: return 4u;
+				}
+			}();
+
+		const auto componentBytes = [&]
+			{
+				switch (type)
+				{
+					case GL_UNSIGNED_BYTE: return 1u;
+					case GL_HALF_FLOAT: return 2u;
+					default: return 4u;
+				}
+			}();
+
+		return components * componentBytes;
+	}
+
+	// @brief Replaces the entry points whose results the engine depends on or whose arguments carry the byte counts
+	void InstallRecordingOverrides()
+	{
+		glCreateShader = [](GLenum) { Record(Function::glCreateShader); return g_NextName++; };
+		glCreateProgram = [] { Record(Function::glCreateProgram); return g_NextName++; };
+		glCreateBuffers = [](GLsizei n, GLuint* buffers) { Record(Function::glCreateBuffers); GenerateNames(n, buffers); };
+		glGenBuffers = [](GLsizei n, GLuint* buffers) { Record(Function::glGenBuffers); GenerateNames(n, buffers); };
+		glCreateVertexArrays = [](GLsizei n, GLuint* arrays) { Record(Function::glCreateVertexArrays); GenerateNames(n, arrays); };
+		glGenVertexArrays = [](GLsizei n, GLuint* arrays) { Record(Function::glGenVertexArrays); GenerateNames(n, arrays); };
+		glCreateTextures = [](GLenum, GLsizei n, GLuint* textures) { Record(Function::glCreateTextures); GenerateNames(n, textures); };
+		glCreateSamplers = [](GLsizei n, GLuint* samplers) { Record(Function::glCreateSamplers); GenerateNames(n, samplers); };
+		glCreateFramebuffers = [](GLsizei n, GLuint* framebuffers) { Record(Function::glCreateFramebuffers); GenerateNames(n, framebuffers); };
+		glCreateRenderbuffers = [](GLsizei n, GLuint* renderbuffers) { Record(Function::glCreateRenderbuffers); GenerateNames(n, renderbuffers); };
+		glGetTextureSamplerHandleARB = [](GLuint, GLuint) { Record(Function::glGetTextureSamplerHandleARB); return GLuint64{ g_NextName++ }; };
+
+		glGetShaderiv = [](GLuint, GLenum pname, GLint* params)
+			{
+				Record(Function::glGetShaderiv);
+				*params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+			};
+		glGetProgramiv = [](GLuint, GLenum pname, GLint* params)
+			{
+				Record(Function::glGetProgramiv);
+				*params = pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS ? GL_TRUE : 0;
+			};
+		glCheckNamedFramebufferStatus = [](GLuint, GLenum) { Record(Function::glCheckNamedFramebufferStatus); return GLenum{ GL_FRAMEBUFFER_COMPLETE }; };
+		glGetInteger64v = [](GLenum pname, GLint64* data)
+			{
+				Record(Function::glGetInteger64v);
+				*data = pname == GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT ? kStorageBufferAlignment : 0;
+			};
+
+		glNamedBufferStorage = [](GLuint buffer, GLsizeiptr size, const void* data, GLbitfield)
+			{
+				Record(Function::glNamedBufferStorage);
+				auto& storage = g_BufferStorage[buffer];
+				storage.resize(static_cast<size_t>(size));
+				g_Stats.bytesAllocated += static_cast<uint64_t>(size);
+				if (data != nullptr)
+				{
+					std::memcpy(storage.data(), data, storage.size());
+					g_Stats.bytesUploaded += static_cast<uint64_t>(size);
+				}
+			};
+		glNamedBufferSubData = [](GLuint, GLintptr, GLsizeiptr size, const void*)
+			{
+				Record(Function::glNamedBufferSubData);
+				g_Stats.bytesUploaded += static_cast<uint64_t>(size);
+			};
+		glCopyNamedBufferSubData = [](GLuint, GLuint, GLintptr, GLintptr, GLsizeiptr size)
+			{
+				Record(Function::glCopyNamedBufferSubData);
+				g_Stats.bytesCopied += static_cast<uint64_t>(size);
+			};
+		glMapNamedBufferRange = [](GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield) -> void*
+			{
+				Record(Function::glMapNamedBufferRange);
+				const auto storage = g_BufferStorage.find(buffer);
+				if (storage == std::ranges::end(g_BufferStorage))
+				{
+					return nullptr;
+				}
+
+				g_Stats.bytesMapped += static_cast<uint64_t>(length);
+				return storage->second.data() + offset;
+			};
+		glUnmapNamedBuffer = [](GLuint) { Record(Function::glUnmapNamedBuffer); return GLboolean{ GL_TRUE }; };
+		glDeleteBuffers = [](GLsizei n, const GLuint* buffers)
+			{
+				Record(Function::glDeleteBuffers);
+				for (const auto buffer : std::span{ buffers, static_cast<size_t>(n) })
+				{
+					g_BufferStorage.erase(buffer);
+				}
+			};
+		glTextureSubImage2D = [](GLuint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, const void*)
+			{
+				Record(Function::glTextureSubImage2D);
+				g_Stats.bytesUploaded += static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * PixelBytes(format, type);
+			};
+		glTextureSubImage3D = [](GLuint, GLint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void*)
+			{
+				Record(Function::glTextureSubImage3D);
+				g_Stats.bytesUploaded += static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(depth) * PixelBytes(format, type);
+			};
+
+		glFenceSync = [](GLenum, GLbitfield) { Record(Function::glFenceSync); return reinterpret_cast<GLsync>(g_NextFence++); };
+		glClientWaitSync = [](GLsync, GLbitfield, GLuint64) { Record(Function::glClientWaitSync); return GLenum{ GL_ALREADY_SIGNALED }; };
+
+		glCreateQueries = [](GLenum, GLsizei n, GLuint* ids) { Record(Function::glCreateQueries); GenerateNames(n, ids); };
+		glDeleteQueries = [](GLsizei n, const GLuint* ids)
+			{
+				Record(Function::glDeleteQueries);
+				for (const auto id : std::span{ ids, static_cast<size_t>(n) })
+				{
+					g_QueryTimestamps.erase(id);
+				}
+			};
+		glQueryCounter = [](GLuint id, GLenum)
+			{
+				Record(Function::glQueryCounter);
+				const auto now = std::chrono::steady_clock::now().time_since_epoch();
+				g_QueryTimestamps[id] = static_cast<GLuint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+			};
+		glGetQueryObjectiv = [](GLuint, GLenum, GLint* params) { Record(Function::glGetQueryObjectiv); *params = GL_TRUE; };
+		glGetQueryObjectui64v = [](GLuint id, GLenum, GLuint64* params)
+			{
+				Record(Function::glGetQueryObjectui64v);
+				const auto timestamp = g_QueryTimestamps.find(id);
+				*params = timestamp == std::ranges::end(g_QueryTimestamps) ? GLuint64{} : timestamp->second;
+			};
+
+		glMultiDrawArraysIndirect = [](GLenum, const void*, GLsizei, GLsizei) { Record(Function::glMultiDrawArraysIndirect); ++g_Stats.drawCount; };
+		glMultiDrawElementsIndirect = [](GLenum, GLenum, const void*, GLsizei, GLsizei) { Record(Function::glMultiDrawElementsIndirect); ++g_Stats.drawCount; };
+		glMultiDrawElementsIndirectCount = [](GLenum, GLenum, const void*, GLintptr, GLsizei, GLsizei) { Record(Function::glMultiDrawElementsIndirectCount); ++g_Stats.drawCount; };
+		glDispatchCompute = [](GLuint, GLuint, GLuint) { Record(Function::glDispatchCompute); ++g_Stats.dispatchCount; };
+	}
+
+}
+
+namespace Game {
+
+	std::string DeviceStats::to_string() const
+	{
+		return std::format(
+			"{} calls, {} draws, {} dispatches, {} KiB allocated, {} KiB uploaded, {} KiB copied, {} KiB mapped",
+			callCount,
+			drawCount,
+			dispatchCount,
+			bytesAllocated >> 10zu,
+			bytesUploaded >> 10zu,
+			bytesCopied >> 10zu,
+			bytesMapped >> 10zu);
+	}
+
+	namespace Device {
+
+		void UseRecordingBackend()
+		{
+#define DO_RECORD(TYPE, NAME) NAME = &Recorder<Function::NAME, TYPE>::Call;
+			FOR_OPENGL_FUNCTIONS(DO_RECORD)
+
+			InstallRecordingOverrides();
+			g_Backend = DeviceBackend::RECORDING;
+			ResetStats();
+		}
+
+		DeviceBackend GetBackend()
+		{
+			return g_Backend;
+		}
+
+		DeviceStats GetStats()
+		{
+			auto stats = g_Stats;
+			stats.callCount = std::reduce(std::ranges::cbegin(g_Calls), std::ranges::cend(g_Calls), uint64_t{});
+			return stats;
+		}
+
+		std::vector<DeviceCallCount> GetCallCounts()
+		{
+			auto counts = std::views::zip(g_FunctionNames, g_Calls) |
+				std::views::filter([](const auto& entry) { return std::get<1>(entry) > 0u; }) |
+				std::views::transform([](const auto& entry) { return DeviceCallCount{ .name = std::get<0>(entry), .count = std::get<1>(entry) }; }) |
+				std::ranges::to<std::vector>();
+			std::ranges::sort(counts, std::ranges::greater{}, &DeviceCallCount::count);
+
+			return counts;
+		}
+
+		void ResetStats()
+		{
+			g_Calls = {};
+			g_Stats = {};
+		}
+
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Game {
+
+	enum class DeviceBackend
+	{
+		OPENGL,
+		RECORDING
+	};
+
+	inline std::string to_string(DeviceBackend backend)
+	{
+		switch (backend)
+		{
+			case DeviceBackend::OPENGL: return "OPENGL";
+			case DeviceBackend::RECORDING: return "RECORDING";
+			default: return "unknown";
+		}
+	}
+
+	struct DeviceCallCount
+	{
+		std::string_view name;
+		uint64_t count;
+	};
+
+	// @brief What the recording backend saw since the last reset, all zero on the OpenGL backend
+	struct DeviceStats
+	{
+		uint64_t callCount;
+		uint64_t drawCount;			// multi draw calls, not the commands they consume
+		uint64_t dispatchCount;
+		uint64_t bytesAllocated;	// buffer storage
+		uint64_t bytesUploaded;		// buffer storage initial data, buffer and texture sub data
+		uint64_t bytesCopied;		// buffer to buffer
+		uint64_t bytesMapped;
+
+		std::string to_string() const;
+	};
+
+	// @brief The GL entry points in OpenGL.h are the device layer every GPU object goes through, the OpenGL backend is what
+	// Window resolves from the driver and the recording backend replaces all of them so GameLib runs without a window or context
+	namespace Device {
+
+		// @brief Points every entry point at a recorder that counts calls and bytes. Objects get fresh names, compiles, links
+		// and frame buffers succeed, fences are always signalled and buffer storage is host memory so mappings can be written.
+		// Queries are always available and timestamps are the host clock at the call, so GPU zones measure command submission.
+		// Like GL itself it must only be used from one thread.
+		void UseRecordingBackend();
+		DeviceBackend GetBackend();
+
+		DeviceStats GetStats();
+
+		// @brief Entry points called since the last reset, most called first
+		std::vector<DeviceCallCount> GetCallCounts();
+
+		void ResetStats();
+
+	}
+
+}
@@ -0,0 +1,108 @@
+#include "DynamicResolution.h"
+
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace {
+
+	// keeps exact multiples of the step from rounding down a step
+	constexpr auto kQuantizeEpsilon = 1e-4f;
+
+}
+
+namespace Game {
+
+	std::string DynamicResolutionConfig::to_string() const
+	{
+		return std::format(
+			"target {:.2f} ms, scale {:.2f} to {:.2f} in steps of {:.3f}, headroom {:.2f}, grow after {} frames, settle {} frames",
+			targetFrameTime,
+			minScale,
+			maxScale,
+			scaleStep,
+			headroom,
+			growFrames,
+			settleFrames);
+	}
+
+	DynamicResolution::DynamicResolution(const DynamicResolutionConfig& config)
+		: m_Config{ config }
+		, m_Scale{}
+		, m_GrowSamples{}
+		, m_SettleSamples{}
+	{
+		Ensure(config.targetFrameTime > 0.0f, "Target frame time must be positive");
+		Ensure(config.scaleStep > 0.0f, "Scale step must be positive");
+		Ensure(config.minScale > 0.0f && config.minScale <= config.maxScale, "Scale bounds {} to {} are invalid", config.minScale, config.maxScale);
+		Ensure(config.headroom > 0.0f && config.headroom <= 1.0f, "Headroom {} is not in (0, 1]", config.headroom);
+
+		Reset();
+	}
+
+	float DynamicResolution::Update(float gpuFrameTime)
+	{
+		if (m_SettleSamples > 0u)
+		{
+			--m_SettleSamples;
+			return m_Scale;
+		}
+
+		const auto budget = m_Config.headroom * m_Config.targetFrameTime;
+		const auto desired = Quantize(m_Scale * std::sqrt(budget / std::max(gpuFrameTime, kQuantizeEpsilon)));
+
+		auto next = m_Scale;
+		if (gpuFrameTime > m_Config.targetFrameTime)
+		{
+			next = std::min(desired, m_Scale);
+			m_GrowSamples = 0u;
+		}
+		else if (desired > m_Scale)
+		{
+			// one step at a time, the cost model is least reliable extrapolating to more pixels
+			if (++m_GrowSamples >= m_Config.growFrames)
+			{
+				next = Quantize(m_Scale + m_Config.scaleStep);
+				m_GrowSamples = 0u;
+			}
+		}
+		else
+		{
+			m_GrowSamples = 0u;
+		}
+
+		next = std::clamp(next, m_Config.minScale, m_Config.maxScale);
+		if (next != m_Scale)
+		{
+			m_Scale = next;
+			m_SettleSamples = m_Config.settleFrames;
+		}
+
+		return m_Scale;
+	}
+
+	float DynamicResolution::GetScale() const
+	{
+		return m_Scale;
+	}
+
+	const DynamicResolutionConfig& DynamicResolution::GetConfig() const
+	{
+		return m_Config;
+	}
+
+	void DynamicResolution::Reset()
+	{
+		m_Scale = m_Config.maxScale;
+		m_GrowSamples = 0u;
+		m_SettleSamples = 0u;
+	}
+
+	float DynamicResolution::Quantize(float scale) const
+	{
+		return std::floor(scale / m_Config.scaleStep + kQuantizeEpsilon) * m_Config.scaleStep;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Game {
+
+	struct DynamicResolutionConfig
+	{
+		float targetFrameTime;	// GPU milliseconds per frame
+		float minScale;			// of the output width and height
+		float maxScale;
+		float scaleStep;		// scales are multiples of it so render targets are only recreated for real changes
+		float headroom;			// fraction of the target new scales aim for, leaving room for noise
+		uint32_t growFrames;	// consecutive samples that must allow a larger scale before growing
+		uint32_t settleFrames;	// samples ignored after a change, they were measured at the previous scale
+
+		std::string to_string() const;
+	};
+
+	// @brief Picks the render scale from measured GPU frame times. Cost is taken to be proportional to the pixel count, so
+	// the scale aiming for the headroom is the current one times sqrt(headroom * target / measured). Going over the target
+	// shrinks to that scale at once, growing takes one step after growFrames samples in a row allowed more so a single fast
+	// frame cannot cause a resize. Only the samples decide the scale, the same trace always gives the same scales.
+	class DynamicResolution
+	{
+	public:
+		explicit DynamicResolution(const DynamicResolutionConfig& config);
+
+		// @brief Takes the GPU time of a frame rendered at the current scale, returns the scale for the next frames
+		float Update(float gpuFrameTime);
+		float GetScale() const;
+		const DynamicResolutionConfig& GetConfig() const;
+
+		// @brief Back to the largest scale with no history
+		void Reset();
+
+	private:
+		float Quantize(float scale) const;
+
+		DynamicResolutionConfig m_Config;
+		float m_Scale;
+		uint32_t m_GrowSamples;
+		uint32_t m_SettleSamples;
+	};
+
+}
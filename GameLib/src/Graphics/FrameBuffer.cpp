@@ -1,5 +1,6 @@
 #include "FrameBuffer.h"
 
+#include "GPUMemory.h"
 #include "Utils/Error.h"
 
 #include <algorithm>
@@ -9,29 +10,38 @@ namespace Game {
 
 	FrameBuffer::FrameBuffer(std::vector<const Texture*> colorTextures, const Texture* depthTexture, const std::string& name)
 		: m_Handle(0u, [](const auto buffer) { glDeleteFramebuffers(1u, &buffer); })
-		, m_ColorTextures{ colorTextures }
-		, m_DepthTexture{ depthTexture }
+		, m_Width{}
+		, m_Height{}
+		, m_ColorAttachmentCount{ static_cast<uint32_t>(colorTextures.size()) }
+		, m_HasDepth{ depthTexture != nullptr }
 		, m_Name{ name }
+		, m_MemoryRegistration{ GPUMemory::Register(GPUMemoryCategory::FRAME_BUFFER, name, 0zu) }
 	{
-		Expect(!m_ColorTextures.empty(), "Must have color textures");
-		Expect(m_ColorTextures.size() < 8u, "Hit arbitrary color texture limit");
-		Expect(std::ranges::all_of(m_ColorTextures,
+		Expect(!colorTextures.empty(), "Must have color textures");
+		Expect(colorTextures.size() < 8u, "Hit arbitrary color texture limit");
+		Expect(std::ranges::all_of(colorTextures,
 								   [&](const auto* e)
 								   {
-									   return e->GetWidth() == m_ColorTextures[0]->GetWidth() &&
-											  e->GetHeight() == m_ColorTextures[0]->GetHeight();
+									   return e->GetWidth() == colorTextures[0]->GetWidth() &&
+											  e->GetHeight() == colorTextures[0]->GetHeight();
 								   }), "All color textures must have same dimensions");
 
+		m_Width = colorTextures.front()->GetWidth();
+		m_Height = colorTextures.front()->GetHeight();
+
 		glCreateFramebuffers(1, &m_Handle);
 
-		for (const auto& [index, colorTex] : std::views::enumerate(m_ColorTextures))
+		for (const auto& [index, colorTex] : std::views::enumerate(colorTextures))
 		{
 			glNamedFramebufferTexture(m_Handle, static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index), colorTex->GetNativeHandle(), 0);
 		}
 
-		glNamedFramebufferTexture(m_Handle, GL_DEPTH_ATTACHMENT, m_DepthTexture->GetNativeHandle(), 0);
+		if (depthTexture != nullptr)
+		{
+			glNamedFramebufferTexture(m_Handle, GL_DEPTH_ATTACHMENT, depthTexture->GetNativeHandle(), 0);
+		}
 
-		const auto attachments = std::views::iota(size_t{ 0 }, m_ColorTextures.size()) |
+		const auto attachments = std::views::iota(size_t{ 0 }, colorTextures.size()) |
 			std::views::transform([](auto e) { return static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + e); }) |
 			std::ranges::to<std::vector>();
 
@@ -45,6 +55,7 @@ namespace Game {
 	void FrameBuffer::Bind() const
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
+		glViewportIndexedf(0u, 0.0f, 0.0f, static_cast<GLfloat>(GetWidth()), static_cast<GLfloat>(GetHeight()));
 	}
 
 	void FrameBuffer::UnBind() const
@@ -52,14 +63,30 @@ namespace Game {
 		glBindFramebuffer(GL_FRAMEBUFFER, 0u);
 	}
 
+	void FrameBuffer::Clear() const
+	{
+		constexpr GLfloat color[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		constexpr auto depth = GLfloat{ 1.0f };
+
+		for (const auto index : std::views::iota(0, static_cast<GLint>(m_ColorAttachmentCount)))
+		{
+			glClearNamedFramebufferfv(m_Handle, GL_COLOR, index, color);
+		}
+
+		if (m_HasDepth)
+		{
+			glClearNamedFramebufferfv(m_Handle, GL_DEPTH, 0, &depth);
+		}
+	}
+
 	uint32_t FrameBuffer::GetWidth() const
 	{
-		return m_ColorTextures.front()->GetWidth();
+		return m_Width;
 	}
 
 	uint32_t FrameBuffer::GetHeight() const
 	{
-		return m_ColorTextures.front()->GetHeight();
+		return m_Height;
 	}
 
 	GLuint FrameBuffer::GetNativeHandle() const
@@ -67,11 +94,6 @@ namespace Game {
 		return m_Handle;
 	}
 
-	std::span<const Texture* const> FrameBuffer::GetColorTextures() const
-	{
-		return m_ColorTextures;
-	}
-
 	std::string_view FrameBuffer::GetName() const
 	{
 		return m_Name;
@@ -5,32 +5,38 @@
 #include "OpenGL.h"
 
 #include <cstdint>
-#include <span>
 #include <string>
 #include <vector>
 
 namespace Game {
 
+	// @brief Keeps the attachments' size, not the textures, whose addresses change as the texture manager grows
 	class FrameBuffer
 	{
 	public:
+		// @brief depthTexture may be null for frame buffers without depth
 		FrameBuffer(std::vector<const Texture*> colorTextures, const Texture* depthTexture, const std::string& name);
 
+		// @brief Also sets the viewport to the attachments' size
 		void Bind() const;
 		void UnBind() const;
+		// @brief Clears every color attachment to zero and the depth attachment, if any, to the far plane
+		void Clear() const;
 
 		uint32_t GetWidth() const;
 		uint32_t GetHeight() const;
 
 		GLuint GetNativeHandle() const;
-		std::span<const Texture* const> GetColorTextures() const;
 		std::string_view GetName() const;
 
 	private:
 		AutoRelease<GLuint> m_Handle;
-		std::vector<const Texture*> m_ColorTextures;
-		const Texture* m_DepthTexture;
+		uint32_t m_Width;
+		uint32_t m_Height;
+		uint32_t m_ColorAttachmentCount;
+		bool m_HasDepth;
 		std::string m_Name;
+		AutoRelease<uint64_t> m_MemoryRegistration;
 	};
 
 }
@@ -0,0 +1,125 @@
+#include "GPUCuller.h"
+
+#include "Shader.h"
+#include "Utils.h"
+
+#include <format>
+
+namespace {
+
+	// must match local_size_x in cull.comp
+	constexpr auto kCullGroupSize = 64u;
+
+	Game::Program CreateComputeProgram(Game::ResourceLoader& resourceLoader, std::string_view path, std::string_view shaderName, std::string_view programName)
+	{
+		const auto shader = Game::Shader{ resourceLoader._LoadString(path), Game::ShaderType::COMPUTE, shaderName };
+		return { shader, programName };
+	}
+
+}
+
+namespace Game {
+
+	GPUCuller::GPUCuller(ResourceLoader& resourceLoader)
+		: m_CullProgram{ CreateComputeProgram(resourceLoader, "shaders\\cull.comp", "cull_compute_shader", "cull_prog") }
+		, m_CompactProgram{ CreateComputeProgram(resourceLoader, "shaders\\cull_compact.comp", "cull_compact_compute_shader", "cull_compact_prog") }
+		, m_Layout{}
+		, m_InstanceBuffer{ sizeof(CullInstance), "cull_instance_buffer" }
+		, m_TemplateBuffer{ sizeof(IndirectCommand), "cull_template_buffer" }
+		, m_VisibleCounts{ sizeof(uint32_t), "cull_visible_counts" }
+		, m_VisibleInstances{ sizeof(uint32_t), "cull_visible_instances" }
+		, m_Commands{ sizeof(IndirectCommand), "cull_commands" }
+		, m_DrawCounts{ sizeof(uint32_t), "cull_draw_counts" }
+	{}
+
+	std::span<const CullBatch> GPUCuller::Cull(const Scene& scene, GLuint objectData, size_t objectDataOffset, size_t objectDataSize)
+	{
+		BuildCullLayout(scene.entities, [&](auto handle) { return scene.meshManager.GetView(handle); }, m_Layout);
+		if (m_Layout.instances.empty())
+		{
+			return {};
+		}
+
+		const auto& instances = m_Layout.instances;
+		const auto& templates = m_Layout.templates;
+
+		Reserve(instances.size(), templates.size());
+		ResizeGPUBuffer<uint32_t>(m_Layout.batches.size(), m_DrawCounts);
+		m_InstanceBuffer.Write(std::as_bytes(std::span{ instances }), 0zu);
+		m_TemplateBuffer.Write(std::as_bytes(std::span{ templates }), 0zu);
+
+		glClearNamedBufferSubData(m_VisibleCounts.GetNativeHandle(), GL_R32UI, 0, templates.size() * sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+		const auto frustum = scene.camera.GetFrustum();
+		const auto& planes = frustum.GetPlanes();
+		glProgramUniform4fv(m_CullProgram.GetNativeHandle(), 0, static_cast<GLsizei>(planes.size()), &planes.front().x);
+		glProgramUniform1ui(m_CullProgram.GetNativeHandle(), 6, static_cast<GLuint>(instances.size()));
+
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_InstanceBuffer.GetNativeHandle(), m_InstanceBuffer.FrameOffsetBytes(), instances.size() * sizeof(CullInstance));
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, objectData, objectDataOffset, objectDataSize);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 2, m_TemplateBuffer.GetNativeHandle(), m_TemplateBuffer.FrameOffsetBytes(), templates.size() * sizeof(IndirectCommand));
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_VisibleCounts.GetNativeHandle());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_VisibleInstances.GetNativeHandle());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_Commands.GetNativeHandle());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_DrawCounts.GetNativeHandle());
+
+		m_CullProgram.Use();
+		glDispatchCompute((static_cast<GLuint>(instances.size()) + kCullGroupSize - 1u) / kCullGroupSize, 1u, 1u);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		m_CompactProgram.Use();
+		for (const auto& [index, batch] : m_Layout.batches | std::views::enumerate)
+		{
+			glProgramUniform1ui(m_CompactProgram.GetNativeHandle(), 0, batch.firstTemplate);
+			glProgramUniform1ui(m_CompactProgram.GetNativeHandle(), 1, batch.templateCount);
+			glProgramUniform1ui(m_CompactProgram.GetNativeHandle(), 2, static_cast<GLuint>(index));
+			glDispatchCompute(1u, 1u, 1u);
+		}
+
+		// the commands and counts are consumed as indirect parameters, the instances through a storage buffer in the vertex shader
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+		return m_Layout.batches;
+	}
+
+	void GPUCuller::Reserve(size_t instanceCount, size_t templateCount)
+	{
+		ResizeGPUBuffer<CullInstance>(instanceCount, m_InstanceBuffer);
+		ResizeGPUBuffer<IndirectCommand>(templateCount, m_TemplateBuffer);
+		ResizeGPUBuffer<uint32_t>(templateCount, m_VisibleCounts);
+		ResizeGPUBuffer<uint32_t>(instanceCount, m_VisibleInstances);
+		ResizeGPUBuffer<IndirectCommand>(templateCount, m_Commands);
+	}
+
+	void GPUCuller::Advance()
+	{
+		m_InstanceBuffer.Advance();
+		m_TemplateBuffer.Advance();
+	}
+
+	GLuint GPUCuller::GetCommandBufferHandle() const
+	{
+		return m_Commands.GetNativeHandle();
+	}
+
+	GLuint GPUCuller::GetDrawCountBufferHandle() const
+	{
+		return m_DrawCounts.GetNativeHandle();
+	}
+
+	GLuint GPUCuller::GetInstanceBufferHandle() const
+	{
+		return m_VisibleInstances.GetNativeHandle();
+	}
+
+	std::chrono::nanoseconds GPUCuller::GetFenceWaitTime() const
+	{
+		return m_InstanceBuffer.GetFenceWaitTime() + m_TemplateBuffer.GetFenceWaitTime();
+	}
+
+	std::string GPUCuller::to_string() const
+	{
+		return std::format("GPU culler: {} instances, {} templates in {} batches", m_Layout.instances.size(), m_Layout.templates.size(), m_Layout.batches.size());
+	}
+
+}
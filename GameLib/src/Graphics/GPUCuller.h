@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Buffer.h"
+#include "Core/Scene.h"
+#include "Culling.h"
+#include "MultiBuffer.h"
+#include "PersistentBuffer.h"
+#include "Program.h"
+#include "Resources/ResourceLoader.h"
+#include "OpenGL.h"
+
+#include <chrono>
+#include <span>
+#include <string>
+
+namespace Game {
+
+	// @brief Frustum culling in compute passes. Writes compacted indirect commands, one draw count per batch and the
+	// entity of every visible instance without any readback, Game::Cull is the CPU reference of the same passes.
+	class GPUCuller
+	{
+	public:
+		GPUCuller(ResourceLoader& resourceLoader);
+
+		// @brief Uploads the layout and dispatches the cull and compaction passes, objectData must hold this frame's
+		// per entity ObjectData. Returns the batches, draw batch i reads its draw count at offset i * sizeof(uint32_t).
+		std::span<const CullBatch> Cull(const Scene& scene, GLuint objectData, size_t objectDataOffset, size_t objectDataSize);
+		// @brief Grows the buffers up front so culling up to the given counts never has to
+		void Reserve(size_t instanceCount, size_t templateCount);
+		void Advance();
+
+		GLuint GetCommandBufferHandle() const;
+		GLuint GetDrawCountBufferHandle() const;
+		GLuint GetInstanceBufferHandle() const;
+		std::chrono::nanoseconds GetFenceWaitTime() const;
+
+		std::string to_string() const;
+
+	private:
+		Program m_CullProgram;
+		Program m_CompactProgram;
+		CullLayout m_Layout;
+		MultiBuffer<PersistentBuffer> m_InstanceBuffer;
+		MultiBuffer<PersistentBuffer> m_TemplateBuffer;
+		// written and read by the GPU only, later frames are ordered behind earlier ones so one copy suffices
+		Buffer m_VisibleCounts;
+		Buffer m_VisibleInstances;
+		Buffer m_Commands;
+		Buffer m_DrawCounts;
+	};
+
+}
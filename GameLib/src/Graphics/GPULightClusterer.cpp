@@ -0,0 +1,66 @@
+#include "GPULightClusterer.h"
+
+#include "Shader.h"
+#include "Utils.h"
+
+#include <span>
+#include <vector>
+
+namespace {
+
+	// must match local_size_x in light_cluster.comp
+	constexpr auto kClusterGroupSize = 64u;
+
+	// uploaded as ClusterBounds in light_cluster.comp
+	static_assert(sizeof(Game::AABB) == sizeof(float) * 6zu);
+
+}
+
+namespace Game {
+
+	GPULightClusterer::GPULightClusterer(ResourceLoader& resourceLoader)
+		: m_Program{ Shader{ resourceLoader._LoadString("shaders\\light_cluster.comp"), ShaderType::COMPUTE, "light_cluster_compute_shader" }, "light_cluster_prog" }
+		, m_Grid{}
+		, m_Bounds{ sizeof(AABB), "light_cluster_bounds" }
+		, m_Clusters{ sizeof(ClusterRange), "light_clusters" }
+		, m_LightIndices{ sizeof(uint32_t), "light_cluster_indices" }
+	{}
+
+	void GPULightClusterer::Assign(const ClusterGrid& grid, const TransientAllocation& lights, const TransientAllocation& camera)
+	{
+		const auto clusterCount = grid.ClusterCount();
+
+		// the bounds only depend on the projection so they are rewritten when it changes
+		if (m_Grid != grid)
+		{
+			const auto bounds = grid.Bounds();
+			ResizeGPUBuffer(bounds, m_Bounds);
+			ResizeGPUBuffer<ClusterRange>(clusterCount, m_Clusters);
+			ResizeGPUBuffer<uint32_t>(clusterCount * kMaxLightsPerCluster, m_LightIndices);
+			m_Bounds.Write(std::as_bytes(std::span{ bounds }), 0zu);
+			m_Grid = grid;
+		}
+
+		glProgramUniform1ui(m_Program.GetNativeHandle(), 0, clusterCount);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_Bounds.GetNativeHandle());
+		lights.Bind(GL_SHADER_STORAGE_BUFFER, 1);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_Clusters.GetNativeHandle());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_LightIndices.GetNativeHandle());
+		camera.Bind(GL_SHADER_STORAGE_BUFFER, 4);
+
+		m_Program.Use();
+		glDispatchCompute((clusterCount + kClusterGroupSize - 1u) / kClusterGroupSize, 1u, 1u);
+	}
+
+	GLuint GPULightClusterer::GetClusterBufferHandle() const
+	{
+		return m_Clusters.GetNativeHandle();
+	}
+
+	GLuint GPULightClusterer::GetLightIndexBufferHandle() const
+	{
+		return m_LightIndices.GetNativeHandle();
+	}
+
+}
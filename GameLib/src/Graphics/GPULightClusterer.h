@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Buffer.h"
+#include "LightClusters.h"
+#include "Program.h"
+#include "Resources/ResourceLoader.h"
+#include "TransientAllocator.h"
+#include "OpenGL.h"
+
+#include <optional>
+
+namespace Game {
+
+	// @brief Light assignment in a compute pass, Game::AssignLights is the CPU reference. Every cluster owns a fixed range of
+	// kMaxLightsPerCluster indices so the pass needs no atomics and nothing is read back.
+	class GPULightClusterer
+	{
+	public:
+		GPULightClusterer(ResourceLoader& resourceLoader);
+
+		// @brief Dispatches the assignment pass, lights must hold this frame's light buffer and camera its CameraData.
+		// The lists are storage writes, readers need a GL_SHADER_STORAGE_BARRIER_BIT barrier first.
+		void Assign(const ClusterGrid& grid, const TransientAllocation& lights, const TransientAllocation& camera);
+
+		GLuint GetClusterBufferHandle() const;
+		GLuint GetLightIndexBufferHandle() const;
+
+	private:
+		Program m_Program;
+		std::optional<ClusterGrid> m_Grid;	// the bounds buffer was last written for
+		Buffer m_Bounds;
+		Buffer m_Clusters;
+		Buffer m_LightIndices;
+	};
+
+}
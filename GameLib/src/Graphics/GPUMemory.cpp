@@ -0,0 +1,107 @@
+#include "GPUMemory.h"
+
+#include "Utils/Log.h"
+
+#include <algorithm>
+#include <format>
+#include <map>
+#include <ranges>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+	struct Allocation
+	{
+		Game::GPUMemoryCategory category;
+		std::string name;
+		size_t bytes;
+	};
+
+	auto g_Allocations = std::unordered_map<uint64_t, Allocation>{};
+	auto g_NextID = uint64_t{ 1u };
+	auto g_Stats = Game::GPUMemoryStats{
+		.totalBytes = 0zu,
+		.peakBytes = 0zu,
+		.allocationCount = 0zu,
+		.categoryBytes = {},
+		.budgetBytes = std::nullopt
+	};
+
+	void Deregister(uint64_t id)
+	{
+		const auto allocation = g_Allocations.find(id);
+		if (allocation == std::ranges::end(g_Allocations))
+		{
+			return;
+		}
+
+		const auto& [category, name, bytes] = allocation->second;
+		g_Stats.totalBytes -= bytes;
+		g_Stats.categoryBytes[std::to_underlying(category)] -= bytes;
+		--g_Stats.allocationCount;
+
+		g_Allocations.erase(allocation);
+	}
+
+}
+
+namespace Game {
+
+	std::string GPUMemoryStats::to_string() const
+	{
+		const auto budget = budgetBytes ? std::format("{} MiB", *budgetBytes >> 20zu) : std::string{ "none" };
+		return std::format("{} MiB in {} allocations, peak {} MiB, budget {}", totalBytes >> 20zu, allocationCount, peakBytes >> 20zu, budget);
+	}
+
+	namespace GPUMemory {
+
+		AutoRelease<uint64_t> Register(GPUMemoryCategory category, std::string_view name, size_t bytes)
+		{
+			const auto id = g_NextID++;
+			g_Allocations.emplace(id, Allocation{ .category = category, .name = std::string{ name }, .bytes = bytes });
+
+			const auto previousTotal = g_Stats.totalBytes;
+			g_Stats.totalBytes += bytes;
+			g_Stats.categoryBytes[std::to_underlying(category)] += bytes;
+			g_Stats.peakBytes = std::max(g_Stats.peakBytes, g_Stats.totalBytes);
+			++g_Stats.allocationCount;
+
+			if (const auto budget = g_Stats.budgetBytes; budget && previousTotal <= *budget && g_Stats.totalBytes > *budget)
+			{
+				Log::Warn("GPU memory budget of {} bytes exceeded by {} {} of {} bytes, {} bytes in use", *budget, category, name, bytes, g_Stats.totalBytes);
+			}
+
+			return { id, Deregister };
+		}
+
+		GPUMemoryStats GetStats()
+		{
+			return g_Stats;
+		}
+
+		std::vector<GPUMemoryUsage> GetUsage()
+		{
+			auto grouped = std::map<std::tuple<GPUMemoryCategory, std::string_view>, GPUMemoryUsage>{};
+			for (const auto& [id, allocation] : g_Allocations)
+			{
+				auto& usage = grouped.try_emplace({ allocation.category, allocation.name }, allocation.category, allocation.name, 0zu, 0zu).first->second;
+				usage.bytes += allocation.bytes;
+				++usage.count;
+			}
+
+			auto usage = grouped | std::views::values | std::ranges::to<std::vector>();
+			std::ranges::sort(usage, std::ranges::greater{}, &GPUMemoryUsage::bytes);
+
+			return usage;
+		}
+
+		void SetBudget(std::optional<size_t> budgetBytes)
+		{
+			g_Stats.budgetBytes = budgetBytes;
+		}
+
+	}
+
+}
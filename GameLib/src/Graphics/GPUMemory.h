@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Utils/AutoRelease.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Game {
+
+	enum class GPUMemoryCategory
+	{
+		BUFFER,
+		PERSISTENT_BUFFER,
+		TEXTURE,
+		FRAME_BUFFER	// owns no storage, its attachments are accounted by their textures
+	};
+
+	constexpr auto kGPUMemoryCategoryCount = 4zu;
+
+	inline std::string to_string(GPUMemoryCategory category)
+	{
+		switch (category)
+		{
+			case GPUMemoryCategory::BUFFER: return "BUFFER";
+			case GPUMemoryCategory::PERSISTENT_BUFFER: return "PERSISTENT_BUFFER";
+			case GPUMemoryCategory::TEXTURE: return "TEXTURE";
+			case GPUMemoryCategory::FRAME_BUFFER: return "FRAME_BUFFER";
+			default: return "unknown";
+		}
+	}
+
+	// @brief Live allocations sharing a category and object label
+	struct GPUMemoryUsage
+	{
+		GPUMemoryCategory category;
+		std::string name;
+		size_t bytes;
+		size_t count;
+	};
+
+	struct GPUMemoryStats
+	{
+		size_t totalBytes;
+		size_t peakBytes;
+		size_t allocationCount;
+		std::array<size_t, kGPUMemoryCategoryCount> categoryBytes;
+		std::optional<size_t> budgetBytes;
+
+		std::string to_string() const;
+	};
+
+	namespace GPUMemory {
+
+		// @brief Accounts an allocation under the object label it was given, releasing the handle removes it again
+		AutoRelease<uint64_t> Register(GPUMemoryCategory category, std::string_view name, size_t bytes);
+
+		GPUMemoryStats GetStats();
+
+		// @brief Largest first
+		std::vector<GPUMemoryUsage> GetUsage();
+
+		// @brief A warning is logged every time the total grows past the budget, std::nullopt disables it
+		void SetBudget(std::optional<size_t> budgetBytes);
+
+	}
+
+}
@@ -0,0 +1,220 @@
+#include "GPUProfiler.h"
+
+#include "Utils/Error.h"
+
+#include <format>
+#include <ranges>
+#include <utility>
+
+namespace {
+
+	constexpr auto kNanosecondsPerMillisecond = 1'000'000.0;
+
+}
+
+namespace Game {
+
+	GPUProfiler::GPUProfiler()
+		: m_Slots{}
+		, m_SlotIndex{ 0zu }
+		, m_InFrame{ false }
+		, m_OpenRecords{}
+		, m_Zones{}
+		, m_ZoneIndices{}
+		, m_ResolvedFrames{ 0zu }
+		, m_DroppedFrames{ 0zu }
+	{
+	}
+
+	void GPUProfiler::BeginFrame()
+	{
+		Expect(!m_InFrame, "Profiler frame was not ended");
+
+		auto& slot = m_Slots[m_SlotIndex];
+		if (slot.pending && !Resolve(slot))
+		{
+			++m_DroppedFrames;
+		}
+
+		slot.queryCount = 0u;
+		slot.records.clear();
+		slot.pending = false;
+		m_InFrame = true;
+	}
+
+	void GPUProfiler::EndFrame()
+	{
+		Expect(m_InFrame, "Profiler frame was not begun");
+		Expect(m_OpenRecords.empty(), "Zone {} was not ended", m_OpenRecords.empty() ? std::string{} : m_Zones[m_Slots[m_SlotIndex].records[m_OpenRecords.back()].zone].path);
+
+		m_Slots[m_SlotIndex].pending = !m_Slots[m_SlotIndex].records.empty();
+		m_SlotIndex = (m_SlotIndex + 1zu) % kFrameSlots;
+		m_InFrame = false;
+
+		// oldest first, the GPU finishes frames in order so once one is not done the later ones are not either
+		for (const auto offset : std::views::iota(0zu, kFrameSlots))
+		{
+			auto& slot = m_Slots[(m_SlotIndex + offset) % kFrameSlots];
+			if (!slot.pending)
+			{
+				continue;
+			}
+
+			if (!Resolve(slot))
+			{
+				break;
+			}
+
+			slot.pending = false;
+		}
+	}
+
+	void GPUProfiler::BeginZone(std::string_view name)
+	{
+		Expect(m_InFrame, "Zone {} outside of a profiler frame", name);
+
+		auto& slot = m_Slots[m_SlotIndex];
+		const auto path = m_OpenRecords.empty() ?
+			std::string{ name } :
+			std::format("{}/{}", m_Zones[slot.records[m_OpenRecords.back()].zone].path, name);
+
+		auto zone = m_ZoneIndices.find(path);
+		if (zone == std::ranges::end(m_ZoneIndices))
+		{
+			m_Zones.push_back({
+				.name = std::string{ name },
+				.path = path,
+				.depth = static_cast<uint32_t>(m_OpenRecords.size()),
+				.gpu = RollingStats{ kHistoryFrames },
+				.cpu = RollingStats{ kHistoryFrames }
+			});
+			zone = m_ZoneIndices.emplace(path, static_cast<uint32_t>(m_Zones.size() - 1zu)).first;
+		}
+
+		const auto cpuBegin = Clock::now();
+		const auto beginQuery = NextQuery(slot);
+		glQueryCounter(slot.queries[beginQuery], GL_TIMESTAMP);
+
+		slot.records.push_back({ .zone = zone->second, .beginQuery = beginQuery, .endQuery = beginQuery, .cpuBegin = cpuBegin, .cpuEnd = cpuBegin });
+		m_OpenRecords.push_back(slot.records.size() - 1zu);
+	}
+
+	void GPUProfiler::EndZone()
+	{
+		Expect(!m_OpenRecords.empty(), "No zone to end");
+
+		auto& slot = m_Slots[m_SlotIndex];
+		auto& record = slot.records[m_OpenRecords.back()];
+		m_OpenRecords.pop_back();
+
+		record.endQuery = NextQuery(slot);
+		glQueryCounter(slot.queries[record.endQuery], GL_TIMESTAMP);
+		record.cpuEnd = Clock::now();
+	}
+
+	AutoRelease<GPUProfiler*, nullptr> GPUProfiler::Scope(std::string_view name)
+	{
+		BeginZone(name);
+		return { this, [](auto* profiler) { profiler->EndZone(); } };
+	}
+
+	std::vector<ProfileZoneStats> GPUProfiler::GetZones() const
+	{
+		return m_Zones |
+			std::views::transform([](const auto& zone)
+								  {
+									  return ProfileZoneStats{
+										  .name = zone.name,
+										  .path = zone.path,
+										  .depth = zone.depth,
+										  .gpu = zone.gpu.Summary(),
+										  .cpu = zone.cpu.Summary()
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+	}
+
+	std::vector<float> GPUProfiler::GetGPUHistory(std::string_view path) const
+	{
+		const auto zone = m_ZoneIndices.find(path);
+		return zone == std::ranges::end(m_ZoneIndices) ? std::vector<float>{} : m_Zones[zone->second].gpu.Samples();
+	}
+
+	std::optional<float> GPUProfiler::GetLatestGPUTime(std::string_view path) const
+	{
+		const auto zone = m_ZoneIndices.find(path);
+		return zone == std::ranges::end(m_ZoneIndices) ? std::nullopt : m_Zones[zone->second].gpu.Latest();
+	}
+
+	size_t GPUProfiler::GetResolvedFrames() const
+	{
+		return m_ResolvedFrames;
+	}
+
+	size_t GPUProfiler::GetDroppedFrames() const
+	{
+		return m_DroppedFrames;
+	}
+
+	void GPUProfiler::ResetStats()
+	{
+		for (auto& zone : m_Zones)
+		{
+			zone.gpu.Clear();
+			zone.cpu.Clear();
+		}
+
+		m_DroppedFrames = 0zu;
+	}
+
+	uint32_t GPUProfiler::NextQuery(FrameSlot& slot)
+	{
+		// the ring only grows until it holds the most queries a frame has needed
+		if (slot.queryCount == slot.queries.size())
+		{
+			auto query = AutoRelease<GLuint>{ 0u, [](auto query) { glDeleteQueries(1, &query); } };
+			glCreateQueries(GL_TIMESTAMP, 1, &query);
+			slot.queries.push_back(std::move(query));
+		}
+
+		return slot.queryCount++;
+	}
+
+	bool GPUProfiler::Resolve(const FrameSlot& slot)
+	{
+		auto available = GLint{};
+		glGetQueryObjectiv(slot.queries[slot.queryCount - 1u], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+		{
+			return false;
+		}
+
+		auto gpu = std::vector<double>(m_Zones.size(), 0.0);
+		auto cpu = std::vector<double>(m_Zones.size(), 0.0);
+		auto entered = std::vector<bool>(m_Zones.size(), false);
+		for (const auto& record : slot.records)
+		{
+			auto begin = GLuint64{};
+			auto end = GLuint64{};
+			glGetQueryObjectui64v(slot.queries[record.beginQuery], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(slot.queries[record.endQuery], GL_QUERY_RESULT, &end);
+
+			gpu[record.zone] += static_cast<double>(end - begin) / kNanosecondsPerMillisecond;
+			cpu[record.zone] += std::chrono::duration<double, std::milli>(record.cpuEnd - record.cpuBegin).count();
+			entered[record.zone] = true;
+		}
+
+		for (const auto& [zone, wasEntered] : entered | std::views::enumerate)
+		{
+			if (wasEntered)
+			{
+				m_Zones[zone].gpu.Add(static_cast<float>(gpu[zone]));
+				m_Zones[zone].cpu.Add(static_cast<float>(cpu[zone]));
+			}
+		}
+
+		++m_ResolvedFrames;
+		return true;
+	}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Utils/AutoRelease.h"
+#include "Utils/RollingStats.h"
+#include "Utils/StringMap.h"
+#include "OpenGL.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Game {
+
+	struct ProfileZoneStats
+	{
+		std::string name;
+		std::string path;	// names of the enclosing zones and this one separated by '/'
+		uint32_t depth;
+		RollingSummary gpu;	// milliseconds per frame
+		RollingSummary cpu;
+	};
+
+	// @brief Nested zones timed on the GPU with GL_TIMESTAMP queries and on the CPU with the steady clock. Each frame slot
+	// has its own ring of queries, a slot is read back once its last query is available, which never blocks. A frame still
+	// not available when its slot comes around again, kFrameSlots frames later, is dropped.
+	class GPUProfiler
+	{
+	public:
+		static constexpr auto kFrameSlots = 4zu;
+		static constexpr auto kHistoryFrames = 240zu;
+
+		GPUProfiler();
+
+		void BeginFrame();
+		void EndFrame();
+
+		// @brief Zones are keyed by their path, a zone entered several times in a frame records the sum
+		void BeginZone(std::string_view name);
+		void EndZone();
+		// @brief Zone ending when the returned object is destroyed
+		[[nodiscard]] AutoRelease<GPUProfiler*, nullptr> Scope(std::string_view name);
+
+		// @brief In the order zones were first entered, so children follow their parents
+		std::vector<ProfileZoneStats> GetZones() const;
+		// @brief GPU milliseconds per frame, oldest first, empty for unknown zones
+		std::vector<float> GetGPUHistory(std::string_view path) const;
+		// @brief GPU milliseconds of the latest frame read back that entered the zone
+		std::optional<float> GetLatestGPUTime(std::string_view path) const;
+		// @brief Frames read back so far, unlike the stats never reset, a change means new timings
+		size_t GetResolvedFrames() const;
+		size_t GetDroppedFrames() const;
+
+		void ResetStats();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Zone
+		{
+			std::string name;
+			std::string path;
+			uint32_t depth;
+			RollingStats gpu;
+			RollingStats cpu;
+		};
+
+		struct ZoneRecord
+		{
+			uint32_t zone;
+			uint32_t beginQuery;
+			uint32_t endQuery;
+			Clock::time_point cpuBegin;
+			Clock::time_point cpuEnd;
+		};
+
+		struct FrameSlot
+		{
+			std::vector<AutoRelease<GLuint>> queries;
+			uint32_t queryCount;
+			std::vector<ZoneRecord> records;
+			bool pending;
+		};
+
+		uint32_t NextQuery(FrameSlot& slot);
+		// @brief Adds the slot's timings to the zones if its queries are done, false without waiting otherwise
+		bool Resolve(const FrameSlot& slot);
+
+		std::array<FrameSlot, kFrameSlots> m_Slots;
+		size_t m_SlotIndex;
+		bool m_InFrame;
+		std::vector<size_t> m_OpenRecords;	// in the current slot, innermost last
+		std::vector<Zone> m_Zones;
+		StringMap<uint32_t> m_ZoneIndices;
+		size_t m_ResolvedFrames;
+		size_t m_DroppedFrames;
+	};
+
+}
@@ -0,0 +1,298 @@
+#include "LightClusters.h"
+
+#include "Math/Vector4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <utility>
+
+namespace {
+
+	// one step of an 8 bit render target
+	constexpr auto kLightCutoff = 1.0f / 256.0f;
+
+	struct ViewLight
+	{
+		Game::vec3 center;
+		float radius;
+		uint32_t index;
+	};
+
+	struct SliceLights
+	{
+		std::vector<Game::ClusterRange> clusters;	// offsets relative to the slice's first index
+		std::vector<uint32_t> lightIndices;
+		uint32_t droppedLights;
+	};
+
+	bool Touches(const Game::AABB& bounds, const ViewLight& light)
+	{
+		const auto dx = std::max({ bounds.min.x - light.center.x, 0.0f, light.center.x - bounds.max.x });
+		const auto dy = std::max({ bounds.min.y - light.center.y, 0.0f, light.center.y - bounds.max.y });
+		const auto dz = std::max({ bounds.min.z - light.center.z, 0.0f, light.center.z - bounds.max.z });
+
+		return dx * dx + dy * dy + dz * dz <= light.radius * light.radius;
+	}
+
+	Game::AABB TileBounds(const Game::ClusterGrid& grid, uint32_t x, uint32_t y, float nearDepth, float farDepth)
+	{
+		const auto halfWidth = grid.tanHalfFov * grid.aspectRatio;
+		const auto halfHeight = grid.tanHalfFov;
+		const auto left = (-1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(grid.width)) * halfWidth;
+		const auto right = (-1.0f + 2.0f * static_cast<float>(x + 1u) / static_cast<float>(grid.width)) * halfWidth;
+		const auto bottom = (-1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(grid.height)) * halfHeight;
+		const auto top = (-1.0f + 2.0f * static_cast<float>(y + 1u) / static_cast<float>(grid.height)) * halfHeight;
+
+		// the tile's sides are planes through the eye so every extreme lies on the near or far face
+		auto bounds = Game::AABB{};
+		for (const auto depth : { nearDepth, farDepth })
+		{
+			bounds.Grow(Game::vec3{ left * depth, bottom * depth, -depth });
+			bounds.Grow(Game::vec3{ right * depth, top * depth, -depth });
+		}
+
+		return bounds;
+	}
+
+	// @brief Half open range of the tiles along one axis whose extent overlaps [low, high], both ends of the extents grow with the tile
+	std::pair<uint32_t, uint32_t> TileRange(std::span<const float> tileMin, std::span<const float> tileMax, float low, float high)
+	{
+		const auto first = std::ranges::lower_bound(tileMax, low) - std::ranges::begin(tileMax);
+		const auto last = std::ranges::upper_bound(tileMin, high) - std::ranges::begin(tileMin);
+		return { static_cast<uint32_t>(first), static_cast<uint32_t>(last) };
+	}
+
+	SliceLights AssignSlice(const Game::ClusterGrid& grid, uint32_t z, std::span<const ViewLight> lights)
+	{
+		const auto nearDepth = grid.SliceDepth(z);
+		const auto farDepth = grid.SliceDepth(z + 1u);
+
+		auto tileBounds = std::vector<Game::AABB>{};
+		tileBounds.reserve(grid.width * grid.height);
+		for (auto y = 0u; y < grid.height; ++y)
+		{
+			for (auto x = 0u; x < grid.width; ++x)
+			{
+				tileBounds.push_back(TileBounds(grid, x, y, nearDepth, farDepth));
+			}
+		}
+
+		// a tile's x extent only depends on its column and its y extent on its row, the sphere test fails outside these ranges
+		const auto columns = std::span{ tileBounds }.first(grid.width);
+		const auto columnMin = columns | std::views::transform([](const auto& bounds) { return bounds.min.x; }) | std::ranges::to<std::vector>();
+		const auto columnMax = columns | std::views::transform([](const auto& bounds) { return bounds.max.x; }) | std::ranges::to<std::vector>();
+		auto rowMin = std::vector<float>{};
+		auto rowMax = std::vector<float>{};
+		for (auto y = 0u; y < grid.height; ++y)
+		{
+			rowMin.push_back(tileBounds[y * grid.width].min.y);
+			rowMax.push_back(tileBounds[y * grid.width].max.y);
+		}
+
+		auto slice = SliceLights{
+			.clusters = std::vector<Game::ClusterRange>(tileBounds.size(), { .offset = 0u, .count = 0u }),
+			.lightIndices = {},
+			.droppedLights = 0u
+		};
+
+		// tile and light of every assignment in light order, the lists are gathered per tile below
+		auto assignments = std::vector<std::pair<uint32_t, uint32_t>>{};
+		for (const auto& light : lights)
+		{
+			if (-light.center.z + light.radius < nearDepth || -light.center.z - light.radius > farDepth)
+			{
+				continue;
+			}
+
+			const auto [firstX, lastX] = TileRange(columnMin, columnMax, light.center.x - light.radius, light.center.x + light.radius);
+			const auto [firstY, lastY] = TileRange(rowMin, rowMax, light.center.y - light.radius, light.center.y + light.radius);
+
+			for (auto y = firstY; y < lastY; ++y)
+			{
+				for (auto x = firstX; x < lastX; ++x)
+				{
+					const auto tile = x + (y * grid.width);
+					if (!Touches(tileBounds[tile], light))
+					{
+						continue;
+					}
+
+					auto& range = slice.clusters[tile];
+					if (range.count == Game::kMaxLightsPerCluster)
+					{
+						++slice.droppedLights;
+						continue;
+					}
+
+					++range.count;
+					assignments.emplace_back(tile, light.index);
+				}
+			}
+		}
+
+		// a stable counting sort by tile keeps every list in light order
+		auto offset = 0u;
+		for (auto& range : slice.clusters)
+		{
+			range.offset = offset;
+			offset += range.count;
+		}
+
+		auto next = slice.clusters | std::views::transform(&Game::ClusterRange::offset) | std::ranges::to<std::vector>();
+		slice.lightIndices.resize(offset);
+		for (const auto [tile, light] : assignments)
+		{
+			slice.lightIndices[next[tile]++] = light;
+		}
+
+		return slice;
+	}
+
+}
+
+namespace Game {
+
+	ClusterGrid ClusterGrid::FromCamera(const Camera& camera)
+	{
+		return {
+			.width = kClusterGridWidth,
+			.height = kClusterGridHeight,
+			.depth = kClusterGridDepth,
+			.nearPlane = camera.GetNearPlane(),
+			.farPlane = camera.GetFarPlane(),
+			.tanHalfFov = std::tan(camera.GetFOV() / 2.0f),
+			.aspectRatio = camera.GetWidth() / camera.GetHeight()
+		};
+	}
+
+	uint32_t ClusterGrid::ClusterCount() const
+	{
+		return width * height * depth;
+	}
+
+	uint32_t ClusterGrid::ClusterIndex(uint32_t x, uint32_t y, uint32_t z) const
+	{
+		return x + (y * width) + (z * width * height);
+	}
+
+	float ClusterGrid::SliceDepth(uint32_t z) const
+	{
+		return nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / static_cast<float>(depth));
+	}
+
+	float ClusterGrid::SliceScale() const
+	{
+		return static_cast<float>(depth) / std::log(farPlane / nearPlane);
+	}
+
+	AABB ClusterGrid::Bounds(uint32_t x, uint32_t y, uint32_t z) const
+	{
+		return TileBounds(*this, x, y, SliceDepth(z), SliceDepth(z + 1u));
+	}
+
+	std::vector<AABB> ClusterGrid::Bounds() const
+	{
+		auto bounds = std::vector<AABB>{};
+		bounds.reserve(ClusterCount());
+
+		for (auto z = 0u; z < depth; ++z)
+		{
+			const auto nearDepth = SliceDepth(z);
+			const auto farDepth = SliceDepth(z + 1u);
+			for (auto y = 0u; y < height; ++y)
+			{
+				for (auto x = 0u; x < width; ++x)
+				{
+					bounds.push_back(TileBounds(*this, x, y, nearDepth, farDepth));
+				}
+			}
+		}
+
+		return bounds;
+	}
+
+	std::string ClusterStats::to_string() const
+	{
+		return std::format(
+			"{} lights in {} clusters, {} assignments, at most {} per cluster, {} dropped",
+			lightCount,
+			occupiedClusters,
+			lightIndexCount,
+			maxClusterLights,
+			droppedLights);
+	}
+
+	float LightRadius(const PointLight& light)
+	{
+		// solves constant + linear * d + quadratic * d^2 = brightest / cutoff for the attenuation in light_pass.frag
+		const auto brightest = std::max({ light.color.r, light.color.g, light.color.b });
+		const auto a = light.quadraticAttenuation;
+		const auto b = light.linearAttenuation;
+		const auto c = light.constantAttenuation - brightest / kLightCutoff;
+
+		if (c >= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		if (a > 0.0f)
+		{
+			return (-b + std::sqrt(b * b - 4.0f * a * c)) / (2.0f * a);
+		}
+
+		return b > 0.0f ? -c / b : std::numeric_limits<float>::max();
+	}
+
+	ClusterStats AssignLights(const ClusterGrid& grid, const mat4& view, std::span<const PointLight> lights, ClusterLights& result)
+	{
+		const auto viewLights = lights |
+			std::views::enumerate |
+			std::views::transform([&](const auto& entry)
+								  {
+									  const auto& [index, light] = entry;
+									  return ViewLight{
+										  .center = static_cast<vec3>(view * vec4{ light.position, 1.0f }),
+										  .radius = LightRadius(light),
+										  .index = static_cast<uint32_t>(index)
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+
+		// slices are independent, concatenating them in order keeps the result the same however they were scheduled
+		auto slices = std::vector<SliceLights>(grid.depth);
+		auto tasks = std::vector<uint32_t>(grid.depth);
+		std::iota(std::ranges::begin(tasks), std::ranges::end(tasks), 0u);
+		std::for_each(std::execution::par, std::ranges::begin(tasks), std::ranges::end(tasks), [&](auto z)
+			{
+				slices[z] = AssignSlice(grid, z, viewLights);
+			});
+
+		result.clusters.clear();
+		result.lightIndices.clear();
+		auto stats = ClusterStats{ .lightCount = static_cast<uint32_t>(lights.size()), .lightIndexCount = 0u, .occupiedClusters = 0u, .maxClusterLights = 0u, .droppedLights = 0u };
+
+		for (const auto& slice : slices)
+		{
+			const auto first = static_cast<uint32_t>(result.lightIndices.size());
+			for (const auto& cluster : slice.clusters)
+			{
+				result.clusters.push_back({ .offset = first + cluster.offset, .count = cluster.count });
+				stats.occupiedClusters += cluster.count > 0u ? 1u : 0u;
+				stats.maxClusterLights = std::max(stats.maxClusterLights, cluster.count);
+			}
+
+			result.lightIndices.insert(std::ranges::end(result.lightIndices), std::ranges::begin(slice.lightIndices), std::ranges::end(slice.lightIndices));
+			stats.droppedLights += slice.droppedLights;
+		}
+
+		stats.lightIndexCount = static_cast<uint32_t>(result.lightIndices.size());
+
+		return stats;
+	}
+
+}
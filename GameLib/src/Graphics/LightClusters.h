@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Core/Camera.h"
+#include "Math/AABB.h"
+#include "Math/Matrix4.h"
+#include "Color.h"
+#include "PointLight.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Game {
+
+	constexpr auto kClusterGridWidth = 16u;
+	constexpr auto kClusterGridHeight = 9u;
+	constexpr auto kClusterGridDepth = 24u;
+	constexpr auto kClusterCount = kClusterGridWidth * kClusterGridHeight * kClusterGridDepth;
+
+	// must match MAX_LIGHTS_PER_CLUSTER in light_cluster.comp, lights past it are dropped from a cluster
+	constexpr auto kMaxLightsPerCluster = 128u;
+
+	// @brief std430 header of the light buffer read by light_pass.frag and light_cluster.comp, the point lights follow it
+	struct LightHeader
+	{
+		Color ambient;
+		uint32_t lightCount;
+	};
+
+	static_assert(sizeof(LightHeader) == 16zu);
+
+	// @brief Froxel grid over the camera's view frustum, screen space tiles split into depth slices spaced exponentially from
+	// the near to the far plane. Tile y grows upwards like gl_FragCoord, the light pass locates its cluster from the same values.
+	struct ClusterGrid
+	{
+		static ClusterGrid FromCamera(const Camera& camera);
+
+		uint32_t ClusterCount() const;
+		uint32_t ClusterIndex(uint32_t x, uint32_t y, uint32_t z) const;
+		// @brief Depth is the distance along the view direction
+		float SliceDepth(uint32_t z) const;
+		// @brief Slices per unit of log depth, the slice at depth d is log(d / nearPlane) * SliceScale()
+		float SliceScale() const;
+		// @brief View space bounds, the camera looks down -z
+		AABB Bounds(uint32_t x, uint32_t y, uint32_t z) const;
+		std::vector<AABB> Bounds() const;
+
+		uint32_t width;
+		uint32_t height;
+		uint32_t depth;
+		float nearPlane;
+		float farPlane;
+		float tanHalfFov;
+		float aspectRatio;
+
+		constexpr bool operator==(const ClusterGrid&) const = default;
+	};
+
+	// @brief std430 uvec2 read by the light pass, the cluster's lights are lightIndices[offset, offset + count)
+	struct ClusterRange
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	struct ClusterLights
+	{
+		std::vector<ClusterRange> clusters;
+		std::vector<uint32_t> lightIndices;
+	};
+
+	struct ClusterStats
+	{
+		uint32_t lightCount;
+		uint32_t lightIndexCount;
+		uint32_t occupiedClusters;
+		uint32_t maxClusterLights;
+		uint32_t droppedLights;		// assignments past kMaxLightsPerCluster
+
+		std::string to_string() const;
+	};
+
+	// @brief Distance at which the light's contribution drops below what an 8 bit target can show
+	float LightRadius(const PointLight& light);
+
+	// @brief CPU reference of light_cluster.comp, depth slices are assigned in parallel. Every cluster lists the lights whose
+	// sphere of influence touches it in light order. The GPU writes the same lists up to rounding of lights grazing a cluster,
+	// only the offsets differ as it gives every cluster a fixed range of kMaxLightsPerCluster indices.
+	ClusterStats AssignLights(const ClusterGrid& grid, const mat4& view, std::span<const PointLight> lights, ClusterLights& result);
+
+}
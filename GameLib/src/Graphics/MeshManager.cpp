@@ -1,59 +1,436 @@
 #include "MeshManager.h"
 
 #include "Utils.h"
+#include "Utils/Error.h"
 
+#include <algorithm>
+#include <execution>
 #include <ranges>
+#include <utility>
+
+namespace {
+
+	struct Range
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	// @brief Allocates size elements from the pool, growing the pool and its CPU copy when nothing fits
+	template<class T>
+	uint32_t Allocate(std::vector<T>& cpuBuffer, Game::RangeAllocator& allocator, uint32_t size)
+	{
+		if (size == 0u)
+		{
+			return 0u;
+		}
+
+		if (const auto offset = allocator.Allocate(size); offset)
+		{
+			return *offset;
+		}
+
+		const auto capacity = static_cast<uint32_t>(cpuBuffer.size());
+		const auto newCapacity = std::max(capacity * 2u, capacity + size);
+		cpuBuffer.resize(newCapacity);
+		allocator.Grow(newCapacity);
+
+		const auto offset = allocator.Allocate(size);
+		Game::Expect(offset.has_value(), "Pool of {} elements cannot fit {} after growing", newCapacity, size);
+
+		return *offset;
+	}
+
+	// @brief Uploads the written ranges, growing the GPU buffer carries everything already uploaded over on the GPU.
+	// Adjacent ranges are merged so a batch of appended meshes becomes a single write.
+	template<class T>
+	size_t Upload(const std::vector<T>& cpuBuffer, Game::Buffer& gpuBuffer, std::vector<Range> ranges, size_t& uploadCount)
+	{
+		Game::ResizeGPUBuffer(cpuBuffer, gpuBuffer);
+
+		std::erase_if(ranges, [](const auto& range) { return range.size == 0u; });
+		std::ranges::sort(ranges, {}, &Range::offset);
+
+		auto merged = std::vector<Range>{};
+		for (const auto& range : ranges)
+		{
+			if (!merged.empty() && merged.back().offset + merged.back().size == range.offset)
+			{
+				merged.back().size += range.size;
+			}
+			else
+			{
+				merged.push_back(range);
+			}
+		}
+
+		auto bytes = 0zu;
+		for (const auto& range : merged)
+		{
+			const auto data = std::span{ cpuBuffer }.subspan(range.offset, range.size);
+			gpuBuffer.Write(std::as_bytes(data), range.offset * sizeof(T));
+			bytes += data.size_bytes();
+			++uploadCount;
+		}
+
+		return bytes;
+	}
+
+	// @brief Moves the highest ranges of one pool into the lowest holes that fit below them, only meshes accepted by inPool live in the pool
+	template<class T, class P>
+	size_t Compact(
+		std::vector<T>& cpuBuffer,
+		const Game::Buffer& gpuBuffer,
+		Game::RangeAllocator& allocator,
+		std::span<std::optional<Game::MeshView>> meshes,
+		P&& inPool,
+		uint32_t Game::MeshView::* offsetMember,
+		uint32_t Game::MeshView::* countMember,
+		size_t maxBytes)
+	{
+		if (!allocator.HasHoles())
+		{
+			return 0zu;
+		}
+
+		auto candidates = meshes |
+			std::views::filter([&](const auto& mesh) { return mesh && inPool(*mesh) && (*mesh).*countMember > 0u; }) |
+			std::views::transform([](auto& mesh) { return &*mesh; }) |
+			std::ranges::to<std::vector>();
+		std::ranges::sort(candidates, std::ranges::greater{}, [&](const auto* mesh) { return mesh->*offsetMember; });
+
+		auto moved = 0zu;
+		for (auto* candidate : candidates)
+		{
+			const auto offset = candidate->*offsetMember;
+			const auto size = candidate->*countMember;
+			if (moved + size * sizeof(T) > maxBytes)
+			{
+				break;
+			}
+
+			const auto target = allocator.AllocateBelow(size, offset);
+			if (!target)
+			{
+				continue;
+			}
+
+			gpuBuffer.Copy(offset * sizeof(T), *target * sizeof(T), size * sizeof(T));
+			std::ranges::copy_n(std::ranges::begin(cpuBuffer) + offset, size, std::ranges::begin(cpuBuffer) + *target);
+			allocator.Free(offset, size);
+
+			candidate->*offsetMember = *target;
+			moved += size * sizeof(T);
+		}
+
+		return moved;
+	}
+
+	Game::BVH BuildMeshBVH(const Game::MeshData& meshData)
+	{
+		const auto positions = meshData.vertices |
+			std::views::transform([](const auto& vertex) { return vertex.position; }) |
+			std::ranges::to<std::vector>();
+
+		return { positions, meshData.indices };
+	}
+
+}
 
 namespace Game {
 
-	MeshManager::MeshManager()
-		: m_VertexDataCPU{}
+	template<class F>
+	decltype(auto) MeshManager::WithVertexPool(F&& func)
+	{
+		if (m_VertexFormat == VertexFormat::PACKED)
+		{
+			return func(m_PackedVertexDataCPU);
+		}
+
+		return func(m_VertexDataCPU);
+	}
+
+	template<class F>
+	decltype(auto) MeshManager::WithIndexPool(IndexType indexType, F&& func)
+	{
+		if (indexType == IndexType::UINT16)
+		{
+			return func(m_ShortIndexDataCPU, m_ShortIndexDataGPU, m_ShortIndexAllocator);
+		}
+
+		return func(m_IndexDataCPU, m_IndexDataGPU, m_IndexAllocator);
+	}
+
+	MeshManager::MeshManager(VertexFormat vertexFormat)
+		: m_VertexFormat{ vertexFormat }
+		, m_VertexDataCPU{}
+		, m_PackedVertexDataCPU{}
 		, m_IndexDataCPU{}
-		, m_VertexDataGPU{ sizeof(VertexData), "vertex_mesh_data" }
+		, m_ShortIndexDataCPU{}
+		, m_VertexDataGPU{ VertexSize(vertexFormat), "vertex_mesh_data" }
 		, m_IndexDataGPU{ sizeof(uint32_t), "index_mesh_data" }
+		, m_ShortIndexDataGPU{ sizeof(uint16_t), "short_index_mesh_data" }
+		, m_VertexAllocator{}
+		, m_IndexAllocator{}
+		, m_ShortIndexAllocator{}
+		, m_Meshes{}
+		, m_FreeHandles{}
+		, m_Generations{}
+		, m_BVHs{}
+		, m_VertexBytesUploaded{}
+		, m_IndexBytesUploaded{}
+		, m_UploadCount{}
+		, m_BytesRelocated{}
 	{}
 
 	MeshView MeshManager::Load(const MeshData& meshData)
 	{
-		const auto vertexOffset = m_VertexDataCPU.size();
-		const auto indexOffset = m_IndexDataCPU.size();
+		return LoadAll({ &meshData, 1zu }).front();
+	}
+
+	std::vector<MeshView> MeshManager::LoadAll(std::span<const MeshData> meshData)
+	{
+		const auto vertexCount = std::ranges::fold_left(meshData | std::views::transform([](const auto& m) { return m.vertices.size(); }), 0zu, std::plus{});
+
+		// indices are relative to the mesh's base vertex, so any mesh addressing at most 2^16 vertices fits the short pool
+		size_t indexCounts[kIndexTypeCount] = {};
+		for (const auto& mesh : meshData)
+		{
+			indexCounts[std::to_underlying(IndexTypeFor(mesh.vertices.size()))] += mesh.indices.size();
+		}
+
+		// grow once up front when the free space cannot hold the batch, fragmentation may still force another growth
+		if (const auto stats = m_VertexAllocator.GetStats(); stats.capacity - stats.used < vertexCount)
+		{
+			WithVertexPool([&](auto& pool)
+				{
+					pool.resize(pool.size() + vertexCount);
+					m_VertexAllocator.Grow(static_cast<uint32_t>(pool.size()));
+				});
+		}
+
+		for (const auto [type, indexCount] : indexCounts | std::views::enumerate)
+		{
+			WithIndexPool(static_cast<IndexType>(type), [&](auto& pool, auto&, auto& allocator)
+				{
+					if (const auto stats = allocator.GetStats(); stats.capacity - stats.used < indexCount)
+					{
+						pool.resize(pool.size() + indexCount);
+						allocator.Grow(static_cast<uint32_t>(pool.size()));
+					}
+				});
+		}
+
+		auto views = std::vector<MeshView>{};
+		views.reserve(meshData.size());
 
-		m_VertexDataCPU.append_range(meshData.vertices);
-		ResizeGPUBuffer(m_VertexDataCPU, m_VertexDataGPU);
-		const auto vertexDataView = DataBufferView{ reinterpret_cast<const std::byte*>(m_VertexDataCPU.data()), m_VertexDataCPU.size() * sizeof(VertexData) };
-		m_VertexDataGPU.Write(vertexDataView, 0u);
+		auto vertexRanges = std::vector<Range>{};
+		std::vector<Range> indexRanges[kIndexTypeCount] = {};
 
-		m_IndexDataCPU.append_range(meshData.indices);
-		ResizeGPUBuffer(m_IndexDataCPU, m_IndexDataGPU);
-		const auto indexDataView = DataBufferView{ reinterpret_cast<const std::byte*>(m_IndexDataCPU.data()), m_IndexDataCPU.size() * sizeof(uint32_t) };
-		m_IndexDataGPU.Write(indexDataView, 0u);
+		for (const auto& mesh : meshData)
+		{
+			const auto meshVertexCount = static_cast<uint32_t>(mesh.vertices.size());
+			const auto meshIndexCount = static_cast<uint32_t>(mesh.indices.size());
+			const auto vertexOffset = WithVertexPool([&](auto& pool) { return Allocate(pool, m_VertexAllocator, meshVertexCount); });
+			const auto indexType = IndexTypeFor(mesh.vertices.size());
+			const auto indexOffset = WithIndexPool(indexType, [&](auto& pool, auto&, auto& allocator)
+				{
+					using Index = std::ranges::range_value_t<decltype(pool)>;
 
-		return {
-			.indexOffset = static_cast<uint32_t>(indexOffset),
-			.indexCount = static_cast<uint32_t>(meshData.indices.size()),
-			.vertexOffset = static_cast<uint32_t>(vertexOffset),
-			.vertexCount = static_cast<uint32_t>(meshData.vertices.size()),
-		};
+					const auto offset = Allocate(pool, allocator, meshIndexCount);
+					std::ranges::transform(mesh.indices, std::ranges::begin(pool) + offset, [](auto index) { return static_cast<Index>(index); });
+					return offset;
+				});
+
+			const auto bounds = Bounds(mesh.vertices);
+			auto quantization = PositionQuantization::Identity();
+			if (m_VertexFormat == VertexFormat::PACKED)
+			{
+				quantization = PositionQuantization::FromBounds(bounds);
+				std::ranges::transform(mesh.vertices, std::ranges::begin(m_PackedVertexDataCPU) + vertexOffset, [&](const auto& vertex) { return Pack(vertex, quantization); });
+			}
+			else
+			{
+				std::ranges::copy(mesh.vertices, std::ranges::begin(m_VertexDataCPU) + vertexOffset);
+			}
+
+			vertexRanges.push_back({ .offset = vertexOffset, .size = meshVertexCount });
+			indexRanges[std::to_underlying(indexType)].push_back({ .offset = indexOffset, .size = meshIndexCount });
+
+			auto handle = MeshHandle{ static_cast<uint32_t>(m_Meshes.size()), 0u };
+			if (!m_FreeHandles.empty())
+			{
+				handle.index = m_FreeHandles.back();
+				handle.generation = m_Generations[handle.index];
+				m_FreeHandles.pop_back();
+			}
+			else
+			{
+				m_Meshes.emplace_back();
+				m_Generations.push_back(handle.generation);
+				m_BVHs.emplace_back();
+			}
+
+			const auto view = MeshView{
+				.indexType = indexType,
+				.indexOffset = indexOffset,
+				.indexCount = meshIndexCount,
+				.vertexOffset = vertexOffset,
+				.vertexCount = meshVertexCount,
+				.handle = handle,
+				.quantization = quantization,
+				.bounds = bounds
+			};
+			m_Meshes[handle.index] = view;
+			views.push_back(view);
+		}
+
+		m_VertexBytesUploaded += WithVertexPool([&](const auto& pool) { return Upload(pool, m_VertexDataGPU, std::move(vertexRanges), m_UploadCount); });
+		for (auto&& [type, ranges] : indexRanges | std::views::enumerate)
+		{
+			m_IndexBytesUploaded += WithIndexPool(static_cast<IndexType>(type), [&](const auto& pool, auto& buffer, auto&) { return Upload(pool, buffer, std::move(ranges), m_UploadCount); });
+		}
+
+		auto bvhs = std::vector<BVH>(meshData.size());
+		std::transform(std::execution::par, std::ranges::begin(meshData), std::ranges::end(meshData), std::ranges::begin(bvhs), BuildMeshBVH);
+		for (auto&& [view, bvh] : std::views::zip(views, bvhs))
+		{
+			m_BVHs[view.handle.index] = std::move(bvh);
+		}
+
+		return views;
 	}
 
-	std::tuple<GLuint, GLuint> MeshManager::GetNativeHandle() const
+	void MeshManager::Unload(MeshView view)
 	{
-		return { m_VertexDataGPU.GetNativeHandle(), m_IndexDataGPU.GetNativeHandle() };
+		const auto index = view.handle.index;
+		Expect(IsLoaded(view.handle), "Mesh {} generation {} is not loaded", index, view.handle.generation);
+
+		// the caller's copy may predate a relocation, free what the mesh occupies now
+		const auto& current = *m_Meshes[index];
+		if (current.vertexCount > 0u)
+		{
+			m_VertexAllocator.Free(current.vertexOffset, current.vertexCount);
+		}
+
+		if (current.indexCount > 0u)
+		{
+			WithIndexPool(current.indexType, [&](auto&, auto&, auto& allocator) { allocator.Free(current.indexOffset, current.indexCount); });
+		}
+
+		m_Meshes[index].reset();
+		m_BVHs[index] = {};
+		++m_Generations[index];
+		m_FreeHandles.push_back(index);
 	}
 
-	std::span<uint32_t> MeshManager::GetIndexData(MeshView view)
+	size_t MeshManager::Defragment(size_t maxBytes)
 	{
+		auto moved = WithVertexPool([&](auto& pool)
+			{
+				return Compact(pool, m_VertexDataGPU, m_VertexAllocator, m_Meshes, [](const auto&) { return true; }, &MeshView::vertexOffset, &MeshView::vertexCount, maxBytes);
+			});
+
+		for (const auto type : { IndexType::UINT16, IndexType::UINT32 })
+		{
+			moved += WithIndexPool(type, [&](auto& pool, const auto& buffer, auto& allocator)
+				{
+					const auto inPool = [type](const auto& view) { return view.indexType == type; };
+					return Compact(pool, buffer, allocator, m_Meshes, inPool, &MeshView::indexOffset, &MeshView::indexCount, maxBytes - moved);
+				});
+		}
+
+		m_BytesRelocated += moved;
+
+		return moved;
+	}
+
+	std::tuple<GLuint, GLuint> MeshManager::GetNativeHandle(IndexType indexType) const
+	{
+		const auto& indexBuffer = indexType == IndexType::UINT16 ? m_ShortIndexDataGPU : m_IndexDataGPU;
+		return { m_VertexDataGPU.GetNativeHandle(), indexBuffer.GetNativeHandle() };
+	}
+
+	MeshView MeshManager::GetView(MeshHandle handle) const
+	{
+		Expect(IsLoaded(handle), "Mesh {} generation {} is not loaded", handle.index, handle.generation);
+		return *m_Meshes[handle.index];
+	}
+
+	std::span<uint32_t> MeshManager::GetIndexData(MeshHandle handle)
+	{
+		const auto view = GetView(handle);
+		Expect(view.indexType == IndexType::UINT32, "Mesh {} uses {} indices, not UINT32", handle.index, view.indexType);
 		return { m_IndexDataCPU.data() + view.indexOffset, view.indexCount };
 	}
 
-	std::span<VertexData> MeshManager::GetVertexData(MeshView view)
+	std::span<uint16_t> MeshManager::GetShortIndexData(MeshHandle handle)
+	{
+		const auto view = GetView(handle);
+		Expect(view.indexType == IndexType::UINT16, "Mesh {} uses {} indices, not UINT16", handle.index, view.indexType);
+		return { m_ShortIndexDataCPU.data() + view.indexOffset, view.indexCount };
+	}
+
+	std::span<VertexData> MeshManager::GetVertexData(MeshHandle handle)
 	{
+		Expect(m_VertexFormat == VertexFormat::FULL, "Vertex pool is {}, not FULL", m_VertexFormat);
+		const auto view = GetView(handle);
 		return { m_VertexDataCPU.data() + view.vertexOffset, view.vertexCount };
 	}
 
+	std::span<PackedVertexData> MeshManager::GetPackedVertexData(MeshHandle handle)
+	{
+		Expect(m_VertexFormat == VertexFormat::PACKED, "Vertex pool is {}, not PACKED", m_VertexFormat);
+		const auto view = GetView(handle);
+		return { m_PackedVertexDataCPU.data() + view.vertexOffset, view.vertexCount };
+	}
+
+	const BVH& MeshManager::GetBVH(MeshHandle handle) const
+	{
+		Expect(IsLoaded(handle), "Mesh {} generation {} is not loaded", handle.index, handle.generation);
+		return m_BVHs[handle.index];
+	}
+
+	bool MeshManager::IsLoaded(MeshHandle handle) const
+	{
+		return handle.index < m_Meshes.size() && m_Meshes[handle.index] && m_Generations[handle.index] == handle.generation;
+	}
+
+	VertexFormat MeshManager::GetVertexFormat() const
+	{
+		return m_VertexFormat;
+	}
+
+	RangeAllocatorStats MeshManager::GetVertexPoolStats() const
+	{
+		return m_VertexAllocator.GetStats();
+	}
+
+	RangeAllocatorStats MeshManager::GetIndexPoolStats(IndexType indexType) const
+	{
+		return indexType == IndexType::UINT16 ? m_ShortIndexAllocator.GetStats() : m_IndexAllocator.GetStats();
+	}
+
+	float MeshManager::GetFragmentation() const
+	{
+		return std::max({ m_VertexAllocator.GetStats().Fragmentation(), m_IndexAllocator.GetStats().Fragmentation(), m_ShortIndexAllocator.GetStats().Fragmentation() });
+	}
+
 	std::string MeshManager::to_string() const
 	{
-		return std::format("Mesh manager: vertex count {}, index count {}", m_VertexDataCPU.size(), m_IndexDataCPU.size());
+		return std::format(
+			"Mesh manager: {} meshes, {} vertices ({} bytes each), vertex pool {}, 32 bit index pool {}, 16 bit index pool {} (saving {} bytes), uploaded {} vertex bytes and {} index bytes in {} uploads, relocated {} bytes",
+			m_Meshes.size() - m_FreeHandles.size(),
+			m_VertexFormat,
+			VertexSize(m_VertexFormat),
+			m_VertexAllocator.GetStats(),
+			m_IndexAllocator.GetStats(),
+			m_ShortIndexAllocator.GetStats(),
+			m_ShortIndexAllocator.GetStats().used * (sizeof(uint32_t) - sizeof(uint16_t)),
+			m_VertexBytesUploaded,
+			m_IndexBytesUploaded,
+			m_UploadCount,
+			m_BytesRelocated);
 	}
 
 }
@@ -4,7 +4,10 @@
 #include "MeshView.h"
 #include "VertexData.h"
 #include "MeshData.h"
+#include "Math/BVH.h"
+#include "Utils/RangeAllocator.h"
 
+#include <optional>
 #include <vector>
 #include <span>
 #include <string>
@@ -14,22 +17,70 @@ namespace Game {
 	class MeshManager
 	{
 	public:
-		MeshManager();
+		explicit MeshManager(VertexFormat vertexFormat = VertexFormat::FULL);
 
 		MeshView Load(const MeshData& meshData);
 
-		std::tuple<GLuint, GLuint> GetNativeHandle() const;
+		// @brief Loads several meshes with a single reserve, at most one buffer growth and one upload per buffer
+		std::vector<MeshView> LoadAll(std::span<const MeshData> meshData);
 
-		std::span<uint32_t> GetIndexData(MeshView view);
-		std::span<VertexData> GetVertexData(MeshView view);
+		// @brief Returns the mesh's vertex and index ranges to the pools, its handle may be reused by a later load
+		void Unload(MeshView view);
+
+		// @brief Moves live ranges into holes further down the pools, at most maxBytes per call.
+		// Views are patched in place so everything holding a MeshHandle picks up the new location.
+		size_t Defragment(size_t maxBytes);
+
+		// @brief Vertex pool and the index pool of indexType
+		std::tuple<GLuint, GLuint> GetNativeHandle(IndexType indexType) const;
+
+		MeshView GetView(MeshHandle handle) const;
+		// @brief Indices as stored in the pool, only the accessor matching the mesh's index type may be used
+		std::span<uint32_t> GetIndexData(MeshHandle handle);
+		std::span<uint16_t> GetShortIndexData(MeshHandle handle);
+		// @brief Vertices as stored in the pool, only the accessor matching the vertex format may be used
+		std::span<VertexData> GetVertexData(MeshHandle handle);
+		std::span<PackedVertexData> GetPackedVertexData(MeshHandle handle);
+		const BVH& GetBVH(MeshHandle handle) const;
+		// @brief False once the mesh was unloaded, even if a later load reused its index
+		bool IsLoaded(MeshHandle handle) const;
+
+		VertexFormat GetVertexFormat() const;
+		RangeAllocatorStats GetVertexPoolStats() const;
+		RangeAllocatorStats GetIndexPoolStats(IndexType indexType) const;
+		// @brief Fragmentation of the worst pool, Defragment only has work when it is above 0
+		float GetFragmentation() const;
 
 		std::string to_string() const;
 
 	private:
+		// @brief Calls func with the CPU copy of the vertex pool in the active format
+		template<class F>
+		decltype(auto) WithVertexPool(F&& func);
+
+		// @brief Calls func with the CPU copy, GPU buffer and allocator of the index pool of indexType
+		template<class F>
+		decltype(auto) WithIndexPool(IndexType indexType, F&& func);
+
+		VertexFormat m_VertexFormat;
 		std::vector<VertexData> m_VertexDataCPU;
+		std::vector<PackedVertexData> m_PackedVertexDataCPU;
 		std::vector<uint32_t> m_IndexDataCPU;
+		std::vector<uint16_t> m_ShortIndexDataCPU;
 		Buffer m_VertexDataGPU;
 		Buffer m_IndexDataGPU;
+		Buffer m_ShortIndexDataGPU;
+		RangeAllocator m_VertexAllocator;
+		RangeAllocator m_IndexAllocator;
+		RangeAllocator m_ShortIndexAllocator;
+		std::vector<std::optional<MeshView>> m_Meshes;
+		std::vector<uint32_t> m_FreeHandles;
+		std::vector<uint32_t> m_Generations;	// of each index, the one handles to the mesh loaded there carry
+		std::vector<BVH> m_BVHs;
+		size_t m_VertexBytesUploaded;
+		size_t m_IndexBytesUploaded;
+		size_t m_UploadCount;
+		size_t m_BytesRelocated;
 	};
 
 }
@@ -0,0 +1,563 @@
+#include "MeshOptimizer.h"
+
+#include "Math/Vector3.h"
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <execution>
+#include <format>
+#include <numeric>
+#include <ranges>
+#include <unordered_map>
+
+namespace {
+
+	constexpr auto kNoVertex = ~0u;
+
+	// @brief FIFO cache simulated with insertion timestamps, a vertex is cached while fewer than cacheSize vertices were inserted after it
+	class VertexCache
+	{
+	public:
+		VertexCache(uint32_t vertexCount, uint32_t cacheSize)
+			: m_InsertionTime(vertexCount, 0u)
+			, m_Time{ cacheSize + 1u }
+			, m_CacheSize{ cacheSize }
+		{}
+
+		// @brief Returns true on a miss, inserting the vertex
+		bool Access(uint32_t vertex)
+		{
+			if (Contains(vertex))
+			{
+				return false;
+			}
+
+			m_InsertionTime[vertex] = m_Time++;
+			return true;
+		}
+
+		// @brief Evicts everything by advancing time past the cache size
+		void Flush()
+		{
+			m_Time += m_CacheSize + 1u;
+		}
+
+		bool Contains(uint32_t vertex) const
+		{
+			return Age(vertex) <= m_CacheSize;
+		}
+
+		// @brief Number of insertions since the vertex entered the cache
+		uint32_t Age(uint32_t vertex) const
+		{
+			return m_Time - m_InsertionTime[vertex];
+		}
+
+	private:
+		std::vector<uint32_t> m_InsertionTime;
+		uint32_t m_Time;
+		uint32_t m_CacheSize;
+	};
+
+	// @brief Triangles using each vertex, compressed so the triangles of vertex v are [offsets[v], offsets[v + 1])
+	struct TriangleAdjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+
+	TriangleAdjacency BuildAdjacency(std::span<const uint32_t> indices, uint32_t vertexCount)
+	{
+		auto adjacency = TriangleAdjacency{ .offsets = std::vector<uint32_t>(vertexCount + 1u, 0u), .triangles = std::vector<uint32_t>(indices.size()) };
+
+		for (const auto index : indices)
+		{
+			Game::Expect(index < vertexCount, "Index {} out of range of {} vertices", index, vertexCount);
+			++adjacency.offsets[index + 1u];
+		}
+
+		std::partial_sum(std::ranges::begin(adjacency.offsets), std::ranges::end(adjacency.offsets), std::ranges::begin(adjacency.offsets));
+
+		auto cursor = adjacency.offsets;
+		for (auto index = 0zu; index < indices.size(); ++index)
+		{
+			adjacency.triangles[cursor[indices[index]]++] = static_cast<uint32_t>(index / 3zu);
+		}
+
+		return adjacency;
+	}
+
+	using WeldCell = std::array<int64_t, 3>;
+
+	struct WeldCellHash
+	{
+		size_t operator()(const WeldCell& cell) const
+		{
+			auto hash = 0zu;
+			for (const auto coordinate : cell)
+			{
+				hash = (hash ^ std::hash<int64_t>{}(coordinate)) * 0x100000001b3zu;
+			}
+
+			return hash;
+		}
+	};
+
+	// @brief Grid cell of a coordinate, exact bits when welding without tolerance
+	int64_t WeldCoordinate(float value, float tolerance)
+	{
+		if (tolerance <= 0.0f)
+		{
+			return std::bit_cast<int32_t>(value);
+		}
+
+		constexpr auto kLimit = static_cast<double>(1ll << 62);
+		return static_cast<int64_t>(std::clamp(std::floor(static_cast<double>(value) / tolerance), -kLimit, kLimit));
+	}
+
+	// @brief Without tolerance only the same bits match, -0 and +0 compare equal but are not the same attribute
+	bool Within(float a, float b, float tolerance)
+	{
+		return tolerance <= 0.0f ? std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b) : std::abs(a - b) <= tolerance;
+	}
+
+	bool Within(const Game::vec3& a, const Game::vec3& b, float tolerance)
+	{
+		return Within(a.x, b.x, tolerance) && Within(a.y, b.y, tolerance) && Within(a.z, b.z, tolerance);
+	}
+
+	bool Within(const Game::VertexData& a, const Game::VertexData& b, const Game::WeldTolerance& tolerance)
+	{
+		return Within(a.position, b.position, tolerance.position) &&
+			   Within(a.normal, b.normal, tolerance.normal) &&
+			   Within(a.tangent, b.tangent, tolerance.tangent) &&
+			   Within(a.bitangent, b.bitangent, tolerance.bitangent) &&
+			   Within(a.uv.s, b.uv.s, tolerance.uv) &&
+			   Within(a.uv.t, b.uv.t, tolerance.uv);
+	}
+
+	struct Cluster
+	{
+		uint32_t firstTriangle;
+		uint32_t triangleCount;
+		float sortKey;
+	};
+
+}
+
+namespace Game {
+
+	float VertexCacheStats::ACMR() const
+	{
+		return triangleCount == 0u ? 0.0f : static_cast<float>(transformedVertices) / static_cast<float>(triangleCount);
+	}
+
+	float VertexCacheStats::ATVR() const
+	{
+		return referencedVertices == 0u ? 0.0f : static_cast<float>(transformedVertices) / static_cast<float>(referencedVertices);
+	}
+
+	VertexCacheStats& VertexCacheStats::operator+=(const VertexCacheStats& other)
+	{
+		transformedVertices += other.transformedVertices;
+		triangleCount += other.triangleCount;
+		referencedVertices += other.referencedVertices;
+
+		return *this;
+	}
+
+	std::string VertexCacheStats::to_string() const
+	{
+		return std::format("ACMR {:.3f}, ATVR {:.3f} ({} triangles, {} vertices)", ACMR(), ATVR(), triangleCount, referencedVertices);
+	}
+
+	std::string MeshOptimizationStats::to_string() const
+	{
+		return std::format("before: {}, after: {}", before, after);
+	}
+
+	uint32_t WeldStats::Removed() const
+	{
+		return verticesBefore - verticesAfter;
+	}
+
+	WeldStats& WeldStats::operator+=(const WeldStats& other)
+	{
+		verticesBefore += other.verticesBefore;
+		verticesAfter += other.verticesAfter;
+
+		return *this;
+	}
+
+	std::string WeldStats::to_string() const
+	{
+		const auto percent = verticesBefore == 0u ? 0.0f : 100.0f * static_cast<float>(Removed()) / static_cast<float>(verticesBefore);
+		return std::format("{} -> {} vertices ({} removed, {:.1f}%)", verticesBefore, verticesAfter, Removed(), percent);
+	}
+
+	WeldStats WeldVertices(MeshData& mesh, const WeldTolerance& tolerance)
+	{
+		const auto cellOf = [&](const vec3& position)
+		{
+			return WeldCell{ WeldCoordinate(position.x, tolerance.position), WeldCoordinate(position.y, tolerance.position), WeldCoordinate(position.z, tolerance.position) };
+		};
+
+		// without tolerance equal positions share a cell, otherwise a match may sit in any neighbouring one
+		const auto reach = tolerance.position > 0.0f ? 1ll : 0ll;
+
+		auto cells = std::unordered_map<WeldCell, std::vector<uint32_t>, WeldCellHash>{};
+		auto remap = std::vector<uint32_t>(mesh.vertices.size());
+		auto vertices = std::vector<VertexData>{};
+
+		for (const auto& [index, vertex] : mesh.vertices | std::views::enumerate)
+		{
+			const auto cell = cellOf(vertex.position);
+
+			auto match = kNoVertex;
+			for (auto x = -reach; x <= reach; ++x)
+			{
+				for (auto y = -reach; y <= reach; ++y)
+				{
+					for (auto z = -reach; z <= reach; ++z)
+					{
+						const auto neighbour = cells.find({ cell[0] + x, cell[1] + y, cell[2] + z });
+						if (neighbour == std::ranges::end(cells))
+						{
+							continue;
+						}
+
+						// cells list their vertices in ascending order, nothing past the best match so far can win
+						for (const auto candidate : neighbour->second | std::views::take_while([&](auto c) { return c < match; }))
+						{
+							if (Within(vertex, vertices[candidate], tolerance))
+							{
+								match = candidate;
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			if (match == kNoVertex)
+			{
+				match = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(vertex);
+				cells[cell].push_back(match);
+			}
+
+			remap[index] = match;
+		}
+
+		for (auto& index : mesh.indices)
+		{
+			index = remap[index];
+		}
+
+		const auto stats = WeldStats{ .verticesBefore = static_cast<uint32_t>(mesh.vertices.size()), .verticesAfter = static_cast<uint32_t>(vertices.size()) };
+		mesh.vertices = std::move(vertices);
+
+		return stats;
+	}
+
+	std::vector<WeldStats> WeldMeshes(std::span<MeshData> meshes, const WeldTolerance& tolerance)
+	{
+		auto stats = std::vector<WeldStats>(meshes.size());
+		const auto tasks = std::views::iota(0zu, meshes.size()) | std::ranges::to<std::vector>();
+
+		std::for_each(std::execution::par, std::ranges::begin(tasks), std::ranges::end(tasks), [&](auto index)
+			{
+				stats[index] = WeldVertices(meshes[index], tolerance);
+			});
+
+		return stats;
+	}
+
+	VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		auto cache = VertexCache{ vertexCount, cacheSize };
+		auto referenced = std::vector<bool>(vertexCount, false);
+		auto stats = VertexCacheStats{ .transformedVertices = 0u, .triangleCount = static_cast<uint32_t>(indices.size() / 3zu), .referencedVertices = 0u };
+
+		for (const auto index : indices)
+		{
+			if (cache.Access(index))
+			{
+				++stats.transformedVertices;
+			}
+
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				++stats.referencedVertices;
+			}
+		}
+
+		return stats;
+	}
+
+	std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		Expect(indices.size() % 3zu == 0zu, "Index count {} is not a triangle list", indices.size());
+
+		const auto adjacency = BuildAdjacency(indices, vertexCount);
+
+		// triangles still to be emitted per vertex
+		auto live = std::vector<uint32_t>(vertexCount);
+		for (auto vertex = 0u; vertex < vertexCount; ++vertex)
+		{
+			live[vertex] = adjacency.offsets[vertex + 1u] - adjacency.offsets[vertex];
+		}
+
+		auto cache = VertexCache{ vertexCount, cacheSize };
+		auto emitted = std::vector<bool>(indices.size() / 3zu, false);
+		auto deadEnds = std::vector<uint32_t>{};
+		auto candidates = std::vector<uint32_t>{};
+		auto cursor = 0u;
+
+		auto result = std::vector<uint32_t>{};
+		result.reserve(indices.size());
+
+		const auto skipDeadEnd = [&]
+		{
+			while (!deadEnds.empty())
+			{
+				const auto vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (live[vertex] > 0u)
+				{
+					return vertex;
+				}
+			}
+
+			for (; cursor < vertexCount; ++cursor)
+			{
+				if (live[cursor] > 0u)
+				{
+					return cursor;
+				}
+			}
+
+			return kNoVertex;
+		};
+
+		auto fanning = skipDeadEnd();
+		while (fanning != kNoVertex)
+		{
+			candidates.clear();
+
+			const auto fanTriangles = std::span{ adjacency.triangles }.subspan(adjacency.offsets[fanning], adjacency.offsets[fanning + 1u] - adjacency.offsets[fanning]);
+			for (const auto triangle : fanTriangles)
+			{
+				if (emitted[triangle])
+				{
+					continue;
+				}
+
+				for (const auto vertex : indices.subspan(triangle * 3zu, 3zu))
+				{
+					result.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					--live[vertex];
+					cache.Access(vertex);
+				}
+
+				emitted[triangle] = true;
+			}
+
+			// prefer the oldest candidate that stays cached while its remaining triangles are emitted, ties keep the first one
+			auto next = kNoVertex;
+			auto bestPriority = -1ll;
+			for (const auto vertex : candidates)
+			{
+				if (live[vertex] == 0u)
+				{
+					continue;
+				}
+
+				auto priority = 0ll;
+				if (cache.Age(vertex) + 2u * live[vertex] <= cacheSize)
+				{
+					priority = cache.Age(vertex);
+				}
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+
+			fanning = next != kNoVertex ? next : skipDeadEnd();
+		}
+
+		return result;
+	}
+
+	std::vector<uint32_t> OptimizeOverdraw(std::span<const uint32_t> indices, std::span<const VertexData> vertices, float threshold, uint32_t cacheSize)
+	{
+		Expect(indices.size() % 3zu == 0zu, "Index count {} is not a triangle list", indices.size());
+
+		const auto vertexCount = static_cast<uint32_t>(vertices.size());
+		const auto triangleCount = static_cast<uint32_t>(indices.size() / 3zu);
+		const auto meshACMR = AnalyzeVertexCache(indices, vertexCount, cacheSize).ACMR();
+
+		// hard boundaries where the cache restarts (all three vertices missed) in the original order.
+		// Soft ones where the cluster, starting from an empty cache, is already as cache friendly as the mesh,
+		// since clusters get reordered this bounds the ACMR of the result by threshold times the input ACMR.
+		auto clusters = std::vector<Cluster>{};
+		auto sequenceCache = VertexCache{ vertexCount, cacheSize };
+		auto clusterCache = VertexCache{ vertexCount, cacheSize };
+		auto clusterMisses = 0u;
+		const auto startCluster = [&](uint32_t triangle)
+		{
+			clusters.push_back({ .firstTriangle = triangle, .triangleCount = 0u, .sortKey = 0.0f });
+			clusterCache.Flush();
+			clusterMisses = 0u;
+		};
+
+		for (auto triangle = 0u; triangle < triangleCount; ++triangle)
+		{
+			auto sequenceMisses = 0u;
+			for (const auto vertex : indices.subspan(triangle * 3zu, 3zu))
+			{
+				sequenceMisses += sequenceCache.Access(vertex) ? 1u : 0u;
+			}
+
+			if (clusters.empty() || (sequenceMisses == 3u && clusters.back().triangleCount > 0u))
+			{
+				startCluster(triangle);
+			}
+
+			for (const auto vertex : indices.subspan(triangle * 3zu, 3zu))
+			{
+				clusterMisses += clusterCache.Access(vertex) ? 1u : 0u;
+			}
+			++clusters.back().triangleCount;
+
+			if (static_cast<float>(clusterMisses) <= threshold * meshACMR * static_cast<float>(clusters.back().triangleCount) && triangle + 1u < triangleCount)
+			{
+				startCluster(triangle + 1u);
+			}
+		}
+
+		std::erase_if(clusters, [](const auto& cluster) { return cluster.triangleCount == 0u; });
+
+		// area weighted centroid and normal of each cluster
+		auto centroids = std::vector<vec3>(clusters.size());
+		auto normals = std::vector<vec3>(clusters.size());
+		auto areas = std::vector<float>(clusters.size());
+		auto meshCentroid = vec3{};
+		auto meshArea = 0.0f;
+
+		for (const auto& [index, cluster] : clusters | std::views::enumerate)
+		{
+			for (auto triangle = cluster.firstTriangle; triangle < cluster.firstTriangle + cluster.triangleCount; ++triangle)
+			{
+				const auto& p0 = vertices[indices[triangle * 3zu + 0zu]].position;
+				const auto& p1 = vertices[indices[triangle * 3zu + 1zu]].position;
+				const auto& p2 = vertices[indices[triangle * 3zu + 2zu]].position;
+
+				const auto normal = vec3::Cross(p1 - p0, p2 - p0);
+				const auto area = normal.Length();
+
+				centroids[index] += (p0 + p1 + p2) * vec3{ area / 3.0f };
+				normals[index] += normal;
+				areas[index] += area;
+			}
+
+			meshCentroid += centroids[index];
+			meshArea += areas[index];
+		}
+
+		if (meshArea > 0.0f)
+		{
+			meshCentroid /= vec3{ meshArea };
+		}
+
+		for (auto&& [index, cluster] : clusters | std::views::enumerate)
+		{
+			if (areas[index] > 0.0f)
+			{
+				cluster.sortKey = vec3::Dot(centroids[index] / vec3{ areas[index] } - meshCentroid, vec3::Normalize(normals[index]));
+			}
+		}
+
+		// outward facing clusters on the outside first, they are the most likely occluders
+		std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::sortKey);
+
+		auto result = std::vector<uint32_t>{};
+		result.reserve(indices.size());
+		for (const auto& cluster : clusters)
+		{
+			const auto clusterIndices = indices.subspan(cluster.firstTriangle * 3zu, cluster.triangleCount * 3zu);
+			result.insert(std::ranges::end(result), std::ranges::begin(clusterIndices), std::ranges::end(clusterIndices));
+		}
+
+		return result;
+	}
+
+	void OptimizeVertexFetch(MeshData& mesh)
+	{
+		auto remap = std::vector<uint32_t>(mesh.vertices.size(), kNoVertex);
+		auto vertices = std::vector<VertexData>{};
+		vertices.reserve(mesh.vertices.size());
+
+		for (auto& index : mesh.indices)
+		{
+			if (remap[index] == kNoVertex)
+			{
+				remap[index] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(mesh.vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		mesh.vertices = std::move(vertices);
+	}
+
+	MeshOptimizationStats OptimizeMesh(MeshData& mesh)
+	{
+		const auto vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		const auto before = AnalyzeVertexCache(mesh.indices, vertexCount);
+
+		const auto cacheOptimized = OptimizeVertexCache(mesh.indices, vertexCount);
+		auto indices = OptimizeOverdraw(cacheOptimized, mesh.vertices);
+
+		// small or already well ordered meshes can come out worse, keep their triangle order
+		if (AnalyzeVertexCache(indices, vertexCount).transformedVertices < before.transformedVertices)
+		{
+			mesh.indices = std::move(indices);
+		}
+
+		OptimizeVertexFetch(mesh);
+
+		return { .before = before, .after = AnalyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size())) };
+	}
+
+	MeshOptimizationStats OptimizeMeshes(std::span<MeshData> meshes)
+	{
+		auto stats = std::vector<MeshOptimizationStats>(meshes.size());
+		const auto tasks = std::views::iota(0zu, meshes.size()) | std::ranges::to<std::vector>();
+
+		std::for_each(std::execution::par, std::ranges::begin(tasks), std::ranges::end(tasks), [&](auto index)
+			{
+				stats[index] = OptimizeMesh(meshes[index]);
+			});
+
+		auto total = MeshOptimizationStats{ .before = {}, .after = {} };
+		for (const auto& mesh : stats)
+		{
+			total.before += mesh.before;
+			total.after += mesh.after;
+		}
+
+		return total;
+	}
+
+}
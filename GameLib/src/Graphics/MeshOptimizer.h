@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MeshData.h"
+#include "VertexData.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Game {
+
+	// @brief Post-transform cache size the optimizer targets and the statistics simulate
+	constexpr auto kVertexCacheSize = 16u;
+
+	// @brief Result of simulating a FIFO post-transform vertex cache over an index buffer
+	struct VertexCacheStats
+	{
+		uint32_t transformedVertices;
+		uint32_t triangleCount;
+		uint32_t referencedVertices;
+
+		// @brief Average cache miss ratio, vertices transformed per triangle (0.5 at best, 3 at worst)
+		float ACMR() const;
+
+		// @brief Average transform to vertex ratio, vertices transformed per referenced vertex (1 at best)
+		float ATVR() const;
+
+		VertexCacheStats& operator+=(const VertexCacheStats& other);
+
+		std::string to_string() const;
+	};
+
+	struct MeshOptimizationStats
+	{
+		VertexCacheStats before;
+		VertexCacheStats after;
+
+		std::string to_string() const;
+	};
+
+	// @brief Largest per component difference at which two vertices are still considered identical, 0 welds bit-equal attributes only
+	struct WeldTolerance
+	{
+		float position = 1e-5f;
+		float normal = 1e-3f;
+		float tangent = 1e-3f;
+		float bitangent = 1e-3f;
+		float uv = 1e-5f;
+	};
+
+	struct WeldStats
+	{
+		uint32_t verticesBefore;
+		uint32_t verticesAfter;
+
+		uint32_t Removed() const;
+
+		WeldStats& operator+=(const WeldStats& other);
+
+		std::string to_string() const;
+	};
+
+	// @brief Merges every vertex into the earliest kept vertex whose attributes are all within tolerance and remaps the indices.
+	// Positions are hashed into cells of the position tolerance so only the 27 surrounding cells are searched.
+	WeldStats WeldVertices(MeshData& mesh, const WeldTolerance& tolerance = {});
+
+	// @brief WeldVertices over every mesh in parallel, returns the statistics of each mesh
+	std::vector<WeldStats> WeldMeshes(std::span<MeshData> meshes, const WeldTolerance& tolerance = {});
+
+	VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+	// @brief Tipsify (Sander et al. 2007): fans around the most recently used vertex that will still be cached,
+	// jumping to the latest dead-end vertex or the next unfinished vertex when none qualifies
+	std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+	// @brief Splits a cache optimized index buffer into clusters and orders them front-facing-first from the outside in,
+	// a cluster ends where the cache restarts or where it is already within threshold of the mesh ACMR
+	std::vector<uint32_t> OptimizeOverdraw(std::span<const uint32_t> indices, std::span<const VertexData> vertices, float threshold = 1.05f, uint32_t cacheSize = kVertexCacheSize);
+
+	// @brief Reorders vertices by first use so fetches walk the vertex buffer linearly, unreferenced vertices are dropped
+	void OptimizeVertexFetch(MeshData& mesh);
+
+	// @brief Runs the cache, overdraw and fetch passes in that order, keeping the original triangle order if it simulates better.
+	// Deterministic, the same input always gives the same output.
+	MeshOptimizationStats OptimizeMesh(MeshData& mesh);
+
+	// @brief OptimizeMesh over every mesh in parallel, returns the summed statistics
+	MeshOptimizationStats OptimizeMeshes(std::span<MeshData> meshes);
+
+}
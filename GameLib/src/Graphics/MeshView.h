@@ -4,15 +4,61 @@
 
 #include <cstdint>
 #include <span>
+#include <string>
 
 namespace Game {
 
+	// @brief Stable identifier of a loaded mesh, stays valid while the mesh data is relocated. Unloading bumps the
+	// generation of the index, so a handle kept past the unload fails instead of finding the mesh reusing the index.
+	struct MeshHandle
+	{
+		uint32_t index;
+		uint32_t generation;
+
+		constexpr bool operator==(const MeshHandle&) const = default;
+	};
+
+	// @brief Index pool a mesh lives in, meshes with at most kMaxShortIndexVertices vertices use 16 bit indices
+	enum class IndexType : uint32_t
+	{
+		UINT16,
+		UINT32
+	};
+
+	constexpr auto kIndexTypeCount = 2zu;
+	constexpr auto kMaxShortIndexVertices = 1u << 16u;
+
+	constexpr IndexType IndexTypeFor(size_t vertexCount)
+	{
+		return vertexCount <= kMaxShortIndexVertices ? IndexType::UINT16 : IndexType::UINT32;
+	}
+
+	constexpr size_t IndexSize(IndexType type)
+	{
+		return type == IndexType::UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	}
+
+	inline std::string to_string(IndexType type)
+	{
+		switch (type)
+		{
+			case IndexType::UINT16: return "UINT16";
+			case IndexType::UINT32: return "UINT32";
+			default: return "unknown";
+		}
+	}
+
+	// @brief Current location of a mesh in the shared vertex and index pools, how to decode its positions and its object space bounds
 	struct MeshView
 	{
-		uint32_t indexOffset;
+		IndexType indexType;
+		uint32_t indexOffset;	// in elements of the index pool of indexType
 		uint32_t indexCount;
 		uint32_t vertexOffset;
 		uint32_t vertexCount;
+		MeshHandle handle;
+		PositionQuantization quantization;
+		AABB bounds;
 	};
 
-}
\ No newline at end of file
+}
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "Utils.h"
+#include "Utils/AutoRelease.h"
 #include "Utils/DataBuffer.h"
+#include "Utils/Error.h"
+#include "OpenGL.h"
 
+#include <array>
+#include <chrono>
+#include <span>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace Game {
 
 	// @brief A multi buffer wrapper over a Buffer type.
-	// Will allocate size * Frames amount of data and can advance through the internal frames
+	// Will allocate size * Frames amount of data and can advance through the internal frames.
+	// Advance fences the slot it leaves, the first write into a slot waits until the GPU is done with the frame that last used it
 	template<IsBuffer Buffer, size_t Frames = 3zu>
 	class MultiBuffer
 	{
@@ -17,18 +26,42 @@ namespace Game {
 			: m_Buffer{ size * Frames, name }
 			, m_Size{ size }
 			, m_FrameOffset{}
+			, m_Fences{}
+			, m_WaitTime{}
+			, m_LastWaitTime{}
 		{}
 
 		void Write(DataBufferView data, size_t offset)
 		{
+			WaitForFrame();
 			m_Buffer.Write(data, offset + m_FrameOffset);
 		}
 
+		// @brief Call once all commands reading the current slot have been issued
 		void Advance()
 		{
+			m_Fences[FrameIndex()] = { glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u), glDeleteSync };
+			m_LastWaitTime = std::exchange(m_WaitTime, {});
 			m_FrameOffset = (m_FrameOffset + m_Size) % (m_Size * Frames);
 		}
 
+		// @brief Time writes into the slot just advanced from spent waiting for the GPU, near zero unless the GPU is the bottleneck
+		std::chrono::nanoseconds GetFenceWaitTime() const
+		{
+			return m_LastWaitTime;
+		}
+
+		// @brief The first count elements of the current frame slot as T, written in place instead of staged and copied.
+		// Slots stay mapped for the buffer's lifetime, the span is invalidated by Advance and by recreating the buffer
+		template<class T>
+			requires std::is_trivially_copyable_v<T>
+		std::span<T> MapFrame(size_t count)
+		{
+			Expect(count * sizeof(T) <= m_Size, "Frame of {} is too small", GetName());
+			WaitForFrame();
+			return { reinterpret_cast<T*>(m_Buffer.Map(m_FrameOffset, count * sizeof(T)).data()), count };
+		}
+
 		auto GetNativeHandle() const
 		{
 			return m_Buffer.GetNativeHandle();
@@ -49,15 +82,41 @@ namespace Game {
 			return m_FrameOffset;
 		}
 
+		// @brief Index of the frame slot writes currently go to, in [0, Frames)
+		size_t FrameIndex() const
+		{
+			return m_FrameOffset / m_Size;
+		}
+
+		static constexpr size_t FrameCount()
+		{
+			return Frames;
+		}
+
 		std::string_view GetName() const
 		{
 			return m_Buffer.GetName();
 		}
 
 	private:
+		void WaitForFrame()
+		{
+			auto& fence = m_Fences[FrameIndex()];
+			if (!fence)
+			{
+				return;
+			}
+
+			m_WaitTime += WaitForFence(fence);
+			fence = {};
+		}
+
 		Buffer m_Buffer;
 		size_t m_Size;
 		size_t m_FrameOffset;
+		std::array<AutoRelease<GLsync>, Frames> m_Fences;	// pending per slot, released once waited on
+		std::chrono::nanoseconds m_WaitTime;
+		std::chrono::nanoseconds m_LastWaitTime;
 	};
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Math/Matrix4.h"
+#include "Math/Vector3.h"
 
 #include <cstdint>
 
@@ -9,8 +10,12 @@ namespace Game {
 	struct ObjectData
 	{
 		mat4 model;
+		vec3 positionOffset;
 		uint32_t materialIDIndex;
-		uint32_t padding[3];
+		vec3 positionScale;
+		uint32_t padding;
 	};
 
+	static_assert(sizeof(ObjectData) == 96);
+
 }
@@ -42,6 +42,7 @@
 	DO(PFNGLVERTEXARRAYATTRIBFORMATPROC, glVertexArrayAttribFormat) \
 	DO(PFNGLVERTEXARRAYATTRIBBINDINGPROC, glVertexArrayAttribBinding) \
 	DO(PFNGLNAMEDBUFFERSUBDATAPROC, glNamedBufferSubData) \
+	DO(PFNGLCOPYNAMEDBUFFERSUBDATAPROC, glCopyNamedBufferSubData) \
 	DO(PFNGLVERTEXARRAYELEMENTBUFFERPROC, glVertexArrayElementBuffer) \
 	DO(PFNGLBINDBUFFERBASEPROC, glBindBufferBase) \
 	DO(PFNGLCREATETEXTURESPROC, glCreateTextures) \
@@ -50,6 +51,11 @@
 	DO(PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC, glMakeTextureHandleNonResidentARB) \
 	DO(PFNGLPROGRAMUNIFORMHANDLEUI64ARBPROC, glProgramUniformHandleui64ARB) \
 	DO(PFNGLPROGRAMUNIFORM1UIPROC, glProgramUniform1ui) \
+	DO(PFNGLPROGRAMUNIFORM3FPROC, glProgramUniform3f) \
+	DO(PFNGLPROGRAMUNIFORM2FPROC, glProgramUniform2f) \
+	DO(PFNGLPROGRAMUNIFORM3UIPROC, glProgramUniform3ui) \
+	DO(PFNGLPROGRAMUNIFORM4FVPROC, glProgramUniform4fv) \
+	DO(PFNGLPROGRAMUNIFORMMATRIX4FVPROC, glProgramUniformMatrix4fv) \
 	DO(PFNGLTEXTURESTORAGE2DPROC, glTextureStorage2D) \
 	DO(PFNGLTEXTURESTORAGE2DMULTISAMPLEPROC, glTextureStorage2DMultisample) \
 	DO(PFNGLTEXTURESUBIMAGE2DPROC, glTextureSubImage2D) \
@@ -80,8 +86,23 @@
 	DO(PFNGLVALIDATEPROGRAMPROC, glValidateProgram) \
 	DO(PFNGLMULTIDRAWARRAYSINDIRECTPROC, glMultiDrawArraysIndirect) \
 	DO(PFNGLMULTIDRAWELEMENTSINDIRECTPROC, glMultiDrawElementsIndirect) \
+	DO(PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC, glMultiDrawElementsIndirectCount) \
+	DO(PFNGLDISPATCHCOMPUTEPROC, glDispatchCompute) \
+	DO(PFNGLMEMORYBARRIERPROC, glMemoryBarrier) \
+	DO(PFNGLCLEARNAMEDBUFFERSUBDATAPROC, glClearNamedBufferSubData) \
 	DO(PFNGLMAPNAMEDBUFFERRANGEPROC, glMapNamedBufferRange) \
-	DO(PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer)
+	DO(PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer) \
+	DO(PFNGLFENCESYNCPROC, glFenceSync) \
+	DO(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync) \
+	DO(PFNGLDELETESYNCPROC, glDeleteSync) \
+	DO(PFNGLCLEARNAMEDFRAMEBUFFERFVPROC, glClearNamedFramebufferfv) \
+	DO(PFNGLGETINTEGER64VPROC, glGetInteger64v) \
+	DO(PFNGLCREATEQUERIESPROC, glCreateQueries) \
+	DO(PFNGLDELETEQUERIESPROC, glDeleteQueries) \
+	DO(PFNGLQUERYCOUNTERPROC, glQueryCounter) \
+	DO(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv) \
+	DO(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v) \
+	DO(PFNGLVIEWPORTINDEXEDFPROC, glViewportIndexedf)
 
 #define DO_DEFINE(TYPE, NAME) inline TYPE NAME;
 FOR_OPENGL_FUNCTIONS(DO_DEFINE)
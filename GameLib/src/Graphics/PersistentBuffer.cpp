@@ -1,5 +1,6 @@
 #include "PersistentBuffer.h"
 
+#include "GPUMemory.h"
 #include "Utils/Error.h"
 
 #include <cstring>
@@ -10,6 +11,7 @@ namespace Game {
 		: m_Buffer{ 0u, [](auto buffer) { glUnmapNamedBuffer(buffer); glDeleteBuffers(1, &buffer); } }
 		, m_Size{ size }
 		, m_Name{ name }
+		, m_MemoryRegistration{ GPUMemory::Register(GPUMemoryCategory::PERSISTENT_BUFFER, name, size) }
 	{
 		const auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
 		glCreateBuffers(1, &m_Buffer);
@@ -25,6 +27,12 @@ namespace Game {
 		std::memcpy(reinterpret_cast<std::byte*>(m_Map) + offset, data.data(), data.size_bytes());
 	}
 
+	std::span<std::byte> PersistentBuffer::Map(size_t offset, size_t size) const
+	{
+		Expect(m_Size >= size + offset, "Buffer is too small");
+		return { reinterpret_cast<std::byte*>(m_Map) + offset, size };
+	}
+
 	GLuint PersistentBuffer::GetNativeHandle() const
 	{
 		return m_Buffer;
@@ -4,6 +4,9 @@
 #include "Utils/DataBuffer.h"
 #include "OpenGL.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 
@@ -16,6 +19,9 @@ namespace Game {
 
 		void Write(DataBufferView data, size_t offset) const;
 
+		// @brief Writable view of the coherent mapping, stores through it are visible to commands issued afterwards
+		std::span<std::byte> Map(size_t offset, size_t size) const;
+
 		GLuint GetNativeHandle() const;
 		std::string_view GetName() const;
 
@@ -26,6 +32,7 @@ namespace Game {
 		size_t m_Size;
 		void* m_Map;
 		std::string m_Name;
+		AutoRelease<uint64_t> m_MemoryRegistration;
 	};
 
 }
@@ -40,6 +40,24 @@ namespace Game {
 		CheckState(m_Handle, GL_VALIDATE_STATUS, name, "Failed to validate program");
 	}
 
+	Program::Program(const Shader& computeShader, std::string_view name)
+		: m_Handle{}
+	{
+		Expect(computeShader.GetType() == ShaderType::COMPUTE, "Shader is not a compute shader");
+
+		m_Handle = { glCreateProgram(), glDeleteProgram };
+		Ensure(m_Handle, "Failed to create OpenGL program");
+
+		glObjectLabel(GL_PROGRAM, m_Handle, name.length(), name.data());
+
+		glAttachShader(m_Handle, computeShader.GetNativeHandle());
+		glLinkProgram(m_Handle);
+		glValidateProgram(m_Handle);
+
+		CheckState(m_Handle, GL_LINK_STATUS, name, "Failed to link program");
+		CheckState(m_Handle, GL_VALIDATE_STATUS, name, "Failed to validate program");
+	}
+
 	void Program::Use() const
 	{
 		glUseProgram(m_Handle);
@@ -12,6 +12,7 @@ namespace Game {
 	{
 	public:
 		Program(const Shader& vertexShader, const Shader& fragmentShader, std::string_view name);
+		Program(const Shader& computeShader, std::string_view name);
 
 		void Use() const;
 
@@ -0,0 +1,400 @@
+#include "RenderGraph.h"
+
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <queue>
+#include <ranges>
+
+namespace {
+
+	struct Writer
+	{
+		uint32_t pass;
+		Game::RenderAccess access;
+	};
+
+	// @brief Barrier making incoherent storage writes visible to a later access of the given kind
+	GLbitfield StorageWriteBarrier(Game::RenderAccess read, bool texture)
+	{
+		switch (read)
+		{
+			case Game::RenderAccess::SAMPLED: return GL_TEXTURE_FETCH_BARRIER_BIT;
+			case Game::RenderAccess::STORAGE: return texture ? GL_SHADER_IMAGE_ACCESS_BARRIER_BIT : GL_SHADER_STORAGE_BARRIER_BIT;
+			case Game::RenderAccess::COLOR_ATTACHMENT: return GL_FRAMEBUFFER_BARRIER_BIT;
+			case Game::RenderAccess::DEPTH_ATTACHMENT: return GL_FRAMEBUFFER_BARRIER_BIT;
+			case Game::RenderAccess::TRANSFER: return texture ? GL_FRAMEBUFFER_BARRIER_BIT : GL_BUFFER_UPDATE_BARRIER_BIT;
+		}
+		throw Game::Exception("Unknown render access: {}", read);
+	}
+
+	bool IsAttachment(Game::RenderAccess access)
+	{
+		return access == Game::RenderAccess::COLOR_ATTACHMENT || access == Game::RenderAccess::DEPTH_ATTACHMENT;
+	}
+
+}
+
+namespace Game {
+
+	CompiledRenderGraph CompileRenderGraph(std::span<const RenderResourceDesc> resources, std::span<const RenderPassDesc> passes)
+	{
+		auto writers = std::vector<std::optional<Writer>>(resources.size());
+		for (const auto& [index, pass] : passes | std::views::enumerate)
+		{
+			for (const auto& write : pass.writes)
+			{
+				Ensure(write.resource < resources.size(), "Pass {} writes unknown resource {}", pass.name, write.resource);
+				const auto& resource = resources[write.resource];
+				Ensure(write.access != RenderAccess::SAMPLED, "Pass {} writes {} through a read only access", pass.name, resource.name);
+				Ensure(!IsAttachment(write.access) || resource.texture.has_value(), "Pass {} attaches buffer {}", pass.name, resource.name);
+				if (const auto& writer = writers[write.resource]; writer)
+				{
+					throw Exception("{} is written by {} and {}", resource.name, passes[writer->pass].name, pass.name);
+				}
+
+				writers[write.resource] = Writer{ .pass = static_cast<uint32_t>(index), .access = write.access };
+			}
+		}
+
+		for (const auto& pass : passes)
+		{
+			for (const auto& read : pass.reads)
+			{
+				Ensure(read.resource < resources.size(), "Pass {} reads unknown resource {}", pass.name, read.resource);
+				Ensure(writers[read.resource].has_value(), "Pass {} reads {} which no pass writes", pass.name, resources[read.resource].name);
+				// a bound attachment is cleared by the pass that binds it, testing against another pass's depth is not supported
+				Ensure(!IsAttachment(read.access), "Pass {} reads {} as an attachment", pass.name, resources[read.resource].name);
+			}
+		}
+
+		// everything the passes with side effects depend on, the rest is culled
+		auto live = std::vector<bool>(passes.size(), false);
+		auto pending = std::views::iota(0u, static_cast<uint32_t>(passes.size())) |
+			std::views::filter([&](auto index) { return passes[index].sideEffects; }) |
+			std::ranges::to<std::vector>();
+		while (!pending.empty())
+		{
+			const auto index = pending.back();
+			pending.pop_back();
+			if (live[index])
+			{
+				continue;
+			}
+
+			live[index] = true;
+			for (const auto& read : passes[index].reads)
+			{
+				pending.push_back(writers[read.resource]->pass);
+			}
+		}
+
+		// Kahn's algorithm taking the lowest ready index first, so declaration order is kept wherever dependencies allow
+		auto dependents = std::vector<std::vector<uint32_t>>(passes.size());
+		auto dependencyCounts = std::vector<uint32_t>(passes.size(), 0u);
+		for (const auto index : std::views::iota(0u, static_cast<uint32_t>(passes.size())) | std::views::filter([&](auto index) { return live[index]; }))
+		{
+			for (const auto& read : passes[index].reads)
+			{
+				if (const auto writer = writers[read.resource]->pass; writer != index)
+				{
+					dependents[writer].push_back(index);
+					++dependencyCounts[index];
+				}
+			}
+		}
+
+		auto ready = std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>>{};
+		for (const auto index : std::views::iota(0u, static_cast<uint32_t>(passes.size())))
+		{
+			if (live[index] && dependencyCounts[index] == 0u)
+			{
+				ready.push(index);
+			}
+		}
+
+		auto compiled = CompiledRenderGraph{
+			.passes = {},
+			.lifetimes = std::vector<std::optional<RenderResourceLifetime>>(resources.size()),
+			.physicalTextures = std::vector<std::optional<uint32_t>>(resources.size()),
+			.physicalDescs = {}
+		};
+
+		while (!ready.empty())
+		{
+			const auto index = ready.top();
+			ready.pop();
+			compiled.passes.push_back({ .pass = index, .barriers = 0u });
+
+			for (const auto dependent : dependents[index])
+			{
+				if (--dependencyCounts[dependent] == 0u)
+				{
+					ready.push(dependent);
+				}
+			}
+		}
+
+		Ensure(compiled.passes.size() == static_cast<size_t>(std::ranges::count(live, true)), "Render graph has a dependency cycle");
+
+		for (const auto& [position, compiledPass] : compiled.passes | std::views::enumerate)
+		{
+			const auto& pass = passes[compiledPass.pass];
+			const auto use = [&](const RenderResourceAccess& access)
+				{
+					auto& lifetime = compiled.lifetimes[access.resource];
+					const auto current = static_cast<uint32_t>(position);
+					lifetime = lifetime ?
+						RenderResourceLifetime{ .first = std::min(lifetime->first, current), .last = std::max(lifetime->last, current) } :
+						RenderResourceLifetime{ .first = current, .last = current };
+				};
+
+			std::ranges::for_each(pass.writes, use);
+			std::ranges::for_each(pass.reads, use);
+
+			for (const auto& read : pass.reads)
+			{
+				if (const auto& writer = *writers[read.resource]; writer.access == RenderAccess::STORAGE && writer.pass != compiledPass.pass)
+				{
+					compiledPass.barriers |= StorageWriteBarrier(read.access, resources[read.resource].texture.has_value());
+				}
+			}
+		}
+
+		// greedy in order of first use, each texture takes the first physical texture of its description free by then
+		auto textures = std::views::iota(0u, static_cast<uint32_t>(resources.size())) |
+			std::views::filter([&](auto resource) { return resources[resource].texture && compiled.lifetimes[resource]; }) |
+			std::ranges::to<std::vector>();
+		std::ranges::stable_sort(textures, {}, [&](auto resource) { return compiled.lifetimes[resource]->first; });
+
+		auto physicalLastUse = std::vector<uint32_t>{};
+		for (const auto resource : textures)
+		{
+			const auto& desc = *resources[resource].texture;
+			const auto& lifetime = *compiled.lifetimes[resource];
+
+			auto physical = 0zu;
+			while (physical < compiled.physicalDescs.size() && (compiled.physicalDescs[physical] != desc || physicalLastUse[physical] >= lifetime.first))
+			{
+				++physical;
+			}
+
+			if (physical == compiled.physicalDescs.size())
+			{
+				compiled.physicalDescs.push_back(desc);
+				physicalLastUse.push_back(lifetime.last);
+			}
+			else
+			{
+				physicalLastUse[physical] = lifetime.last;
+			}
+
+			compiled.physicalTextures[resource] = static_cast<uint32_t>(physical);
+		}
+
+		return compiled;
+	}
+
+	RenderGraph::RenderGraph(TextureManager& textureManager, const Sampler& sampler)
+		: m_TextureManager{ textureManager }
+		, m_Sampler{ sampler }
+		, m_Resources{}
+		, m_Passes{}
+		, m_Executes{}
+		, m_Compiled{}
+		, m_TexturePool{}
+		, m_FrameBufferPool{}
+		, m_ResourceTextures{}
+		, m_PassFrameBuffers{}
+	{
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Passes.clear();
+		m_Executes.clear();
+		m_Compiled = {};
+		m_ResourceTextures.clear();
+		m_PassFrameBuffers.clear();
+	}
+
+	uint32_t RenderGraph::CreateTexture(std::string_view name, const RenderTextureDesc& desc)
+	{
+		m_Resources.push_back({ .name = std::string{ name }, .texture = desc });
+		return static_cast<uint32_t>(m_Resources.size() - 1zu);
+	}
+
+	uint32_t RenderGraph::ImportBuffer(std::string_view name)
+	{
+		m_Resources.push_back({ .name = std::string{ name }, .texture = std::nullopt });
+		return static_cast<uint32_t>(m_Resources.size() - 1zu);
+	}
+
+	uint32_t RenderGraph::AddPass(std::string_view name, std::vector<RenderResourceAccess> reads, std::vector<RenderResourceAccess> writes, bool sideEffects, std::function<void()> execute)
+	{
+		m_Passes.push_back({ .name = std::string{ name }, .reads = std::move(reads), .writes = std::move(writes), .sideEffects = sideEffects });
+		m_Executes.push_back(std::move(execute));
+		return static_cast<uint32_t>(m_Passes.size() - 1zu);
+	}
+
+	void RenderGraph::Execute(GPUProfiler& profiler)
+	{
+		auto compileScope = profiler.Scope("compile");
+		m_Compiled = CompileRenderGraph(m_Resources, m_Passes);
+
+		const auto createTexture = [&](const RenderTextureDesc& desc, size_t pooled)
+			{
+				const auto textureData = TextureData{ .width = desc.width, .height = desc.height, .format = desc.format, .data = std::nullopt };
+				return Texture{ textureData, std::format("render_graph_{}_texture", pooled), m_Sampler };
+			};
+
+		// the n-th physical texture of a description takes the n-th pooled texture of it
+		auto taken = std::vector<bool>(m_TexturePool.size(), false);
+		auto physicalTextures = std::vector<std::optional<uint32_t>>(m_Compiled.physicalDescs.size());
+		for (const auto& [physical, desc] : m_Compiled.physicalDescs | std::views::enumerate)
+		{
+			for (const auto pooled : std::views::iota(0zu, m_TexturePool.size()))
+			{
+				if (!taken[pooled] && m_TexturePool[pooled].first == desc)
+				{
+					taken[pooled] = true;
+					physicalTextures[physical] = m_TexturePool[pooled].second;
+					break;
+				}
+			}
+		}
+
+		// the rest recreate pooled textures of descriptions this frame does not use, so resizing keeps the pool's size
+		for (const auto& [physical, desc] : m_Compiled.physicalDescs | std::views::enumerate)
+		{
+			if (physicalTextures[physical])
+			{
+				continue;
+			}
+
+			auto pooled = 0zu;
+			while (pooled < m_TexturePool.size() && taken[pooled])
+			{
+				++pooled;
+			}
+
+			if (pooled == m_TexturePool.size())
+			{
+				m_TexturePool.emplace_back(desc, m_TextureManager.Add(createTexture(desc, pooled)));
+				taken.push_back(false);
+			}
+			else
+			{
+				const auto textureIndex = m_TexturePool[pooled].second;
+				m_TextureManager.Replace(textureIndex, createTexture(desc, pooled));
+				m_TexturePool[pooled].first = desc;
+				std::erase_if(m_FrameBufferPool, [&](const auto& entry)
+					{
+						const auto& [colors, depth] = entry.first;
+						return std::ranges::contains(colors, textureIndex) || depth == textureIndex;
+					});
+			}
+
+			taken[pooled] = true;
+			physicalTextures[physical] = m_TexturePool[pooled].second;
+		}
+
+		m_ResourceTextures = m_Compiled.physicalTextures |
+			std::views::transform([&](const auto& physical) { return physical.transform([&](auto index) { return *physicalTextures[index]; }); }) |
+			std::ranges::to<std::vector>();
+
+		m_PassFrameBuffers.assign(m_Passes.size(), nullptr);
+		for (const auto& compiledPass : m_Compiled.passes)
+		{
+			m_PassFrameBuffers[compiledPass.pass] = AcquireFrameBuffer(m_Passes[compiledPass.pass]);
+		}
+
+		compileScope.Reset(nullptr);
+
+		for (const auto& [pass, barriers] : m_Compiled.passes)
+		{
+			const auto passScope = profiler.Scope(m_Passes[pass].name);
+			if (barriers != 0u)
+			{
+				glMemoryBarrier(barriers);
+			}
+
+			// attachments start undefined, aliased ones hold whatever the previous resource left
+			if (const auto* frameBuffer = m_PassFrameBuffers[pass]; frameBuffer)
+			{
+				frameBuffer->Bind();
+				frameBuffer->Clear();
+			}
+
+			m_Executes[pass]();
+		}
+	}
+
+	uint32_t RenderGraph::GetTextureIndex(uint32_t resource) const
+	{
+		Expect(resource < m_ResourceTextures.size() && m_ResourceTextures[resource].has_value(), "Resource {} has no texture this frame", resource);
+		return *m_ResourceTextures[resource];
+	}
+
+	const FrameBuffer& RenderGraph::GetFrameBuffer(uint32_t pass) const
+	{
+		Expect(pass < m_PassFrameBuffers.size() && m_PassFrameBuffers[pass] != nullptr, "Pass {} has no frame buffer this frame", pass);
+		return *m_PassFrameBuffers[pass];
+	}
+
+	std::span<const RenderResourceDesc> RenderGraph::GetResources() const
+	{
+		return m_Resources;
+	}
+
+	std::span<const RenderPassDesc> RenderGraph::GetPasses() const
+	{
+		return m_Passes;
+	}
+
+	const CompiledRenderGraph& RenderGraph::GetCompiled() const
+	{
+		return m_Compiled;
+	}
+
+	const FrameBuffer* RenderGraph::AcquireFrameBuffer(const RenderPassDesc& pass)
+	{
+		auto colors = std::vector<uint32_t>{};
+		auto depth = std::optional<uint32_t>{};
+		for (const auto& write : pass.writes)
+		{
+			if (write.access == RenderAccess::COLOR_ATTACHMENT)
+			{
+				colors.push_back(*m_ResourceTextures[write.resource]);
+			}
+			else if (write.access == RenderAccess::DEPTH_ATTACHMENT)
+			{
+				depth = *m_ResourceTextures[write.resource];
+			}
+		}
+
+		if (colors.empty())
+		{
+			Ensure(!depth, "Pass {} writes depth without a color attachment", pass.name);
+			return nullptr;
+		}
+
+		auto key = std::pair{ std::move(colors), depth };
+		auto frameBuffer = m_FrameBufferPool.find(key);
+		if (frameBuffer == std::ranges::end(m_FrameBufferPool))
+		{
+			auto created = FrameBuffer{
+				m_TextureManager.GetTextures(key.first),
+				depth ? m_TextureManager.GetTexture(*depth) : nullptr,
+				std::format("{}_frame_buffer", pass.name)
+			};
+			frameBuffer = m_FrameBufferPool.emplace(std::move(key), std::move(created)).first;
+		}
+
+		return &frameBuffer->second;
+	}
+
+}
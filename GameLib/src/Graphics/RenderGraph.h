@@ -0,0 +1,146 @@
+#pragma once
+
+#include "FrameBuffer.h"
+#include "GPUProfiler.h"
+#include "Sampler.h"
+#include "TextureData.h"
+#include "TextureManager.h"
+#include "OpenGL.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Game {
+
+	enum class RenderAccess
+	{
+		SAMPLED,			// texture fetch, read only
+		STORAGE,			// shader storage buffer or image load/store, incoherent so reads after it need a barrier
+		COLOR_ATTACHMENT,
+		DEPTH_ATTACHMENT,
+		TRANSFER			// blit, copy or upload from the CPU, ordered by GL itself
+	};
+
+	inline std::string to_string(RenderAccess access)
+	{
+		switch (access)
+		{
+			case RenderAccess::SAMPLED: return "SAMPLED";
+			case RenderAccess::STORAGE: return "STORAGE";
+			case RenderAccess::COLOR_ATTACHMENT: return "COLOR_ATTACHMENT";
+			case RenderAccess::DEPTH_ATTACHMENT: return "DEPTH_ATTACHMENT";
+			case RenderAccess::TRANSFER: return "TRANSFER";
+			default: return "unknown";
+		}
+	}
+
+	struct RenderTextureDesc
+	{
+		uint32_t width;
+		uint32_t height;
+		TextureFormat format;
+
+		constexpr bool operator==(const RenderTextureDesc&) const = default;
+	};
+
+	// @brief Textures are created by the graph, buffers belong to their passes and are only tracked for ordering and barriers
+	struct RenderResourceDesc
+	{
+		std::string name;
+		std::optional<RenderTextureDesc> texture;
+	};
+
+	struct RenderResourceAccess
+	{
+		uint32_t resource;
+		RenderAccess access;
+	};
+
+	// @brief Color attachment writes become attachments in declaration order
+	struct RenderPassDesc
+	{
+		std::string name;
+		std::vector<RenderResourceAccess> reads;
+		std::vector<RenderResourceAccess> writes;
+		bool sideEffects;	// kept even if nothing reads its writes, e.g. presenting
+	};
+
+	struct CompiledRenderPass
+	{
+		uint32_t pass;
+		GLbitfield barriers;	// issued before the pass
+	};
+
+	// @brief Positions in CompiledRenderGraph::passes, inclusive
+	struct RenderResourceLifetime
+	{
+		uint32_t first;
+		uint32_t last;
+
+		constexpr bool operator==(const RenderResourceLifetime&) const = default;
+	};
+
+	struct CompiledRenderGraph
+	{
+		std::vector<CompiledRenderPass> passes;							// execution order, culled passes are left out
+		std::vector<std::optional<RenderResourceLifetime>> lifetimes;	// per resource, none if no pass that runs uses it
+		std::vector<std::optional<uint32_t>> physicalTextures;			// per resource, the physical texture it lives in
+		std::vector<RenderTextureDesc> physicalDescs;
+	};
+
+	// @brief Pure CPU part of the graph. Every resource has exactly one writer and passes are ordered after the writers of
+	// what they read, declaration order breaking ties. Passes nothing with side effects depends on are culled, textures with
+	// the same description whose lifetimes do not overlap share a physical texture. Throws on invalid graphs and cycles.
+	CompiledRenderGraph CompileRenderGraph(std::span<const RenderResourceDesc> resources, std::span<const RenderPassDesc> passes);
+
+	// @brief Frame graph rebuilt every frame. GL cannot place textures in shared memory so aliasing resources share a texture,
+	// physical textures and frame buffers are pooled across frames and only created when a frame needs more than the last.
+	// Pooled textures of descriptions a frame does not use are recreated for the ones it lacks, e.g. after a resize.
+	class RenderGraph
+	{
+	public:
+		RenderGraph(TextureManager& textureManager, const Sampler& sampler);
+
+		// @brief Drops the last frame's passes and resources, starting the declarations of a new frame
+		void Reset();
+
+		uint32_t CreateTexture(std::string_view name, const RenderTextureDesc& desc);
+		uint32_t ImportBuffer(std::string_view name);
+		uint32_t AddPass(std::string_view name, std::vector<RenderResourceAccess> reads, std::vector<RenderResourceAccess> writes, bool sideEffects, std::function<void()> execute);
+
+		// @brief Compiles then runs the passes in order, each after its barriers and with its attachments bound and cleared.
+		// Compiling and every pass are profiler zones, passes named after themselves.
+		void Execute(GPUProfiler& profiler);
+
+		// @brief Index in the texture manager, valid from Execute until the next Reset
+		uint32_t GetTextureIndex(uint32_t resource) const;
+		// @brief Frame buffer of the pass's attachments, valid from Execute until the next Reset
+		const FrameBuffer& GetFrameBuffer(uint32_t pass) const;
+
+		std::span<const RenderResourceDesc> GetResources() const;
+		std::span<const RenderPassDesc> GetPasses() const;
+		const CompiledRenderGraph& GetCompiled() const;
+
+	private:
+		const FrameBuffer* AcquireFrameBuffer(const RenderPassDesc& pass);
+
+		TextureManager& m_TextureManager;
+		const Sampler& m_Sampler;
+		std::vector<RenderResourceDesc> m_Resources;
+		std::vector<RenderPassDesc> m_Passes;
+		std::vector<std::function<void()>> m_Executes;
+		CompiledRenderGraph m_Compiled;
+		std::vector<std::pair<RenderTextureDesc, uint32_t>> m_TexturePool;	// texture manager index
+		std::map<std::pair<std::vector<uint32_t>, std::optional<uint32_t>>, FrameBuffer> m_FrameBufferPool;	// by color and depth textures
+		std::vector<std::optional<uint32_t>> m_ResourceTextures;
+		std::vector<const FrameBuffer*> m_PassFrameBuffers;
+	};
+
+}
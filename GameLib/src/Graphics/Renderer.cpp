@@ -1,16 +1,38 @@
 #include "Renderer.h"
 
+#include "DeferredDeletion.h"
 #include "ObjectData.h"
 #include "Utils.h"
 
+#include <algorithm>
+#include <cmath>
 #include <string_view>
 #include <ranges>
 #include <span>
+#include <tuple>
+#include <utility>
 
 using namespace std::literals;
 
 namespace {
 
+	// per frame camera, light, object and instance data, Renderer::Reserve sizes it for the level
+	constexpr auto kTransientCapacity = 4zu * 1024zu * 1024zu;
+
+	constexpr auto kReservedClustersPerLight = 32zu;
+
+	size_t StorageBufferAlignment()
+	{
+		auto alignment = GLint64{};
+		glGetInteger64v(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return static_cast<size_t>(alignment);
+	}
+
+	uint32_t ScaledSize(uint32_t size, float scale)
+	{
+		return std::max(1u, static_cast<uint32_t>(std::lround(static_cast<float>(size) * scale)));
+	}
+
 	Game::Program CreateProgram(Game::ResourceLoader& resourceLoader, std::string_view vertexPath, std::string_view vertexName, std::string_view fragmentPath, std::string_view fragmentName, std::string_view programName)
 	{
 		const auto simpleVert = Game::Shader{ resourceLoader._LoadString(vertexPath), Game::ShaderType::VERTEX, vertexName };
@@ -18,42 +40,33 @@ namespace {
 		return { simpleVert, simpleFrag, programName };
 	}
 
-	Game::RenderTarget CreateRenderTarget(uint32_t colorAttachmentCount, uint32_t width, uint32_t height, Game::Sampler& sampler, Game::TextureManager& textureManager, std::string_view name)
+	// @brief Binds the index pool commands of the given index type were built against, returns the matching GL index type
+	GLenum BindIndexPool(Game::IndexType indexType, const Game::MeshManager& meshManager)
 	{
-		const auto colorAttachmentTextureData = Game::TextureData{
-			.width = width,
-			.height = height,
-			.format = Game::TextureFormat::RGB16F,
-			.data = std::nullopt
-		};
-
-		auto colorAttachments = std::views::iota(0u, colorAttachmentCount) |
-			std::views::transform([&](auto index) { return Game::Texture{ colorAttachmentTextureData, std::format("{}_{}_texture", name, index), sampler }; }) |
-			std::ranges::to<std::vector>();
-
-		const auto firstIndex = textureManager.Add(std::move(colorAttachments));
+		const auto indexBufferHandle = std::get<1>(meshManager.GetNativeHandle(indexType));
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferHandle);
 
-		const auto depthTextureData = Game::TextureData{
-			.width = width,
-			.height = height,
-			.format = Game::TextureFormat::DEPTH24,
-			.data = std::nullopt
-		};
-		auto depthTexture = Game::Texture{ depthTextureData, std::format("{}_depth_texture", name), sampler };
-		const auto depthTextureIndex = textureManager.Add(std::move(depthTexture));
+		return indexType == Game::IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
 
-		auto fb = Game::FrameBuffer{
-			textureManager.GetTextures(std::views::iota(firstIndex, firstIndex + colorAttachmentCount) | std::ranges::to<std::vector>()),
-			textureManager.GetTexture(depthTextureIndex),
-			std::format("{}_frame_buffer", name)
-		};
+	// @brief Issues one multi draw for the batch with the index pool it was built against bound
+	void Draw(const Game::DrawBatch& batch, const Game::CommandBuffer& commandBuffer, const Game::MeshManager& meshManager)
+	{
+		const auto indexType = BindIndexPool(batch.indexType, meshManager);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, reinterpret_cast<const void*>(commandBuffer.OffsetBytes() + batch.offsetBytes), batch.commandCount, 0);
+	}
 
-		return {
-			.fb = std::move(fb),
-			.colorAttachmentCount = colorAttachmentCount,
-			.firstColorAttachmentIndex = firstIndex,
-			.depthAttachmentIndex = depthTextureIndex
-		};
+	// @brief Issues one multi draw for a batch written by the GPU culler, the draw count is read from the bound parameter buffer
+	void Draw(const Game::CullBatch& batch, size_t batchIndex, const Game::MeshManager& meshManager)
+	{
+		const auto indexType = BindIndexPool(batch.indexType, meshManager);
+		glMultiDrawElementsIndirectCount(
+			GL_TRIANGLES,
+			indexType,
+			reinterpret_cast<const void*>(batch.firstTemplate * sizeof(Game::IndirectCommand)),
+			static_cast<GLintptr>(batchIndex * sizeof(uint32_t)),
+			batch.templateCount,
+			0);
 	}
 
 	Game::MeshData Sprite()
@@ -84,101 +97,341 @@ namespace {
 
 namespace Game {
 
-	Renderer::Renderer(const Window& window, ResourceLoader& resourceLoader, TextureManager& textureManager, MeshManager& meshManager)
-		: m_Window{ window }
-		, m_DummyVAO{ 0u, [](auto e) { glDeleteVertexArrays(1, &e); } }
+	Renderer::Renderer(uint32_t renderWidth, uint32_t renderHeight, ResourceLoader& resourceLoader, TextureManager& textureManager, MeshManager& meshManager)
+		: m_DummyVAO{ 0u, [](auto e) { glDeleteVertexArrays(1, &e); } }
 		, m_CommandBuffer{ "gbuffer_command_buffer" }
 		, m_PostProcessingCommandBuffer{ "post_processing_command_buffer" }
-		, m_PostProcessSprite{ "post_process_sprite", meshManager.Load(Sprite()), {}, 0u }
-		, m_CameraBuffer{ sizeof(CameraData), "camera_buffer" }
-		, m_LightBuffer{ sizeof(LightData), "light_buffer" }
-		, m_ObjectDataBuffer{ sizeof(ObjectData), "object_data_buffer" }
+		, m_GPUCuller{ resourceLoader }
+		, m_CullingMode{ CullingMode::CPU }
+		, m_GPULightClusterer{ resourceLoader }
+		, m_ClusterAssignment{ ClusterAssignment::CPU }
+		, m_ClusterLights{}
+		, m_ClusterStats{}
+		, m_PostProcessSprite{ "post_process_sprite", meshManager.Load(Sprite()).handle, {}, 0u }
+		, m_TransientAllocator{ kTransientCapacity, TransientOverflow::GROW, "transient_buffer" }
+		, m_StorageAlignment{ StorageBufferAlignment() }
 		, m_GBufferProgram{ CreateProgram(resourceLoader, "shaders\\gbuffer.vert", "gbuffer_vertex_shader", "shaders\\gbuffer.frag", "gbuffer_fragment_shader", "gbuffer_prog")}
 		, m_LightPassProgram{ CreateProgram(resourceLoader, "shaders\\light_pass.vert", "light_pass_vertex_shader", "shaders\\light_pass.frag", "light_pass_fragment_shader", "light_pass_prog")}
 		, m_FBSampler{ FilterType::LINEAR, FilterType::LINEAR, "fb_sampler" }
-		, m_GBufferRT{ CreateRenderTarget(4u, m_Window.GetRenderWidth(), m_Window.GetRenderHeight(), m_FBSampler, textureManager, "gbuffer")}
-		, m_LightPassRT{ CreateRenderTarget(1u, m_Window.GetRenderWidth(), m_Window.GetRenderHeight(), m_FBSampler, textureManager, "light_pass") }
+		, m_RenderGraph{ textureManager, m_FBSampler }
+		, m_RenderWidth{ renderWidth }
+		, m_RenderHeight{ renderHeight }
+		, m_DynamicResolution{}
+		, m_GBufferTextures{}
+		, m_FenceWaitTime{}
+		, m_Profiler{}
 	{
-		m_PostProcessingCommandBuffer.Build(m_PostProcessSprite);
-
 		glGenVertexArrays(1, &m_DummyVAO);
 		glBindVertexArray(m_DummyVAO);
+
+		// the vertex format is fixed for the lifetime of the mesh manager and the sprite's quantization never changes
+		const auto vertexFormat = std::to_underlying(meshManager.GetVertexFormat());
+		const auto spriteQuantization = meshManager.GetView(m_PostProcessSprite.mesh).quantization;
+		glProgramUniform1ui(m_GBufferProgram.GetNativeHandle(), 0u, vertexFormat);
+		glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 4u, vertexFormat);
+		glProgramUniform3f(m_LightPassProgram.GetNativeHandle(), 5u, spriteQuantization.offset.x, spriteQuantization.offset.y, spriteQuantization.offset.z);
+		glProgramUniform3f(m_LightPassProgram.GetNativeHandle(), 6u, spriteQuantization.scale.x, spriteQuantization.scale.y, spriteQuantization.scale.z);
+	}
+
+	Renderer::~Renderer()
+	{
+		// the GPU may still be using retired buffers, releasing them is only safe once it has executed everything submitted
+		const auto idle = AutoRelease<GLsync>{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u), glDeleteSync };
+		WaitForFence(idle);
+		DeferredDeletion::ReleaseAll();
 	}
 
 	void Renderer::Render(Scene& scene)
 	{
-		m_GBufferRT.fb.Bind();
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		const auto resolvedFrames = m_Profiler.GetResolvedFrames();
+		m_Profiler.BeginFrame();
+		m_Profiler.BeginZone("frame");
+
+		const auto cameraData = m_TransientAllocator.Allocate<CameraData>(1zu, m_StorageAlignment);
+		std::ranges::copy(scene.camera.GetDataView(), std::ranges::begin(cameraData.data));
+
+		// in entity order, instance slots map to entities through the instance buffer
+		const auto objectData = m_TransientAllocator.Allocate<ObjectData>(scene.entities.size(), m_StorageAlignment);
+		for (const auto [data, e] : std::views::zip(objectData.As<ObjectData>(), scene.entities))
+		{
+			const auto quantization = scene.meshManager.GetView(e.mesh).quantization;
+			data = ObjectData{
+				.model = e.transform,
+				.positionOffset = quantization.offset,
+				.materialIDIndex = e.materialIndex,
+				.positionScale = quantization.scale,
+				.padding = {}
+			};
+		}
+
+		const auto& pointLights = scene.lights.pointLights;
+		const auto lightData = m_TransientAllocator.Allocate(sizeof(LightHeader) + pointLights.size() * sizeof(PointLight), m_StorageAlignment);
+		lightData.As<LightHeader>().front() = { .ambient = scene.lights.ambient, .lightCount = static_cast<uint32_t>(pointLights.size()) };
+		std::ranges::copy(std::as_bytes(std::span{ pointLights }), std::ranges::begin(lightData.data.subspan(sizeof(LightHeader))));
+
+		const auto vertexBufferHandle = std::get<0>(scene.meshManager.GetNativeHandle(IndexType::UINT32));
+		const auto grid = ClusterGrid::FromCamera(scene.camera);
+		const auto scaledWidth = ScaledSize(m_RenderWidth, GetRenderScale());
+		const auto scaledHeight = ScaledSize(m_RenderHeight, GetRenderScale());
+		const auto renderTexture = [&](TextureFormat format) { return RenderTextureDesc{ .width = scaledWidth, .height = scaledHeight, .format = format }; };
+
+		m_RenderGraph.Reset();
+
+		// albedo with specular in alpha and the octahedral encoded normal, the light pass reconstructs positions from depth
+		const auto albedoSpecular = m_RenderGraph.CreateTexture("gbuffer_albedo_specular", renderTexture(TextureFormat::RGBA));
+		const auto normal = m_RenderGraph.CreateTexture("gbuffer_normal", renderTexture(TextureFormat::RG16_SNORM));
+		const auto depth = m_RenderGraph.CreateTexture("gbuffer_depth", renderTexture(TextureFormat::DEPTH24));
+		const auto litColor = m_RenderGraph.CreateTexture("lit_color", renderTexture(TextureFormat::RGB16F));
+		const auto clusters = m_RenderGraph.ImportBuffer("light_clusters");
+		m_GBufferTextures = { albedoSpecular, normal, depth };
+
+		m_RenderGraph.AddPass(
+			"gbuffer",
+			{},
+			{ { albedoSpecular, RenderAccess::COLOR_ATTACHMENT }, { normal, RenderAccess::COLOR_ATTACHMENT }, { depth, RenderAccess::DEPTH_ATTACHMENT } },
+			false,
+			[&]
+			{
+				// the cull passes use the storage buffer bindings below so they run before the gbuffer pass binds its own
+				auto cullScope = m_Profiler.Scope("cull");
+				const auto gpuBatches = m_CullingMode == CullingMode::GPU ?
+					m_GPUCuller.Cull(scene, objectData.buffer, objectData.offset, objectData.data.size()) :
+					std::span<const CullBatch>{};
+				// the CPU path culls while building its commands
+				if (m_CullingMode == CullingMode::GPU)
+				{
+					cullScope.Reset(nullptr);
+				}
+
+				m_GBufferProgram.Use();
+
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBufferHandle);
+				cameraData.Bind(GL_SHADER_STORAGE_BUFFER, 1);
+				objectData.Bind(GL_SHADER_STORAGE_BUFFER, 2);
+
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, scene.materialManager.GetNativeHandle());
+
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, scene.textureManager.GetNativeHandle());
+
+				if (m_CullingMode == CullingMode::GPU)
+				{
+					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_GPUCuller.GetInstanceBufferHandle());
+					glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_GPUCuller.GetCommandBufferHandle());
+					glBindBuffer(GL_PARAMETER_BUFFER, m_GPUCuller.GetDrawCountBufferHandle());
+
+					for (const auto& [index, batch] : gpuBatches | std::views::enumerate)
+					{
+						Draw(batch, static_cast<size_t>(index), scene.meshManager);
+					}
+				}
+				else
+				{
+					const auto batches = m_CommandBuffer.Build(scene);
+					cullScope.Reset(nullptr);
+					glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer.GetNativeHandle());
+
+					const auto instances = m_CommandBuffer.GetInstances();
+					const auto instanceData = m_TransientAllocator.Allocate<uint32_t>(instances.size(), m_StorageAlignment);
+					std::ranges::copy(instances, std::ranges::begin(instanceData.As<uint32_t>()));
+					instanceData.Bind(GL_SHADER_STORAGE_BUFFER, 6);
+
+					for (const auto& batch : batches)
+					{
+						Draw(batch, m_CommandBuffer, scene.meshManager);
+					}
+				}
+			});
+
+		// the CPU path uploads the lists, the GPU path writes the clusterer's buffers
+		auto clusterData = TransientAllocation{};
+		auto lightIndexData = TransientAllocation{};
+		m_RenderGraph.AddPass(
+			"light_clusters",
+			{},
+			{ { clusters, m_ClusterAssignment == ClusterAssignment::GPU ? RenderAccess::STORAGE : RenderAccess::TRANSFER } },
+			false,
+			[&]
+			{
+				if (m_ClusterAssignment == ClusterAssignment::GPU)
+				{
+					m_GPULightClusterer.Assign(grid, lightData, cameraData);
+					return;
+				}
+
+				m_ClusterStats = AssignLights(grid, scene.camera.GetData().view, pointLights, m_ClusterLights);
+
+				clusterData = m_TransientAllocator.Allocate<ClusterRange>(m_ClusterLights.clusters.size(), m_StorageAlignment);
+				std::ranges::copy(m_ClusterLights.clusters, std::ranges::begin(clusterData.As<ClusterRange>()));
+
+				lightIndexData = m_TransientAllocator.Allocate<uint32_t>(m_ClusterLights.lightIndices.size(), m_StorageAlignment);
+				std::ranges::copy(m_ClusterLights.lightIndices, std::ranges::begin(lightIndexData.As<uint32_t>()));
+			});
+
+		const auto lightPass = m_RenderGraph.AddPass(
+			"light_pass",
+			{
+				{ albedoSpecular, RenderAccess::SAMPLED },
+				{ normal, RenderAccess::SAMPLED },
+				{ depth, RenderAccess::SAMPLED },
+				{ clusters, RenderAccess::STORAGE }
+			},
+			{ { litColor, RenderAccess::COLOR_ATTACHMENT } },
+			false,
+			[&]
+			{
+				m_LightPassProgram.Use();
+				glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 0u, m_RenderGraph.GetTextureIndex(albedoSpecular));
+				glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 1u, m_RenderGraph.GetTextureIndex(normal));
+				glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 2u, m_RenderGraph.GetTextureIndex(depth));
+				const auto& camera = scene.camera.GetData();
+				const auto inverseViewProjection = mat4::Invert(camera.projection * camera.view);
+				glProgramUniformMatrix4fv(m_LightPassProgram.GetNativeHandle(), 3u, 1, GL_FALSE, inverseViewProjection.Data().data());
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBufferHandle);
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, scene.textureManager.GetNativeHandle());
+				lightData.Bind(GL_SHADER_STORAGE_BUFFER, 2);
+				cameraData.Bind(GL_SHADER_STORAGE_BUFFER, 3);
+
+				if (m_ClusterAssignment == ClusterAssignment::GPU)
+				{
+					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_GPULightClusterer.GetClusterBufferHandle());
+					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_GPULightClusterer.GetLightIndexBufferHandle());
+				}
+				else
+				{
+					clusterData.Bind(GL_SHADER_STORAGE_BUFFER, 4);
+					lightIndexData.Bind(GL_SHADER_STORAGE_BUFFER, 5);
+				}
+
+				glProgramUniform3ui(m_LightPassProgram.GetNativeHandle(), 7u, grid.width, grid.height, grid.depth);
+				glProgramUniform2f(
+					m_LightPassProgram.GetNativeHandle(),
+					8u,
+					static_cast<float>(scaledWidth) / static_cast<float>(grid.width),
+					static_cast<float>(scaledHeight) / static_cast<float>(grid.height));
+				glProgramUniform2f(m_LightPassProgram.GetNativeHandle(), 9u, grid.nearPlane, grid.SliceScale());
+				// rebuilt every frame as defragmentation may have moved the sprite
+				const auto spriteBatch = m_PostProcessingCommandBuffer.Build(m_PostProcessSprite, scene.meshManager);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_PostProcessingCommandBuffer.GetNativeHandle());
+				Draw(spriteBatch, m_PostProcessingCommandBuffer, scene.meshManager);
+			});
+
+		m_RenderGraph.AddPass(
+			"present",
+			{ { litColor, RenderAccess::TRANSFER } },
+			{},
+			true,
+			[&]
+			{
+				const auto& frameBuffer = m_RenderGraph.GetFrameBuffer(lightPass);
+				frameBuffer.UnBind();
+
+				glBlitNamedFramebuffer(
+					frameBuffer.GetNativeHandle(),
+					0u,
+					0u,
+					0u,
+					scaledWidth,
+					scaledHeight,
+					0u,
+					0u,
+					m_RenderWidth,
+					m_RenderHeight,
+					GL_COLOR_BUFFER_BIT,
+					scaledWidth == m_RenderWidth && scaledHeight == m_RenderHeight ? GL_NEAREST : GL_LINEAR);
+			});
+
+		m_RenderGraph.Execute(m_Profiler);
 
-		m_GBufferProgram.Use();
+		m_CommandBuffer.Advance();
+		m_PostProcessingCommandBuffer.Advance();
+		m_TransientAllocator.EndFrame();
+		m_GPUCuller.Advance();
+		DeferredDeletion::EndFrame();
+
+		m_FenceWaitTime =
+			m_CommandBuffer.GetFenceWaitTime() +
+			m_PostProcessingCommandBuffer.GetFenceWaitTime() +
+			m_GPUCuller.GetFenceWaitTime() +
+			m_TransientAllocator.GetStats().waitTime;
+
+		{
+			const auto postRenderScope = m_Profiler.Scope("post_render");
+			PostRender(scene);
+		}
+
+		m_Profiler.EndZone();
+		m_Profiler.EndFrame();
+
+		// timings arrive frames late, measured at an earlier scale, which the controller's settle frames account for
+		if (const auto frameTime = m_Profiler.GetLatestGPUTime("frame"); m_DynamicResolution && frameTime && m_Profiler.GetResolvedFrames() != resolvedFrames)
+		{
+			m_DynamicResolution->Update(*frameTime);
+		}
+	}
 
-		m_CameraBuffer.Write(scene.camera.GetDataView(), 0zu);
+	void Renderer::Reserve(const RenderReserveHints& hints)
+	{
+		// every frame that can be in flight plus the one being recorded, with room for each allocation's alignment.
+		// Light index lists depend on the view, beyond kReservedClustersPerLight per light the ring grows.
+		const auto frameBytes =
+			hints.entityCount * (sizeof(ObjectData) + sizeof(uint32_t)) +
+			sizeof(CameraData) +
+			sizeof(LightHeader) +
+			hints.lightCount * (sizeof(PointLight) + kReservedClustersPerLight * sizeof(uint32_t)) +
+			kClusterCount * sizeof(ClusterRange) +
+			6zu * TransientAllocator::kMaxAlignment;
+		m_TransientAllocator.Reserve(frameBytes * (MultiBuffer<PersistentBuffer>::FrameCount() + 1zu));
+		m_CommandBuffer.Reserve(hints.meshCount);
+		m_GPUCuller.Reserve(hints.entityCount, hints.meshCount);
+	}
 
-		const auto [vertexBufferHandle, indexBufferHandle] = scene.meshManager.GetNativeHandle();
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBufferHandle);
-		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_CameraBuffer.GetNativeHandle(), m_CameraBuffer.FrameOffsetBytes(), sizeof(CameraData));
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferHandle);
+	void Renderer::SetCullingMode(CullingMode mode)
+	{
+		m_CullingMode = mode;
+	}
 
-		const auto commandCount = m_CommandBuffer.Build(scene);
-		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer.GetNativeHandle());
-
-		const auto objectData = scene.entities |
-								std::views::transform([](const auto& e)
-													  {
-														  return ObjectData{ .model = e.transform, .materialIDIndex = e.materialIndex, .padding = {} };
-													  }) |
-								std::ranges::to<std::vector>();
-		ResizeGPUBuffer(objectData, m_ObjectDataBuffer);
-		m_ObjectDataBuffer.Write(std::as_bytes(std::span{ objectData.data(), objectData.size() }), 0zu);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_ObjectDataBuffer.GetNativeHandle());
-
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, scene.materialManager.GetNativeHandle());
-
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, scene.textureManager.GetNativeHandle());
-
-		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(m_CommandBuffer.OffsetBytes()), commandCount, 0);
-
-		m_LightBuffer.Write(std::as_bytes(std::span<const LightData, 1zu>{&scene.lights, 1zu}), 0zu);
-
-		m_LightPassRT.fb.Bind();
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		m_LightPassProgram.Use();
-		glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 0u, m_GBufferRT.firstColorAttachmentIndex + 0u);
-		glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 1u, m_GBufferRT.firstColorAttachmentIndex + 1u);
-		glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 2u, m_GBufferRT.firstColorAttachmentIndex + 2u);
-		glProgramUniform1ui(m_LightPassProgram.GetNativeHandle(), 3u, m_GBufferRT.firstColorAttachmentIndex + 3u);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBufferHandle);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, scene.textureManager.GetNativeHandle());
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_LightBuffer.GetNativeHandle());
-		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 3, m_CameraBuffer.GetNativeHandle(), m_CameraBuffer.FrameOffsetBytes(), sizeof(CameraData));
-		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_PostProcessingCommandBuffer.GetNativeHandle());
-		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(m_PostProcessingCommandBuffer.OffsetBytes()), 1u, 0);
+	CullingMode Renderer::GetCullingMode() const
+	{
+		return m_CullingMode;
+	}
 
-		m_CommandBuffer.Advance();
-		m_CameraBuffer.Advance();
-		m_LightBuffer.Advance();
-		m_ObjectDataBuffer.Advance();
+	void Renderer::SetClusterAssignment(ClusterAssignment assignment)
+	{
+		m_ClusterAssignment = assignment;
+	}
+
+	ClusterAssignment Renderer::GetClusterAssignment() const
+	{
+		return m_ClusterAssignment;
+	}
 
-		PostRender(scene);
+	ClusterStats Renderer::GetClusterStats() const
+	{
+		return m_ClusterStats;
+	}
+
+	void Renderer::SetDynamicResolution(const std::optional<DynamicResolutionConfig>& config)
+	{
+		m_DynamicResolution = config.transform([](const auto& c) { return DynamicResolution{ c }; });
+	}
+
+	float Renderer::GetRenderScale() const
+	{
+		return m_DynamicResolution ? m_DynamicResolution->GetScale() : 1.0f;
+	}
+
+	std::chrono::nanoseconds Renderer::GetFenceWaitTime() const
+	{
+		return m_FenceWaitTime;
+	}
+
+	GPUProfiler& Renderer::GetProfiler()
+	{
+		return m_Profiler;
 	}
 
 	void Renderer::PostRender(Scene&)
 	{
-		m_LightPassRT.fb.UnBind();
-
-		glBlitNamedFramebuffer(
-			m_LightPassRT.fb.GetNativeHandle(),
-			0u,
-			0u,
-			0u,
-			m_LightPassRT.fb.GetWidth(),
-			m_LightPassRT.fb.GetHeight(),
-			0u,
-			0u,
-			m_LightPassRT.fb.GetWidth(),
-			m_LightPassRT.fb.GetHeight(),
-			GL_COLOR_BUFFER_BIT,
-			GL_NEAREST);
 	}
 
 }
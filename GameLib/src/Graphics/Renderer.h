@@ -2,50 +2,124 @@
 
 #include "Core/Scene.h"
 #include "Resources/ResourceLoader.h"
-#include "FrameBuffer.h"
 #include "TextureManager.h"
 #include "MeshManager.h"
 #include "CommandBuffer.h"
+#include "DynamicResolution.h"
+#include "GPUCuller.h"
+#include "GPULightClusterer.h"
+#include "GPUProfiler.h"
+#include "LightClusters.h"
 #include "Program.h"
+#include "RenderGraph.h"
 #include "Sampler.h"
-#include "Window.h"
+#include "TransientAllocator.h"
 #include "OpenGL.h"
 #include "Utils/AutoRelease.h"
 
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace Game {
 
-	struct RenderTarget
+	enum class CullingMode
+	{
+		CPU,
+		GPU
+	};
+
+	inline std::string to_string(CullingMode mode)
+	{
+		switch (mode)
+		{
+			case CullingMode::CPU: return "CPU";
+			case CullingMode::GPU: return "GPU";
+			default: return "unknown";
+		}
+	}
+
+	enum class ClusterAssignment
+	{
+		CPU,
+		GPU
+	};
+
+	inline std::string to_string(ClusterAssignment assignment)
+	{
+		switch (assignment)
+		{
+			case ClusterAssignment::CPU: return "CPU";
+			case ClusterAssignment::GPU: return "GPU";
+			default: return "unknown";
+		}
+	}
+
+	// @brief Capacities to allocate when loading a level so per frame buffers do not grow in the middle of a session
+	struct RenderReserveHints
 	{
-		FrameBuffer fb;
-		uint32_t colorAttachmentCount;
-		uint32_t firstColorAttachmentIndex;
-		uint32_t depthAttachmentIndex;
+		size_t entityCount;
+		size_t meshCount;
+		size_t lightCount;
 	};
 
 	class Renderer
 	{
 	public:
-		Renderer(const Window& window, ResourceLoader& resourceLoader, TextureManager& textureManager, MeshManager& meshManager);
-		virtual ~Renderer() = default;
+		// @brief Outputs at the given size through a render graph rebuilt every frame, the frame is blitted to the default frame buffer of whatever context is current
+		Renderer(uint32_t renderWidth, uint32_t renderHeight, ResourceLoader& resourceLoader, TextureManager& textureManager, MeshManager& meshManager);
+		virtual ~Renderer();
 
 		void Render(Scene& scene);
+		void Reserve(const RenderReserveHints& hints);
+
+		void SetCullingMode(CullingMode mode);
+		CullingMode GetCullingMode() const;
+
+		void SetClusterAssignment(ClusterAssignment assignment);
+		ClusterAssignment GetClusterAssignment() const;
+		// @brief Light lists of the last frame, only assigned on the CPU path
+		ClusterStats GetClusterStats() const;
+
+		// @brief Scales the G-buffer and light pass from the frame GPU times the profiler reads back, the present pass upscales
+		// the result to the output size. None renders at the output size.
+		void SetDynamicResolution(const std::optional<DynamicResolutionConfig>& config);
+		// @brief Of the output width and height, for the next frame
+		float GetRenderScale() const;
+
+		// @brief Time the last frame spent waiting for the GPU to release frame slots, a large share of the frame time means GPU bound
+		std::chrono::nanoseconds GetFenceWaitTime() const;
+
+		// @brief Zones of every frame, the whole frame, graph compilation, each pass, culling and post render
+		GPUProfiler& GetProfiler();
 
 	protected:
 		virtual void PostRender(Scene& scene);
 
-		const Window& m_Window;
 		AutoRelease<GLuint> m_DummyVAO;
 		CommandBuffer m_CommandBuffer;
 		CommandBuffer m_PostProcessingCommandBuffer;
+		GPUCuller m_GPUCuller;
+		CullingMode m_CullingMode;
+		GPULightClusterer m_GPULightClusterer;
+		ClusterAssignment m_ClusterAssignment;
+		ClusterLights m_ClusterLights;
+		ClusterStats m_ClusterStats;
 		Entity m_PostProcessSprite;
-		MultiBuffer<PersistentBuffer> m_CameraBuffer;
-		MultiBuffer<PersistentBuffer> m_LightBuffer;
-		MultiBuffer<PersistentBuffer> m_ObjectDataBuffer;
+		TransientAllocator m_TransientAllocator;
+		size_t m_StorageAlignment;
 		Program m_GBufferProgram;
 		Program m_LightPassProgram;
 		Sampler m_FBSampler;
-		RenderTarget m_GBufferRT;
-		RenderTarget m_LightPassRT;
+		RenderGraph m_RenderGraph;
+		uint32_t m_RenderWidth;
+		uint32_t m_RenderHeight;
+		std::optional<DynamicResolution> m_DynamicResolution;
+		std::vector<uint32_t> m_GBufferTextures;	// render graph resources of the last frame
+		std::chrono::nanoseconds m_FenceWaitTime;
+		GPUProfiler m_Profiler;
 	};
 
 }
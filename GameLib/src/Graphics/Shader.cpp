@@ -13,6 +13,7 @@ namespace {
 		{
 			case Game::ShaderType::VERTEX: return GL_VERTEX_SHADER;
 			case Game::ShaderType::FRAGMENT: return GL_FRAGMENT_SHADER;
+			case Game::ShaderType::COMPUTE: return GL_COMPUTE_SHADER;
 		}
 
 		throw Game::Exception("Unknown shader type: {}", std::to_underlying(type));
@@ -66,6 +67,7 @@ namespace Game {
 		{
 			case ShaderType::VERTEX: return "VERTEX";
 			case ShaderType::FRAGMENT: return "FRAGMENT";
+			case ShaderType::COMPUTE: return "COMPUTE";
 		}
 
 		throw Exception("Unknown shader type: {}", std::to_underlying(obj));
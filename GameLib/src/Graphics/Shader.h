@@ -11,7 +11,8 @@ namespace Game {
 	enum class ShaderType
 	{
 		VERTEX,
-		FRAGMENT
+		FRAGMENT,
+		COMPUTE
 	};
 
 	class Shader
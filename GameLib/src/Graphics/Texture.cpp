@@ -1,5 +1,6 @@
 #include "Texture.h"
 
+#include "GPUMemory.h"
 #include "Utils/Error.h"
 
 namespace {
@@ -12,11 +13,32 @@ namespace {
 			case Game::TextureFormat::RGB: return includeSize ? GL_RGB8 : GL_RGB;
 			case Game::TextureFormat::RGBA: return includeSize ? GL_RGBA8 : GL_RGBA;
 			case Game::TextureFormat::RGB16F: return GL_RGB16F;
+			case Game::TextureFormat::RG16_SNORM: return includeSize ? GL_RG16_SNORM : GL_RG;
 			case Game::TextureFormat::DEPTH24: return GL_DEPTH_COMPONENT24;
 		}
 		throw Game::Exception("Unknown texture format: {}", format);
 	}
 
+	// @brief Bytes of the single mip level, drivers pad three channel formats to four
+	size_t SizeBytes(const Game::TextureData& texture)
+	{
+		const auto bytesPerPixel = [&]
+			{
+				switch (texture.format)
+				{
+					case Game::TextureFormat::RED: return 1zu;
+					case Game::TextureFormat::RGB: return 4zu;
+					case Game::TextureFormat::RGBA: return 4zu;
+					case Game::TextureFormat::RGB16F: return 8zu;
+					case Game::TextureFormat::RG16_SNORM: return 4zu;
+					case Game::TextureFormat::DEPTH24: return 4zu;
+				}
+				throw Game::Exception("Unknown texture format: {}", texture.format);
+			}();
+
+		return static_cast<size_t>(texture.width) * texture.height * bytesPerPixel;
+	}
+
 }
 
 namespace Game {
@@ -27,6 +49,7 @@ namespace Game {
 		, m_Name{ name }
 		, m_Width{ texture.width }
 		, m_Height{ texture.height }
+		, m_MemoryRegistration{ GPUMemory::Register(GPUMemoryCategory::TEXTURE, name, SizeBytes(texture)) }
 	{
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_Handle);
 		glObjectLabel(GL_TEXTURE, m_Handle, name.length(), name.data());
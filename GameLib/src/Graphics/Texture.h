@@ -28,6 +28,7 @@ namespace Game {
 		std::string m_Name;
 		uint32_t m_Width;
 		uint32_t m_Height;
+		AutoRelease<uint64_t> m_MemoryRegistration;
 	};
 
 }
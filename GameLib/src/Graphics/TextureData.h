@@ -13,6 +13,7 @@ namespace Game {
 		RGB,
 		RGBA,
 		RGB16F,
+		RG16_SNORM,
 		DEPTH24
 	};
 
@@ -32,6 +33,7 @@ namespace Game {
 			case TextureFormat::RGB: return "RGB";
 			case TextureFormat::RGBA: return "RGBA";
 			case TextureFormat::RGB16F: return "RGB16F";
+			case TextureFormat::RG16_SNORM: return "RG16_SNORM";
 			case TextureFormat::DEPTH24: return "DEPTH24";
 			default: return "unknown";
 		}
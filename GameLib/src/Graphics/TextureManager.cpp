@@ -1,11 +1,14 @@
 #include "TextureManager.h"
 
+#include "DeferredDeletion.h"
 #include "Utils.h"
 #include "Utils\Error.h"
 #include "Utils\Log.h"
 
+#include <memory>
 #include <span>
 #include <ranges>
+#include <utility>
 
 namespace Game {
 
@@ -43,6 +46,16 @@ namespace Game {
 		return newIndex;
 	}
 
+	void TextureManager::Replace(uint32_t index, Texture texture)
+	{
+		Expect(index < m_Textures.size(), "index {} out of range", index);
+
+		DeferredDeletion::Retire(std::make_shared<Texture>(std::exchange(m_Textures[index], std::move(texture))));
+		m_CPUBuffer[index] = m_Textures[index].GetBindlessHandle();
+
+		m_GPUBuffer.Write(std::as_bytes(std::span{ m_CPUBuffer }.subspan(index, 1zu)), index * sizeof(GLuint64));
+	}
+
 	GLuint TextureManager::GetNativeHandle() const
 	{
 		return m_GPUBuffer.GetNativeHandle();
@@ -16,6 +16,8 @@ namespace Game {
 
         uint32_t Add(Texture texture);
         uint32_t Add(std::vector<Texture> textures);
+        // @brief Puts texture at index, the texture it replaces stays resident until frames in flight no longer use it
+        void Replace(uint32_t index, Texture texture);
 
         GLuint GetNativeHandle() const;
 
@@ -0,0 +1,150 @@
+#include "TransientAllocator.h"
+
+#include "DeferredDeletion.h"
+#include "Utils.h"
+#include "Utils/Error.h"
+#include "Utils/Log.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <utility>
+
+namespace {
+
+	uint64_t RoundUp(uint64_t value, uint64_t multiple)
+	{
+		return ((value + multiple - 1u) / multiple) * multiple;
+	}
+
+	bool IsSignalled(GLsync fence)
+	{
+		const auto result = glClientWaitSync(fence, 0u, 0u);
+		return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+	}
+
+}
+
+namespace Game {
+
+	void TransientAllocation::Bind(GLenum target, GLuint index) const
+	{
+		glBindBufferRange(target, index, buffer, offset, data.size());
+	}
+
+	std::string TransientAllocatorStats::to_string() const
+	{
+		return std::format("{} of {} bytes last frame, high water mark {}, grown {} times, waited {}",
+			frameBytes, capacity, highWaterMark, growCount, std::chrono::duration_cast<std::chrono::microseconds>(waitTime));
+	}
+
+	TransientAllocator::TransientAllocator(size_t capacity, TransientOverflow overflow, std::string_view name)
+		: m_Buffer{}
+		, m_Capacity{}
+		, m_Overflow{ overflow }
+		, m_Name{ name }
+		, m_Head{}
+		, m_Tail{}
+		, m_Frames{}
+		, m_FrameBytes{}
+		, m_WaitTime{}
+		, m_Stats{}
+	{
+		Recreate(capacity);
+	}
+
+	TransientAllocation TransientAllocator::Allocate(size_t size, size_t align)
+	{
+		Expect(std::has_single_bit(align) && align <= kMaxAlignment, "Invalid alignment {} for {}", align, m_Name);
+		size = std::max(size, 1zu);
+
+		for (;;)
+		{
+			// the capacity is a multiple of kMaxAlignment so aligned positions are aligned offsets
+			auto position = RoundUp(m_Head, align);
+			if (position % m_Capacity + size > m_Capacity)
+			{
+				// does not fit before the end, the gap is skipped and reclaimed with the rest of the frame
+				position = RoundUp(position, m_Capacity);
+			}
+			const auto end = position + size;
+
+			while (end - m_Tail > m_Capacity && !m_Frames.empty())
+			{
+				m_WaitTime += WaitForFence(m_Frames.front().fence);
+				m_Tail = m_Frames.front().end;
+				m_Frames.pop_front();
+			}
+
+			if (end - m_Tail <= m_Capacity)
+			{
+				m_FrameBytes += static_cast<size_t>(end - m_Head);
+				m_Head = end;
+
+				const auto offset = static_cast<size_t>(position % m_Capacity);
+				return { .data = m_Buffer->Map(offset, size), .offset = offset, .buffer = m_Buffer->GetNativeHandle() };
+			}
+
+			// this frame alone does not fit, anything allocated from the old ring stays valid until the frame is done
+			Ensure(m_Overflow == TransientOverflow::GROW, "Transient allocator {} of {} bytes cannot fit {} more bytes this frame", m_Name, m_Capacity, size);
+
+			const auto capacity = std::max(m_Capacity * 2zu, static_cast<size_t>(m_Head - m_Tail) + size + kMaxAlignment);
+			Log::Warn("Transient allocator {} overflowed, growing {} -> {}", m_Name, m_Capacity, capacity);
+			Recreate(capacity);
+			++m_Stats.growCount;
+		}
+	}
+
+	void TransientAllocator::Reserve(size_t capacity)
+	{
+		if (capacity > m_Capacity)
+		{
+			Log::Info("Reserving transient allocator {} {} -> {}", m_Name, m_Capacity, capacity);
+			Recreate(capacity);
+		}
+	}
+
+	void TransientAllocator::EndFrame()
+	{
+		m_Frames.push_back({ .fence = { glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u), glDeleteSync }, .end = m_Head });
+
+		while (!m_Frames.empty() && IsSignalled(m_Frames.front().fence))
+		{
+			m_Tail = m_Frames.front().end;
+			m_Frames.pop_front();
+		}
+
+		m_Stats.capacity = m_Capacity;
+		m_Stats.frameBytes = std::exchange(m_FrameBytes, 0zu);
+		m_Stats.highWaterMark = std::max(m_Stats.highWaterMark, m_Stats.frameBytes);
+		m_Stats.waitTime = std::exchange(m_WaitTime, {});
+	}
+
+	TransientAllocatorStats TransientAllocator::GetStats() const
+	{
+		return m_Stats;
+	}
+
+	std::string TransientAllocator::to_string() const
+	{
+		return std::format("Transient allocator {} ({}): {}", m_Name, m_Overflow, m_Stats);
+	}
+
+	void TransientAllocator::Recreate(size_t capacity)
+	{
+		capacity = RoundUp(capacity, kMaxAlignment);
+		if (m_Buffer)
+		{
+			DeferredDeletion::Retire(std::move(m_Buffer));
+		}
+
+		m_Buffer = std::make_shared<PersistentBuffer>(capacity, m_Name);
+		m_Capacity = capacity;
+		m_Head = 0u;
+		m_Tail = 0u;
+		// the frames in flight only used the old buffer which deferred deletion keeps alive for them
+		m_Frames.clear();
+		m_Stats.capacity = capacity;
+	}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "PersistentBuffer.h"
+#include "Utils/AutoRelease.h"
+#include "OpenGL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Game {
+
+	// @brief What Allocate does when a single frame needs more than the whole ring
+	enum class TransientOverflow
+	{
+		GROW,	// replace the ring with a larger one, the old one is retired once the GPU is done with this frame
+		FAIL	// throw, for rings sized from a budget where exceeding it is a bug
+	};
+
+	inline std::string to_string(TransientOverflow overflow)
+	{
+		switch (overflow)
+		{
+			case TransientOverflow::GROW: return "GROW";
+			case TransientOverflow::FAIL: return "FAIL";
+			default: return "unknown";
+		}
+	}
+
+	// @brief Suballocation of a transient ring, writable until the end of the frame it was made in
+	struct TransientAllocation
+	{
+		std::span<std::byte> data;
+		size_t offset;	// in buffer
+		GLuint buffer;
+
+		template<class T>
+			requires std::is_trivially_copyable_v<T>
+		std::span<T> As() const
+		{
+			return { reinterpret_cast<T*>(data.data()), data.size() / sizeof(T) };
+		}
+
+		void Bind(GLenum target, GLuint index) const;
+	};
+
+	struct TransientAllocatorStats
+	{
+		size_t capacity;
+		size_t frameBytes;		// allocated during the last completed frame, alignment and wrap padding included
+		size_t highWaterMark;	// largest frameBytes so far
+		size_t growCount;
+		std::chrono::nanoseconds waitTime;	// the last completed frame spent blocked on fences because the ring was full
+
+		std::string to_string() const;
+	};
+
+	// @brief One persistently mapped buffer handing out aligned per frame suballocations in ring order.
+	// EndFrame fences what the frame allocated, space is reclaimed once the GPU passes the fence and Allocate only
+	// blocks when the ring is full of frames still in flight.
+	class TransientAllocator
+	{
+	public:
+		static constexpr auto kMaxAlignment = 256zu;
+
+		TransientAllocator(size_t capacity, TransientOverflow overflow, std::string_view name);
+
+		// @brief align must be a power of two no larger than kMaxAlignment. A zero size still gets a byte so the range can be bound
+		TransientAllocation Allocate(size_t size, size_t align);
+
+		template<class T>
+		TransientAllocation Allocate(size_t count, size_t align)
+		{
+			return Allocate(count * sizeof(T), std::max(align, alignof(T)));
+		}
+
+		// @brief Grows the ring to at least capacity bytes, meant for load time so no frame ever overflows
+		void Reserve(size_t capacity);
+
+		// @brief Call once all commands reading this frame's allocations have been issued
+		void EndFrame();
+
+		TransientAllocatorStats GetStats() const;
+		std::string to_string() const;
+
+	private:
+		struct Frame
+		{
+			AutoRelease<GLsync> fence;
+			uint64_t end;
+		};
+
+		void Recreate(size_t capacity);
+
+		std::shared_ptr<PersistentBuffer> m_Buffer;
+		size_t m_Capacity;
+		TransientOverflow m_Overflow;
+		std::string m_Name;
+		// positions only ever increase, the offset in the buffer is position % capacity
+		uint64_t m_Head;
+		uint64_t m_Tail;	// everything before it has been released by the GPU
+		std::deque<Frame> m_Frames;	// in flight, oldest first
+		size_t m_FrameBytes;
+		std::chrono::nanoseconds m_WaitTime;
+		TransientAllocatorStats m_Stats;
+	};
+
+}
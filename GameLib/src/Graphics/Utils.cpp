@@ -3,6 +3,7 @@
 #include "Utils/Error.h"
 #include "Utils/Log.h"
 
+#include <chrono>
 #include <filesystem>
 #include <memory>
 #include <span>
@@ -69,6 +70,25 @@ namespace {
 
 namespace Game {
 
+	std::chrono::nanoseconds WaitForFence(GLsync fence)
+	{
+		constexpr auto timeout = GLuint64{ 1'000'000'000u };
+
+		const auto start = std::chrono::steady_clock::now();
+		for (;;)
+		{
+			const auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+			Ensure(result != GL_WAIT_FAILED, "Failed to wait for fence");
+
+			if (result != GL_TIMEOUT_EXPIRED)
+			{
+				break;
+			}
+		}
+
+		return std::chrono::steady_clock::now() - start;
+	}
+
 	TextureData LoadTexture(DataBufferView imageData)
 	{
 		int width{};
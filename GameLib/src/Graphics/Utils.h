@@ -7,8 +7,11 @@
 #include "Resources/ResourceLoader.h"
 #include "OpenGL.h"
 
+#include "DeferredDeletion.h"
 #include "ModelData.h"
 
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <ranges>
 #include <string_view>
@@ -32,10 +35,13 @@ namespace Game {
 		) | std::ranges::to<std::vector>();
 	}
 
+	// @brief Grows the GPU buffer to fit count elements of T without stalling, returns true when the buffer was recreated.
+	// Buffers only the GPU writes keep their contents through a GPU side copy, mapped ones start empty as their producers
+	// rewrite them anyway. The old buffer is retired to the deferred deletion queue until the GPU is done with it
 	template<class T, IsBuffer Buffer>
-	void ResizeGPUBuffer(const std::vector<T>& cpuBuffer, Buffer& gpuBuffer)
+	bool ResizeGPUBuffer(size_t count, Buffer& gpuBuffer)
 	{
-		const auto bufferSizeBytes = cpuBuffer.size() * sizeof(T);
+		const auto bufferSizeBytes = count * sizeof(T);
 		if (gpuBuffer.GetSize() <= bufferSizeBytes)
 		{
 			auto newSize = gpuBuffer.GetSize() * 2zu;
@@ -46,13 +52,31 @@ namespace Game {
 
 			Game::Log::Info("Growing {} buffer {} -> {}", gpuBuffer.GetName(), gpuBuffer.GetSize(), newSize);
 
-			// OpenGL barrier in case gpu using previous frame
-			glFinish();
+			auto grown = Buffer{ newSize, gpuBuffer.GetName() };
+			if constexpr (requires { gpuBuffer.CopyTo(grown); })
+			{
+				gpuBuffer.CopyTo(grown);
+			}
+
+			DeferredDeletion::Retire(std::make_shared<Buffer>(std::move(gpuBuffer)));
+			gpuBuffer = std::move(grown);
 
-			gpuBuffer = Buffer{ newSize, gpuBuffer.GetName() };
+			return true;
 		}
+
+		return false;
 	}
 
+	// @brief Grows the GPU buffer to fit the CPU buffer, returns true when the buffer was recreated
+	template<class T, IsBuffer Buffer>
+	bool ResizeGPUBuffer(const std::vector<T>& cpuBuffer, Buffer& gpuBuffer)
+	{
+		return ResizeGPUBuffer<T>(cpuBuffer.size(), gpuBuffer);
+	}
+
+	// @brief Blocks until the GPU has passed the fence, flushing pending commands first, and returns how long that took
+	std::chrono::nanoseconds WaitForFence(GLsync fence);
+
 	TextureData LoadTexture(DataBufferView imageData);
 	std::vector<ModelData> LoadModel(DataBufferView modelData, ResourceLoader& resourceLoader);
 
@@ -0,0 +1,215 @@
+#include "VertexData.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	int16_t PackSnorm(float value)
+	{
+		return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	float UnpackSnorm(int16_t value)
+	{
+		return std::clamp(static_cast<float>(value) / 32767.0f, -1.0f, 1.0f);
+	}
+
+	uint16_t PackUnorm(float value)
+	{
+		return static_cast<uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	float UnpackUnorm(uint16_t value)
+	{
+		return static_cast<float>(value) / 65535.0f;
+	}
+
+	// @brief Projects the unit vector onto the octahedron and folds the lower half over the upper one
+	void OctahedralEncode(const Game::vec3& v, int16_t (&out)[2])
+	{
+		const auto l1 = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+		if (l1 == 0.0f)
+		{
+			out[0] = 0;
+			out[1] = 0;
+			return;
+		}
+
+		auto x = v.x / l1;
+		auto y = v.y / l1;
+		if (v.z < 0.0f)
+		{
+			const auto foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+			const auto foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		out[0] = PackSnorm(x);
+		out[1] = PackSnorm(y);
+	}
+
+	Game::vec3 OctahedralDecode(const int16_t (&in)[2])
+	{
+		auto v = Game::vec3{ UnpackSnorm(in[0]), UnpackSnorm(in[1]), 0.0f };
+		v.z = 1.0f - std::abs(v.x) - std::abs(v.y);
+		if (v.z < 0.0f)
+		{
+			const auto x = (1.0f - std::abs(v.y)) * SignNotZero(v.x);
+			const auto y = (1.0f - std::abs(v.x)) * SignNotZero(v.y);
+			v.x = x;
+			v.y = y;
+		}
+
+		return Game::vec3::Normalize(v);
+	}
+
+}
+
+namespace Game {
+
+	PositionQuantization PositionQuantization::Identity()
+	{
+		return { .offset = { 0.0f }, .scale = { 1.0f } };
+	}
+
+	PositionQuantization PositionQuantization::FromBounds(const AABB& bounds)
+	{
+		if (bounds.IsEmpty())
+		{
+			return Identity();
+		}
+
+		return { .offset = bounds.min, .scale = bounds.Extent() };
+	}
+
+	PackedVertexData Pack(const VertexData& vertex, const PositionQuantization& quantization)
+	{
+		const auto quantize = [](float value, float offset, float scale)
+		{
+			return scale > 0.0f ? PackUnorm((value - offset) / scale) : uint16_t{ 0u };
+		};
+
+		auto packed = PackedVertexData{
+			.position = {
+				quantize(vertex.position.x, quantization.offset.x, quantization.scale.x),
+				quantize(vertex.position.y, quantization.offset.y, quantization.scale.y),
+				quantize(vertex.position.z, quantization.offset.z, quantization.scale.z),
+			},
+			.bitangentSign = vec3::Dot(vec3::Cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? int16_t{ -32767 } : int16_t{ 32767 },
+			.normal = {},
+			.tangent = {},
+			.uv = { FloatToHalf(vertex.uv.s), FloatToHalf(vertex.uv.t) }
+		};
+
+		OctahedralEncode(vertex.normal, packed.normal);
+		OctahedralEncode(vertex.tangent, packed.tangent);
+
+		return packed;
+	}
+
+	VertexData Unpack(const PackedVertexData& vertex, const PositionQuantization& quantization)
+	{
+		const auto position = vec3{ UnpackUnorm(vertex.position[0]), UnpackUnorm(vertex.position[1]), UnpackUnorm(vertex.position[2]) };
+		const auto normal = OctahedralDecode(vertex.normal);
+		const auto tangent = OctahedralDecode(vertex.tangent);
+
+		return {
+			.position = quantization.offset + quantization.scale * position,
+			.normal = normal,
+			.tangent = tangent,
+			.bitangent = vec3::Cross(normal, tangent) * vec3{ UnpackSnorm(vertex.bitangentSign) },
+			.uv = { HalfToFloat(vertex.uv[0]), HalfToFloat(vertex.uv[1]) }
+		};
+	}
+
+	AABB Bounds(std::span<const VertexData> vertices)
+	{
+		auto bounds = AABB{};
+		for (const auto& vertex : vertices)
+		{
+			bounds.Grow(vertex.position);
+		}
+
+		return bounds;
+	}
+
+	uint16_t FloatToHalf(float value)
+	{
+		const auto bits = std::bit_cast<uint32_t>(value);
+		const auto sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+		const auto floatExponent = static_cast<int32_t>((bits >> 23u) & 0xffu);
+		auto mantissa = bits & 0x7fffffu;
+
+		if (floatExponent == 0xff)
+		{
+			// keep NaNs quiet, infinities stay infinite
+			return static_cast<uint16_t>(sign | 0x7c00u | (mantissa != 0u ? 0x200u : 0u));
+		}
+
+		const auto exponent = floatExponent - 127 + 15;
+		if (exponent >= 31)
+		{
+			return static_cast<uint16_t>(sign | 0x7c00u);
+		}
+
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+			{
+				return sign;
+			}
+
+			// subnormal half, shift the mantissa with its implicit bit down and round to nearest even
+			mantissa |= 0x800000u;
+			const auto shift = static_cast<uint32_t>(14 - exponent);
+			auto half = mantissa >> shift;
+			const auto remainder = mantissa & ((1u << shift) - 1u);
+			const auto halfway = 1u << (shift - 1u);
+			if (remainder > halfway || (remainder == halfway && (half & 1u) != 0u))
+			{
+				++half;
+			}
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		// a carry out of the mantissa correctly bumps the exponent, up to infinity
+		auto half = (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+		const auto remainder = mantissa & 0x1fffu;
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0u))
+		{
+			++half;
+		}
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		const auto sign = static_cast<uint32_t>(value & 0x8000u) << 16u;
+		const auto exponent = (value >> 10u) & 0x1fu;
+		const auto mantissa = static_cast<uint32_t>(value & 0x3ffu);
+
+		if (exponent == 0u)
+		{
+			const auto magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+			return sign != 0u ? -magnitude : magnitude;
+		}
+
+		if (exponent == 31u)
+		{
+			return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+		}
+
+		return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+	}
+
+}
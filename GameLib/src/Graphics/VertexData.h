@@ -1,8 +1,13 @@
 #pragma once
 
+#include "Math/AABB.h"
 #include "Math/Vector3.h"
 #include "Color.h"
 
+#include <cstdint>
+#include <span>
+#include <string>
+
 namespace Game {
 
 	struct UV
@@ -22,4 +27,61 @@ namespace Game {
 
 	static_assert(sizeof(VertexData) == sizeof(float) * 3 + sizeof(float) * 3 + sizeof(float) * 3 + sizeof(float) * 3 + sizeof(float) * 2);
 
+	// @brief Layout of the vertices in the mesh pool, shaders pick the matching decode through a uniform
+	enum class VertexFormat : uint32_t
+	{
+		FULL,
+		PACKED
+	};
+
+	// @brief Compressed vertex, decoded in the vertex shader with the unpack*2x16 built-ins:
+	// position as unorm16 within the mesh bounds, normal and tangent as snorm16 octahedral vectors,
+	// the bitangent as a sign against cross(normal, tangent) and the uv as half floats
+	struct PackedVertexData
+	{
+		uint16_t position[3];
+		int16_t bitangentSign;	// snorm16 +-1
+		int16_t normal[2];
+		int16_t tangent[2];
+		uint16_t uv[2];
+	};
+
+	static_assert(sizeof(PackedVertexData) == 20);
+
+	// @brief Maps decoded positions back to object space as offset + scale * position.
+	// Packed positions decode to [0, 1] so the scale is the extent of the mesh, full positions use the identity.
+	struct PositionQuantization
+	{
+		vec3 offset;
+		vec3 scale;
+
+		static PositionQuantization Identity();
+		static PositionQuantization FromBounds(const AABB& bounds);
+	};
+
+	PackedVertexData Pack(const VertexData& vertex, const PositionQuantization& quantization);
+
+	// @brief Inverse of Pack, performs the same arithmetic as the decode in gbuffer.vert
+	VertexData Unpack(const PackedVertexData& vertex, const PositionQuantization& quantization);
+
+	AABB Bounds(std::span<const VertexData> vertices);
+
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	inline std::string to_string(VertexFormat format)
+	{
+		switch (format)
+		{
+			case VertexFormat::FULL: return "FULL";
+			case VertexFormat::PACKED: return "PACKED";
+			default: return "unknown";
+		}
+	}
+
+	constexpr size_t VertexSize(VertexFormat format)
+	{
+		return format == VertexFormat::PACKED ? sizeof(PackedVertexData) : sizeof(VertexData);
+	}
+
 }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Matrix4.h"
+#include "Ray.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <optional>
+
+namespace Game {
+
+	struct AABB
+	{
+		constexpr AABB()
+			: min{ std::numeric_limits<float>::max() }
+			, max{ std::numeric_limits<float>::lowest() }
+		{}
+
+		constexpr AABB(const vec3& min, const vec3& max)
+			: min{ min }
+			, max{ max }
+		{}
+
+		constexpr bool IsEmpty() const
+		{
+			return min.x > max.x || min.y > max.y || min.z > max.z;
+		}
+
+		constexpr void Grow(const vec3& point)
+		{
+			min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+			max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+		}
+
+		constexpr void Grow(const AABB& other)
+		{
+			if (other.IsEmpty())
+				return;
+
+			Grow(other.min);
+			Grow(other.max);
+		}
+
+		constexpr vec3 Centroid() const
+		{
+			return (min + max) * vec3{ 0.5f };
+		}
+
+		constexpr vec3 Extent() const
+		{
+			return max - min;
+		}
+
+		constexpr float SurfaceArea() const
+		{
+			if (IsEmpty())
+				return 0.0f;
+
+			const auto e = Extent();
+			return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+		}
+
+		constexpr bool Overlaps(const AABB& other) const
+		{
+			return min.x <= other.max.x && max.x >= other.min.x &&
+				   min.y <= other.max.y && max.y >= other.min.y &&
+				   min.z <= other.max.z && max.z >= other.min.z;
+		}
+
+		// @brief Bounds of this box after transforming all eight corners
+		constexpr AABB Transform(const mat4& transform) const
+		{
+			if (IsEmpty())
+				return {};
+
+			auto result = AABB{};
+			for (auto corner = 0u; corner < 8u; ++corner)
+			{
+				const auto point = vec4{
+					(corner & 1u) ? max.x : min.x,
+					(corner & 2u) ? max.y : min.y,
+					(corner & 4u) ? max.z : min.z,
+					1.0f
+				};
+				result.Grow(transform * point);
+			}
+
+			return result;
+		}
+
+		// @brief Slab test, returns the entry distance if the ray hits the box closer than maxDistance
+		constexpr std::optional<float> Intersect(const Ray& ray, const vec3& invDirection, float maxDistance) const
+		{
+			const auto t0 = (min - ray.origin) * invDirection;
+			const auto t1 = (max - ray.origin) * invDirection;
+
+			const auto tEntry = std::max({ std::min(t0.x, t1.x), std::min(t0.y, t1.y), std::min(t0.z, t1.z), 0.0f });
+			const auto tExit = std::min({ std::max(t0.x, t1.x), std::max(t0.y, t1.y), std::max(t0.z, t1.z), maxDistance });
+
+			return tEntry <= tExit ? std::make_optional(tEntry) : std::nullopt;
+		}
+
+		constexpr bool operator==(const AABB&) const = default;
+
+		std::string to_string() const;
+
+		vec3 min;
+		vec3 max;
+	};
+
+	inline std::string AABB::to_string() const
+	{
+		return std::format("min: {}, max: {}", min, max);
+	}
+
+	constexpr vec3 InverseDirection(const vec3& direction)
+	{
+		return vec3{ 1.0f } / direction;
+	}
+
+}
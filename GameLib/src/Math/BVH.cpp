@@ -0,0 +1,416 @@
+#include "BVH.h"
+
+#include "Utils.h"
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <ranges>
+
+namespace {
+
+	constexpr auto kBinCount = 16u;
+	constexpr auto kTraversalCost = 1.0f;
+
+	struct BuildPrimitive
+	{
+		Game::AABB bounds;
+		Game::vec3 centroid;
+	};
+
+	struct Bin
+	{
+		Game::AABB bounds;
+		uint32_t count = 0u;
+	};
+
+	struct Split
+	{
+		uint32_t axis;
+		uint32_t bin;	// first bin of the right side
+		float cost;
+	};
+
+	constexpr float Axis(const Game::vec3& v, uint32_t axis)
+	{
+		return axis == 0u ? v.x : axis == 1u ? v.y : v.z;
+	}
+
+	struct ObjectRay
+	{
+		Game::Ray ray;
+		float scale;	// object space length of one world space unit along the ray
+	};
+
+	ObjectRay ToObjectSpace(const Game::Ray& ray, const Game::mat4& invTransform)
+	{
+		const auto direction = Game::vec3{ invTransform * Game::vec4{ ray.direction, 0.0f } };
+		return { .ray = Game::Ray{ invTransform * Game::vec4{ ray.origin, 1.0f }, direction }, .scale = direction.Length() };
+	}
+
+	uint32_t BinIndex(float centroid, float centroidMin, float scale)
+	{
+		const auto bin = static_cast<uint32_t>((centroid - centroidMin) * scale);
+		return std::min(bin, kBinCount - 1u);
+	}
+
+	std::optional<Split> FindSplit(std::span<const BuildPrimitive> primitives, std::span<const uint32_t> order, const Game::AABB& centroidBounds)
+	{
+		auto best = std::optional<Split>{};
+
+		for (auto axis = 0u; axis < 3u; ++axis)
+		{
+			const auto centroidMin = Axis(centroidBounds.min, axis);
+			const auto extent = Axis(centroidBounds.max, axis) - centroidMin;
+			if (extent <= 0.0f)
+			{
+				continue;
+			}
+
+			const auto scale = static_cast<float>(kBinCount) / extent;
+
+			auto bins = std::array<Bin, kBinCount>{};
+			for (const auto index : order)
+			{
+				auto& bin = bins[BinIndex(Axis(primitives[index].centroid, axis), centroidMin, scale)];
+				bin.bounds.Grow(primitives[index].bounds);
+				++bin.count;
+			}
+
+			// sweep from both sides, splitting before bin i puts bins [0, i) on the left
+			auto leftArea = std::array<float, kBinCount - 1u>{};
+			auto leftCount = std::array<uint32_t, kBinCount - 1u>{};
+			auto bounds = Game::AABB{};
+			auto count = 0u;
+			for (auto i = 0u; i < kBinCount - 1u; ++i)
+			{
+				bounds.Grow(bins[i].bounds);
+				count += bins[i].count;
+				leftArea[i] = bounds.SurfaceArea();
+				leftCount[i] = count;
+			}
+
+			bounds = {};
+			count = 0u;
+			for (auto i = kBinCount - 1u; i > 0u; --i)
+			{
+				bounds.Grow(bins[i].bounds);
+				count += bins[i].count;
+
+				if (leftCount[i - 1u] == 0u || count == 0u)
+				{
+					continue;
+				}
+
+				const auto cost = static_cast<float>(leftCount[i - 1u]) * leftArea[i - 1u] + static_cast<float>(count) * bounds.SurfaceArea();
+				if (!best || cost < best->cost)
+				{
+					best = Split{ .axis = axis, .bin = i, .cost = cost };
+				}
+			}
+		}
+
+		return best;
+	}
+
+}
+
+namespace Game {
+
+	BVHBuildResult BuildBVH(std::span<const AABB> bounds, uint32_t maxLeafSize)
+	{
+		Expect(maxLeafSize > 0u, "Leaf size must not be zero");
+
+		const auto primitiveCount = static_cast<uint32_t>(bounds.size());
+		if (primitiveCount == 0u)
+		{
+			return {};
+		}
+
+		const auto primitives = bounds |
+			std::views::transform([](const auto& b) { return BuildPrimitive{ .bounds = b, .centroid = b.Centroid() }; }) |
+			std::ranges::to<std::vector>();
+
+		auto result = BVHBuildResult{ .nodes = {}, .order = std::vector<uint32_t>(primitiveCount) };
+		auto& nodes = result.nodes;
+		std::iota(std::ranges::begin(result.order), std::ranges::end(result.order), 0u);
+
+		nodes.reserve(primitiveCount * 2zu - 1zu);
+		nodes.push_back({ .min = {}, .leftOrFirst = 0u, .max = {}, .count = primitiveCount });
+
+		struct PendingNode
+		{
+			uint32_t index;
+			uint32_t depth;
+		};
+
+		auto pending = std::vector<PendingNode>{ { 0u, 1u } };
+
+		while (!pending.empty())
+		{
+			const auto [nodeIndex, depth] = pending.back();
+			pending.pop_back();
+
+			const auto first = nodes[nodeIndex].leftOrFirst;
+			const auto count = nodes[nodeIndex].count;
+			const auto range = std::span{ result.order }.subspan(first, count);
+
+			auto nodeBounds = AABB{};
+			auto centroidBounds = AABB{};
+			for (const auto index : range)
+			{
+				nodeBounds.Grow(primitives[index].bounds);
+				centroidBounds.Grow(primitives[index].centroid);
+			}
+
+			nodes[nodeIndex].min = nodeBounds.min;
+			nodes[nodeIndex].max = nodeBounds.max;
+
+			if (count == 1u || depth >= kBVHMaxDepth)
+			{
+				continue;
+			}
+
+			auto leftCount = 0u;
+
+			const auto split = FindSplit(primitives, range, centroidBounds);
+			const auto leafCost = static_cast<float>(count) * nodeBounds.SurfaceArea();
+			if (split && kTraversalCost * nodeBounds.SurfaceArea() + split->cost < leafCost)
+			{
+				const auto centroidMin = Axis(centroidBounds.min, split->axis);
+				const auto scale = static_cast<float>(kBinCount) / (Axis(centroidBounds.max, split->axis) - centroidMin);
+				const auto middle = std::ranges::partition(range, [&](auto index)
+					{
+						return BinIndex(Axis(primitives[index].centroid, split->axis), centroidMin, scale) < split->bin;
+					});
+				leftCount = static_cast<uint32_t>(std::ranges::distance(std::ranges::begin(range), std::ranges::begin(middle)));
+			}
+			else if (count > maxLeafSize)
+			{
+				// SAH prefers a leaf (or all centroids coincide) but the leaf would be too large
+				const auto extent = centroidBounds.Extent();
+				const auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0u : extent.y >= extent.z ? 1u : 2u;
+				leftCount = count / 2u;
+				std::ranges::nth_element(range, std::ranges::begin(range) + leftCount, {}, [&](auto index) { return Axis(primitives[index].centroid, axis); });
+			}
+
+			if (leftCount == 0u || leftCount == count)
+			{
+				continue;
+			}
+
+			const auto leftIndex = static_cast<uint32_t>(nodes.size());
+			nodes.push_back({ .min = {}, .leftOrFirst = first, .max = {}, .count = leftCount });
+			nodes.push_back({ .min = {}, .leftOrFirst = first + leftCount, .max = {}, .count = count - leftCount });
+
+			nodes[nodeIndex].leftOrFirst = leftIndex;
+			nodes[nodeIndex].count = 0u;
+
+			pending.push_back({ leftIndex + 1u, depth + 1u });
+			pending.push_back({ leftIndex, depth + 1u });
+		}
+
+		nodes.shrink_to_fit();
+
+		return result;
+	}
+
+	BVH::BVH(std::span<const vec3> positions, std::span<const uint32_t> indices)
+		: m_Nodes{}
+		, m_Triangles{}
+		, m_TriangleIndices{}
+		, m_Bounds{}
+	{
+		Expect(indices.size() % 3zu == 0zu, "Index count {} is not a multiple of 3", indices.size());
+
+		const auto triangleBounds = std::views::iota(0zu, indices.size() / 3zu) |
+			std::views::transform([&](auto triangle)
+								  {
+									  auto bounds = AABB{};
+									  bounds.Grow(positions[indices[triangle * 3zu + 0zu]]);
+									  bounds.Grow(positions[indices[triangle * 3zu + 1zu]]);
+									  bounds.Grow(positions[indices[triangle * 3zu + 2zu]]);
+									  return bounds;
+								  }) |
+			std::ranges::to<std::vector>();
+
+		auto [nodes, order] = BuildBVH(triangleBounds);
+		if (nodes.empty())
+		{
+			return;
+		}
+
+		m_Nodes = std::move(nodes);
+		m_Bounds = { m_Nodes.front().min, m_Nodes.front().max };
+
+		m_Triangles = order |
+			std::views::transform([&](auto triangle)
+								  {
+									  return BVHTriangle{
+										  .v0 = positions[indices[triangle * 3u + 0u]],
+										  .v1 = positions[indices[triangle * 3u + 1u]],
+										  .v2 = positions[indices[triangle * 3u + 2u]]
+									  };
+								  }) |
+			std::ranges::to<std::vector>();
+		m_TriangleIndices = std::move(order);
+	}
+
+	std::optional<BVHHit> BVH::Intersect(const Ray& ray, float maxDistance) const
+	{
+		auto result = std::optional<BVHHit>{};
+
+		TraverseBVH(m_Nodes, ray, maxDistance, [&](const BVHNode& leaf, float closest)
+			{
+				auto distance = std::optional<float>{};
+				for (auto i = leaf.leftOrFirst; i < leaf.leftOrFirst + leaf.count; ++i)
+				{
+					const auto& triangle = m_Triangles[i];
+					if (const auto hit = Game::Intersect(ray, triangle.v0, triangle.v1, triangle.v2); hit && *hit < closest)
+					{
+						closest = *hit;
+						distance = hit;
+						result = BVHHit{ .distance = *hit, .triangle = m_TriangleIndices[i] };
+					}
+				}
+
+				return distance;
+			});
+
+		return result;
+	}
+
+	std::optional<BVHHit> BVH::Intersect(const Ray& ray, const mat4& transform, float maxDistance) const
+	{
+		if (m_Nodes.empty() || !m_Bounds.Transform(transform).Intersect(ray, InverseDirection(ray.direction), maxDistance))
+		{
+			return {};
+		}
+
+		const auto [objectRay, scale] = ToObjectSpace(ray, mat4::Invert(transform));
+
+		return Intersect(objectRay, maxDistance * scale)
+			.transform([scale](auto hit)
+					   {
+						   hit.distance /= scale;
+						   return hit;
+					   });
+	}
+
+	bool BVH::Occluded(const Ray& ray, const mat4& transform, float maxDistance) const
+	{
+		if (m_Nodes.empty())
+		{
+			return false;
+		}
+
+		const auto [objectRay, scale] = ToObjectSpace(ray, mat4::Invert(transform));
+		auto occluded = false;
+
+		// reporting a hit at distance 0 leaves nothing closer to look for, which ends the traversal
+		TraverseBVH(m_Nodes, objectRay, maxDistance * scale, [&](const BVHNode& leaf, float closest)
+			{
+				for (const auto& triangle : std::span{ m_Triangles }.subspan(leaf.leftOrFirst, leaf.count))
+				{
+					if (const auto hit = Game::Intersect(objectRay, triangle.v0, triangle.v1, triangle.v2); hit && *hit < closest)
+					{
+						occluded = true;
+						return std::make_optional(0.0f);
+					}
+				}
+
+				return std::optional<float>{};
+			});
+
+		return occluded;
+	}
+
+	uint32_t BVH::IntersectPacket(const RayPacket& packet, const mat4& transform, PacketDistances& closest, uint32_t activeMask) const
+	{
+		return TraversePacket<false>(packet, transform, closest, activeMask);
+	}
+
+	uint32_t BVH::OccludedPacket(const RayPacket& packet, const mat4& transform, const PacketDistances& maxDistance, uint32_t activeMask) const
+	{
+		auto closest = maxDistance;
+		return TraversePacket<true>(packet, transform, closest, activeMask);
+	}
+
+	template<bool AnyHit>
+	uint32_t BVH::TraversePacket(const RayPacket& packet, const mat4& transform, PacketDistances& closest, uint32_t activeMask) const
+	{
+		if (m_Nodes.empty() || activeMask == 0u)
+		{
+			return 0u;
+		}
+
+		const auto invTransform = mat4::Invert(transform);
+
+		auto objectPacket = RayPacket{};
+		auto scales = PacketDistances{};
+		auto objectClosest = PacketDistances{};
+		for (auto lane = 0u; lane < RayPacket::kSize; ++lane)
+		{
+			const auto [objectRay, scale] = ToObjectSpace(packet.GetRay(lane), invTransform);
+			objectPacket.SetRay(lane, objectRay);
+			scales[lane] = scale;
+			objectClosest[lane] = closest[lane] * scale;
+		}
+
+		auto hitMask = 0u;
+		auto mask = activeMask;
+
+		TraverseBVHPacket(m_Nodes, objectPacket, objectClosest, mask, [&](const BVHNode& leaf)
+			{
+				for (const auto& triangle : std::span{ m_Triangles }.subspan(leaf.leftOrFirst, leaf.count))
+				{
+					const auto hits = Game::IntersectPacket(objectPacket, triangle.v0, triangle.v1, triangle.v2, objectClosest, mask);
+					hitMask |= hits;
+
+					if constexpr (AnyHit)
+					{
+						mask &= ~hits;
+						if (mask == 0u)
+						{
+							return;
+						}
+					}
+				}
+			});
+
+		if constexpr (!AnyHit)
+		{
+			for (auto lane = 0u; lane < RayPacket::kSize; ++lane)
+			{
+				if (hitMask & (1u << lane))
+				{
+					closest[lane] = objectClosest[lane] / scales[lane];
+				}
+			}
+		}
+
+		return hitMask;
+	}
+
+	const AABB& BVH::GetBounds() const
+	{
+		return m_Bounds;
+	}
+
+	std::span<const BVHNode> BVH::GetNodes() const
+	{
+		return m_Nodes;
+	}
+
+	size_t BVH::GetTriangleCount() const
+	{
+		return m_Triangles.size();
+	}
+
+	std::string BVH::to_string() const
+	{
+		return std::format("BVH: nodes {}, triangles {}", m_Nodes.size(), m_Triangles.size());
+	}
+
+}
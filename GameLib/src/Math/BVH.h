@@ -0,0 +1,289 @@
+#pragma once
+
+#include "AABB.h"
+#include "Matrix4.h"
+#include "Ray.h"
+#include "RayPacket.h"
+#include "Vector3.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Game {
+
+	// @brief Flat BVH node, children of an interior node are stored next to each other (left, left + 1)
+	struct BVHNode
+	{
+		vec3 min;
+		uint32_t leftOrFirst;	// first triangle for leaves, left child otherwise
+		vec3 max;
+		uint32_t count;			// 0 for interior nodes
+
+		constexpr bool IsLeaf() const
+		{
+			return count != 0u;
+		}
+	};
+
+	static_assert(sizeof(BVHNode) == 32);
+
+	constexpr auto kBVHMaxDepth = 64u;
+
+	struct BVHBuildResult
+	{
+		std::vector<BVHNode> nodes;
+		std::vector<uint32_t> order;	// primitive indices in leaf order
+	};
+
+	// @brief Binned SAH build over primitive bounds. Leaves larger than maxLeafSize are split at the median
+	// when SAH finds nothing better, so maxLeafSize is a hard limit unless kBVHMaxDepth is reached first.
+	BVHBuildResult BuildBVH(std::span<const AABB> bounds, uint32_t maxLeafSize = std::numeric_limits<uint32_t>::max());
+
+	// @brief Front-to-back closest hit traversal. intersectLeaf(leaf, closest) returns the distance of a hit
+	// closer than closest, subtrees whose entry lies beyond the closest hit so far are skipped.
+	template<class F>
+	void TraverseBVH(std::span<const BVHNode> nodes, const Ray& ray, float maxDistance, F&& intersectLeaf)
+	{
+		if (nodes.empty())
+		{
+			return;
+		}
+
+		const auto invDirection = InverseDirection(ray.direction);
+		if (!AABB{ nodes[0].min, nodes[0].max }.Intersect(ray, invDirection, maxDistance))
+		{
+			return;
+		}
+
+		struct StackEntry
+		{
+			uint32_t node;
+			float entry;
+		};
+
+		auto stack = std::array<StackEntry, kBVHMaxDepth>{};
+		auto stackSize = 0u;
+
+		auto closest = maxDistance;
+		auto nodeIndex = 0u;
+
+		while (true)
+		{
+			const auto& node = nodes[nodeIndex];
+
+			if (node.IsLeaf())
+			{
+				if (const auto distance = intersectLeaf(node, closest); distance)
+				{
+					closest = *distance;
+				}
+			}
+			else
+			{
+				auto nearIndex = node.leftOrFirst;
+				auto farIndex = node.leftOrFirst + 1u;
+				auto nearEntry = AABB{ nodes[nearIndex].min, nodes[nearIndex].max }.Intersect(ray, invDirection, closest);
+				auto farEntry = AABB{ nodes[farIndex].min, nodes[farIndex].max }.Intersect(ray, invDirection, closest);
+
+				if (farEntry && (!nearEntry || *farEntry < *nearEntry))
+				{
+					std::swap(nearIndex, farIndex);
+					std::swap(nearEntry, farEntry);
+				}
+
+				if (nearEntry)
+				{
+					if (farEntry)
+					{
+						stack[stackSize++] = { .node = farIndex, .entry = *farEntry };
+					}
+
+					nodeIndex = nearIndex;
+					continue;
+				}
+			}
+
+			// pop the next node that can still contain a closer hit
+			auto found = false;
+			while (stackSize > 0u && !found)
+			{
+				const auto entry = stack[--stackSize];
+				if (entry.entry < closest)
+				{
+					nodeIndex = entry.node;
+					found = true;
+				}
+			}
+
+			if (!found)
+			{
+				break;
+			}
+		}
+	}
+
+	// @brief Packet version of TraverseBVH, a node is visited when any active lane enters it before its closest hit.
+	// intersectLeaf(leaf) lowers closest for lanes it hits and may clear lanes from activeMask to retire them.
+	template<class F>
+	void TraverseBVHPacket(std::span<const BVHNode> nodes, const RayPacket& packet, PacketDistances& closest, uint32_t& activeMask, F&& intersectLeaf)
+	{
+		if (nodes.empty() || !IntersectPacket(packet, AABB{ nodes[0].min, nodes[0].max }, closest, activeMask))
+		{
+			return;
+		}
+
+		auto stack = std::array<uint32_t, kBVHMaxDepth>{};
+		auto stackSize = 0u;
+		auto nodeIndex = 0u;
+
+		while (activeMask != 0u)
+		{
+			const auto& node = nodes[nodeIndex];
+
+			if (node.IsLeaf())
+			{
+				intersectLeaf(node);
+			}
+			else
+			{
+				auto nearIndex = node.leftOrFirst;
+				auto farIndex = node.leftOrFirst + 1u;
+				auto nearMask = IntersectPacket(packet, AABB{ nodes[nearIndex].min, nodes[nearIndex].max }, closest, activeMask);
+				auto farMask = IntersectPacket(packet, AABB{ nodes[farIndex].min, nodes[farIndex].max }, closest, activeMask);
+
+				// order children along the direction of the first active lane
+				if (nearMask && farMask)
+				{
+					const auto lane = static_cast<uint32_t>(std::countr_zero(activeMask));
+					const auto direction = vec3{ packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane] };
+					const auto nearCentroid = AABB{ nodes[nearIndex].min, nodes[nearIndex].max }.Centroid();
+					const auto farCentroid = AABB{ nodes[farIndex].min, nodes[farIndex].max }.Centroid();
+					if (vec3::Dot(farCentroid - nearCentroid, direction) < 0.0f)
+					{
+						std::swap(nearIndex, farIndex);
+					}
+
+					stack[stackSize++] = farIndex;
+					nodeIndex = nearIndex;
+					continue;
+				}
+
+				if (nearMask || farMask)
+				{
+					nodeIndex = nearMask ? nearIndex : farIndex;
+					continue;
+				}
+			}
+
+			// pop the next node that some lane can still reach before its closest hit
+			auto found = false;
+			while (stackSize > 0u && !found && activeMask != 0u)
+			{
+				const auto index = stack[--stackSize];
+				if (IntersectPacket(packet, AABB{ nodes[index].min, nodes[index].max }, closest, activeMask))
+				{
+					nodeIndex = index;
+					found = true;
+				}
+			}
+
+			if (!found)
+			{
+				break;
+			}
+		}
+	}
+
+	// @brief Visits every leaf whose bounds overlap the box
+	template<class F>
+	void QueryBVH(std::span<const BVHNode> nodes, const AABB& bounds, F&& visitLeaf)
+	{
+		if (nodes.empty())
+		{
+			return;
+		}
+
+		auto stack = std::array<uint32_t, kBVHMaxDepth * 2u>{};
+		auto stackSize = 0u;
+		stack[stackSize++] = 0u;
+
+		while (stackSize > 0u)
+		{
+			const auto& node = nodes[stack[--stackSize]];
+			if (!AABB{ node.min, node.max }.Overlaps(bounds))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				visitLeaf(node);
+			}
+			else
+			{
+				stack[stackSize++] = node.leftOrFirst + 1u;
+				stack[stackSize++] = node.leftOrFirst;
+			}
+		}
+	}
+
+	struct BVHTriangle
+	{
+		vec3 v0;
+		vec3 v1;
+		vec3 v2;
+	};
+
+	struct BVHHit
+	{
+		float distance;
+		uint32_t triangle;	// index of the triangle in the source index buffer
+	};
+
+	// @brief Binned SAH bounding volume hierarchy over the triangles of a single mesh.
+	// Triangle positions are copied in leaf order so queries never touch the mesh vertex data.
+	class BVH
+	{
+	public:
+		BVH() = default;
+		BVH(std::span<const vec3> positions, std::span<const uint32_t> indices);
+
+		// @brief Closest hit along the ray, ignoring anything further than maxDistance
+		std::optional<BVHHit> Intersect(const Ray& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		// @brief Closest hit of a world space ray against an instance of this mesh, distances are in world space.
+		// The world bounds are tested before the transform is inverted so culled instances stay cheap.
+		std::optional<BVHHit> Intersect(const Ray& ray, const mat4& transform, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		// @brief Any hit closer than maxDistance, stops at the first triangle found
+		bool Occluded(const Ray& ray, const mat4& transform, float maxDistance) const;
+
+		// @brief Packet versions of the instance queries. IntersectPacket lowers closest for lanes that hit and returns
+		// their mask, OccludedPacket returns the mask of lanes with any hit closer than maxDistance
+		uint32_t IntersectPacket(const RayPacket& packet, const mat4& transform, PacketDistances& closest, uint32_t activeMask) const;
+		uint32_t OccludedPacket(const RayPacket& packet, const mat4& transform, const PacketDistances& maxDistance, uint32_t activeMask) const;
+
+		const AABB& GetBounds() const;
+		std::span<const BVHNode> GetNodes() const;
+		size_t GetTriangleCount() const;
+
+		std::string to_string() const;
+
+	private:
+		template<bool AnyHit>
+		uint32_t TraversePacket(const RayPacket& packet, const mat4& transform, PacketDistances& closest, uint32_t activeMask) const;
+
+		std::vector<BVHNode> m_Nodes;
+		std::vector<BVHTriangle> m_Triangles;
+		std::vector<uint32_t> m_TriangleIndices;
+		AABB m_Bounds;
+	};
+
+}
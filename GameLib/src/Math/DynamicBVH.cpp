@@ -0,0 +1,174 @@
+#include "DynamicBVH.h"
+
+#include "Utils/Error.h"
+#include "Utils/Log.h"
+
+#include <format>
+#include <ranges>
+
+namespace {
+
+	constexpr auto kMaxLeafSize = 4u;
+	constexpr auto kDefaultRebuildThreshold = 1.5f;
+
+	// @brief SAH weight of a node, interior nodes cost one traversal step, leaves one test per item
+	float Weight(const Game::BVHNode& node)
+	{
+		return node.IsLeaf() ? static_cast<float>(node.count) : 1.0f;
+	}
+
+	float SurfaceArea(const Game::BVHNode& node)
+	{
+		return Game::AABB{ node.min, node.max }.SurfaceArea();
+	}
+
+}
+
+namespace Game {
+
+	DynamicBVH::DynamicBVH()
+		: DynamicBVH(kDefaultRebuildThreshold)
+	{}
+
+	DynamicBVH::DynamicBVH(float rebuildThreshold)
+		: m_Nodes{}
+		, m_Parents{}
+		, m_Items{}
+		, m_ItemLeaves{}
+		, m_ItemBounds{}
+		, m_Cost{}
+		, m_BuildCost{}
+		, m_RebuildThreshold{ rebuildThreshold }
+		, m_RefitCount{}
+		, m_RebuildCount{}
+	{
+		Expect(rebuildThreshold >= 1.0f, "Rebuild threshold {} must be at least 1", rebuildThreshold);
+	}
+
+	void DynamicBVH::Build(std::span<const AABB> bounds)
+	{
+		auto [nodes, order] = BuildBVH(bounds, kMaxLeafSize);
+
+		m_Nodes = std::move(nodes);
+		m_Items = std::move(order);
+		m_ItemBounds.assign(std::ranges::begin(bounds), std::ranges::end(bounds));
+		m_ItemLeaves.resize(bounds.size());
+		m_Parents.resize(m_Nodes.size());
+
+		m_Cost = 0.0f;
+		for (const auto& [index, node] : m_Nodes | std::views::enumerate)
+		{
+			m_Cost += Weight(node) * SurfaceArea(node);
+
+			if (node.IsLeaf())
+			{
+				for (const auto item : std::span{ m_Items }.subspan(node.leftOrFirst, node.count))
+				{
+					m_ItemLeaves[item] = static_cast<uint32_t>(index);
+				}
+			}
+			else
+			{
+				m_Parents[node.leftOrFirst] = static_cast<uint32_t>(index);
+				m_Parents[node.leftOrFirst + 1u] = static_cast<uint32_t>(index);
+			}
+		}
+
+		m_BuildCost = NormalizedCost();
+		++m_RebuildCount;
+	}
+
+	void DynamicBVH::Update(uint32_t item, const AABB& bounds)
+	{
+		Expect(item < m_ItemBounds.size(), "Item {} out of range {}", item, m_ItemBounds.size());
+
+		m_ItemBounds[item] = bounds;
+		++m_RefitCount;
+
+		// walk towards the root until a node's bounds stop changing
+		auto nodeIndex = m_ItemLeaves[item];
+		while (true)
+		{
+			auto& node = m_Nodes[nodeIndex];
+
+			auto nodeBounds = AABB{};
+			if (node.IsLeaf())
+			{
+				for (const auto leafItem : std::span{ m_Items }.subspan(node.leftOrFirst, node.count))
+				{
+					nodeBounds.Grow(m_ItemBounds[leafItem]);
+				}
+			}
+			else
+			{
+				const auto& left = m_Nodes[node.leftOrFirst];
+				const auto& right = m_Nodes[node.leftOrFirst + 1u];
+				nodeBounds = { left.min, left.max };
+				nodeBounds.Grow(AABB{ right.min, right.max });
+			}
+
+			if (nodeBounds == AABB{ node.min, node.max })
+			{
+				break;
+			}
+
+			m_Cost += Weight(node) * (nodeBounds.SurfaceArea() - SurfaceArea(node));
+			node.min = nodeBounds.min;
+			node.max = nodeBounds.max;
+
+			if (nodeIndex == 0u)
+			{
+				break;
+			}
+
+			nodeIndex = m_Parents[nodeIndex];
+		}
+	}
+
+	bool DynamicBVH::RebuildIfDegraded()
+	{
+		if (GetQuality() <= m_RebuildThreshold)
+		{
+			return false;
+		}
+
+		Log::Trace("Rebuilding dynamic BVH, quality {:.2f} exceeds {:.2f}", GetQuality(), m_RebuildThreshold);
+
+		const auto bounds = std::move(m_ItemBounds);
+		Build(bounds);
+
+		return true;
+	}
+
+	size_t DynamicBVH::GetItemCount() const
+	{
+		return m_ItemBounds.size();
+	}
+
+	const AABB& DynamicBVH::GetBounds(uint32_t item) const
+	{
+		return m_ItemBounds[item];
+	}
+
+	float DynamicBVH::GetQuality() const
+	{
+		return m_BuildCost > 0.0f ? NormalizedCost() / m_BuildCost : 1.0f;
+	}
+
+	float DynamicBVH::NormalizedCost() const
+	{
+		if (m_Nodes.empty())
+		{
+			return 0.0f;
+		}
+
+		const auto rootArea = SurfaceArea(m_Nodes.front());
+		return rootArea > 0.0f ? m_Cost / rootArea : 0.0f;
+	}
+
+	std::string DynamicBVH::to_string() const
+	{
+		return std::format("Dynamic BVH: items {}, nodes {}, quality {:.2f}, refits {}, rebuilds {}", m_ItemBounds.size(), m_Nodes.size(), GetQuality(), m_RefitCount, m_RebuildCount);
+	}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "AABB.h"
+#include "BVH.h"
+#include "Ray.h"
+#include "RayPacket.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Game {
+
+	// @brief BVH over boxes that move, e.g. the world bounds of scene entities.
+	// Update refits only the ancestors of the changed item. Refitting keeps the tree valid but lets its quality
+	// drift, so RebuildIfDegraded rebuilds it once its SAH cost exceeds the cost after the last build by the threshold.
+	class DynamicBVH
+	{
+	public:
+		DynamicBVH();
+		explicit DynamicBVH(float rebuildThreshold);
+
+		void Build(std::span<const AABB> bounds);
+		void Update(uint32_t item, const AABB& bounds);
+		bool RebuildIfDegraded();
+
+		// @brief intersectItem(item, closest) returns the distance of a hit closer than closest
+		template<class F>
+		void Intersect(const Ray& ray, float maxDistance, F&& intersectItem) const;
+
+		// @brief Packet traversal, intersectItem(item, mask) gets the lanes that enter the item's bounds before their
+		// closest hit and is expected to lower closest, or clear retired lanes from activeMask
+		template<class F>
+		void IntersectPacket(const RayPacket& packet, PacketDistances& closest, uint32_t& activeMask, F&& intersectItem) const;
+
+		// @brief visit(item) is called for every item whose bounds overlap the box
+		template<class F>
+		void Query(const AABB& bounds, F&& visit) const;
+
+		size_t GetItemCount() const;
+		const AABB& GetBounds(uint32_t item) const;
+
+		// @brief SAH cost relative to the cost right after the last build, 1.0 for a freshly built tree
+		float GetQuality() const;
+
+		std::string to_string() const;
+
+	private:
+		float NormalizedCost() const;
+
+		std::vector<BVHNode> m_Nodes;
+		std::vector<uint32_t> m_Parents;
+		std::vector<uint32_t> m_Items;		// item indices in leaf order
+		std::vector<uint32_t> m_ItemLeaves;
+		std::vector<AABB> m_ItemBounds;
+		float m_Cost;
+		float m_BuildCost;
+		float m_RebuildThreshold;
+		uint32_t m_RefitCount;
+		uint32_t m_RebuildCount;
+	};
+
+	template<class F>
+	void DynamicBVH::Intersect(const Ray& ray, float maxDistance, F&& intersectItem) const
+	{
+		TraverseBVH(m_Nodes, ray, maxDistance, [&](const BVHNode& leaf, float closest)
+			{
+				auto distance = std::optional<float>{};
+				for (const auto item : std::span{ m_Items }.subspan(leaf.leftOrFirst, leaf.count))
+				{
+					if (const auto hit = intersectItem(item, closest); hit && *hit < closest)
+					{
+						closest = *hit;
+						distance = hit;
+					}
+				}
+
+				return distance;
+			});
+	}
+
+	template<class F>
+	void DynamicBVH::IntersectPacket(const RayPacket& packet, PacketDistances& closest, uint32_t& activeMask, F&& intersectItem) const
+	{
+		TraverseBVHPacket(m_Nodes, packet, closest, activeMask, [&](const BVHNode& leaf)
+			{
+				for (const auto item : std::span{ m_Items }.subspan(leaf.leftOrFirst, leaf.count))
+				{
+					if (const auto mask = Game::IntersectPacket(packet, m_ItemBounds[item], closest, activeMask); mask)
+					{
+						intersectItem(item, mask);
+					}
+				}
+			});
+	}
+
+	template<class F>
+	void DynamicBVH::Query(const AABB& bounds, F&& visit) const
+	{
+		QueryBVH(m_Nodes, bounds, [&](const BVHNode& leaf)
+			{
+				for (const auto item : std::span{ m_Items }.subspan(leaf.leftOrFirst, leaf.count))
+				{
+					if (m_ItemBounds[item].Overlaps(bounds))
+					{
+						visit(item);
+					}
+				}
+			});
+	}
+
+}
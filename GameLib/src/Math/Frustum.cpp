@@ -0,0 +1,197 @@
+#include "Frustum.h"
+
+#include "SIMD.h"
+
+#include <cmath>
+#include <format>
+#include <ranges>
+#include <span>
+
+#include <immintrin.h>
+
+namespace {
+
+	Game::vec4 Row(std::span<const float> m, size_t row)
+	{
+		return { m[row], m[4zu + row], m[8zu + row], m[12zu + row] };
+	}
+
+	Game::vec4 NormalizePlane(const Game::vec4& plane)
+	{
+		const auto length = Game::vec3{ plane.x, plane.y, plane.z }.Length();
+		return { plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+	}
+
+	Game::vec4 Add(const Game::vec4& a, const Game::vec4& b)
+	{
+		return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+	}
+
+	Game::vec4 Subtract(const Game::vec4& a, const Game::vec4& b)
+	{
+		return { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
+	}
+
+	// @brief A box given by centre and half extent is outside a plane when even its corner furthest along the normal is behind it
+	bool Outside(const Game::vec4& plane, const Game::vec3& center, const Game::vec3& halfExtent)
+	{
+		const auto distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		const auto radius = std::abs(plane.x) * halfExtent.x + std::abs(plane.y) * halfExtent.y + std::abs(plane.z) * halfExtent.z;
+		return distance + radius < 0.0f;
+	}
+
+	__m128 Abs(__m128 value)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+	}
+
+	template<uint32_t Lane>
+	__m128 Broadcast(__m128 value)
+	{
+		return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+	}
+
+}
+
+namespace Game {
+
+	Frustum::Frustum(const Planes& planes)
+		: m_Planes{ planes }
+		, m_NormalX{}
+		, m_NormalY{}
+		, m_NormalZ{}
+		, m_Distance{}
+	{
+		m_Distance.fill(1.0f);
+
+		for (const auto& [index, plane] : m_Planes | std::views::enumerate)
+		{
+			m_NormalX[index] = plane.x;
+			m_NormalY[index] = plane.y;
+			m_NormalZ[index] = plane.z;
+			m_Distance[index] = plane.w;
+		}
+	}
+
+	Frustum Frustum::FromMatrix(const mat4& viewProjection)
+	{
+		const auto m = viewProjection.Data();
+		const auto x = Row(m, 0zu);
+		const auto y = Row(m, 1zu);
+		const auto z = Row(m, 2zu);
+		const auto w = Row(m, 3zu);
+
+		return Frustum{ {
+			NormalizePlane(Add(w, x)),
+			NormalizePlane(Subtract(w, x)),
+			NormalizePlane(Add(w, y)),
+			NormalizePlane(Subtract(w, y)),
+			NormalizePlane(Add(w, z)),
+			NormalizePlane(Subtract(w, z))
+		} };
+	}
+
+	bool Frustum::Intersects(const vec3& center, float radius) const
+	{
+		return std::ranges::none_of(m_Planes, [&](const auto& plane)
+			{
+				return plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius;
+			});
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		if (box.IsEmpty())
+		{
+			return false;
+		}
+
+		const auto center = box.Centroid();
+		const auto halfExtent = box.Extent() * vec3{ 0.5f };
+
+		return std::ranges::none_of(m_Planes, [&](const auto& plane) { return Outside(plane, center, halfExtent); });
+	}
+
+	bool Frustum::Intersects(const AABB& localBounds, const mat4& transform) const
+	{
+		if (localBounds.IsEmpty())
+		{
+			return false;
+		}
+
+		const auto m = transform.Data();
+		const auto c = localBounds.Centroid();
+		const auto e = localBounds.Extent() * vec3{ 0.5f };
+
+		if (SIMD::GetBackend() == SIMD::Backend::SCALAR)
+		{
+			const auto center = vec3{
+				m[0] * c.x + m[4] * c.y + m[8] * c.z + m[12],
+				m[1] * c.x + m[5] * c.y + m[9] * c.z + m[13],
+				m[2] * c.x + m[6] * c.y + m[10] * c.z + m[14]
+			};
+			const auto halfExtent = vec3{
+				std::abs(m[0]) * e.x + std::abs(m[4]) * e.y + std::abs(m[8]) * e.z,
+				std::abs(m[1]) * e.x + std::abs(m[5]) * e.y + std::abs(m[9]) * e.z,
+				std::abs(m[2]) * e.x + std::abs(m[6]) * e.y + std::abs(m[10]) * e.z
+			};
+
+			return std::ranges::none_of(m_Planes, [&](const auto& plane) { return Outside(plane, center, halfExtent); });
+		}
+
+		const auto column0 = _mm_loadu_ps(m.data());
+		const auto column1 = _mm_loadu_ps(m.data() + 4);
+		const auto column2 = _mm_loadu_ps(m.data() + 8);
+		const auto column3 = _mm_loadu_ps(m.data() + 12);
+
+		const auto center = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(column0, _mm_set1_ps(c.x)),
+			_mm_mul_ps(column1, _mm_set1_ps(c.y))),
+			_mm_mul_ps(column2, _mm_set1_ps(c.z))),
+			column3);
+		const auto halfExtent = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(Abs(column0), _mm_set1_ps(e.x)),
+			_mm_mul_ps(Abs(column1), _mm_set1_ps(e.y))),
+			_mm_mul_ps(Abs(column2), _mm_set1_ps(e.z)));
+
+		const auto centerX = Broadcast<0u>(center);
+		const auto centerY = Broadcast<1u>(center);
+		const auto centerZ = Broadcast<2u>(center);
+		const auto extentX = Broadcast<0u>(halfExtent);
+		const auto extentY = Broadcast<1u>(halfExtent);
+		const auto extentZ = Broadcast<2u>(halfExtent);
+
+		auto outside = _mm_setzero_ps();
+		for (auto lane = 0zu; lane < kLaneCount; lane += 4zu)
+		{
+			const auto normalX = _mm_load_ps(m_NormalX.data() + lane);
+			const auto normalY = _mm_load_ps(m_NormalY.data() + lane);
+			const auto normalZ = _mm_load_ps(m_NormalZ.data() + lane);
+
+			const auto distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(normalX, centerX),
+				_mm_mul_ps(normalY, centerY)),
+				_mm_mul_ps(normalZ, centerZ)),
+				_mm_load_ps(m_Distance.data() + lane));
+			const auto radius = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(Abs(normalX), extentX),
+				_mm_mul_ps(Abs(normalY), extentY)),
+				_mm_mul_ps(Abs(normalZ), extentZ));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+		}
+
+		return _mm_movemask_ps(outside) == 0;
+	}
+
+	const Frustum::Planes& Frustum::GetPlanes() const
+	{
+		return m_Planes;
+	}
+
+	std::string Frustum::to_string() const
+	{
+		return std::format("left: {}, right: {}, bottom: {}, top: {}, near: {}, far: {}", m_Planes[0], m_Planes[1], m_Planes[2], m_Planes[3], m_Planes[4], m_Planes[5]);
+	}
+
+}
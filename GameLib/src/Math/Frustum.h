@@ -0,0 +1,51 @@
+#pragma once
+
+#include "AABB.h"
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+#include <array>
+#include <string>
+
+namespace Game {
+
+	// @brief Six planes as (normal, distance) with normals pointing inwards, a point p is inside a plane when dot(normal, p) + distance >= 0
+	class Frustum
+	{
+	public:
+		static constexpr auto kPlaneCount = 6zu;
+
+		using Planes = std::array<vec4, kPlaneCount>;
+
+		// @brief Planes in the order left, right, bottom, top, near, far
+		explicit Frustum(const Planes& planes);
+
+		// @brief Gribb/Hartmann extraction from a clip matrix (projection * view) with OpenGL's [-w, w] depth range, planes are normalized
+		static Frustum FromMatrix(const mat4& viewProjection);
+
+		bool Intersects(const vec3& center, float radius) const;
+		bool Intersects(const AABB& box) const;
+
+		// @brief Tests local bounds placed by transform against all planes at once. The box is moved to world space
+		// with Arvo's method, transforming the centre and taking the extent through the absolute 3x3 part.
+		// Uses SSE unless the scalar math backend is selected, both perform the same operations in the same order.
+		bool Intersects(const AABB& localBounds, const mat4& transform) const;
+
+		const Planes& GetPlanes() const;
+
+		std::string to_string() const;
+
+	private:
+		static constexpr auto kLaneCount = 8zu;
+
+		Planes m_Planes;
+
+		// SoA copy for the SSE test, lanes past kPlaneCount hold (0, 0, 0, 1) which everything is inside of
+		alignas(16) std::array<float, kLaneCount> m_NormalX;
+		alignas(16) std::array<float, kLaneCount> m_NormalY;
+		alignas(16) std::array<float, kLaneCount> m_NormalZ;
+		alignas(16) std::array<float, kLaneCount> m_Distance;
+	};
+
+}
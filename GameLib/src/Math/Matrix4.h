@@ -3,6 +3,7 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Quaternion.h"
+#include "SIMD.h"
 #include "Utils/Error.h"
 
 #include <array>
@@ -114,6 +115,15 @@ namespace Game {
 
 	constexpr mat4& operator*=(mat4& m1, const mat4& m2)
 	{
+		if !consteval
+		{
+			if (const auto* kernels = SIMD::g_Mat4Kernels; kernels)
+			{
+				kernels->multiply(m1.m_Elements.data(), m2.m_Elements.data(), m1.m_Elements.data());
+				return m1;
+			}
+		}
+
 		mat4 result{};
 
 		for (auto i = 0u; i < 4u; i++)
@@ -201,6 +211,18 @@ namespace Game {
 
 	constexpr mat4 mat4::Invert(const mat4& matrix)
 	{
+		if !consteval
+		{
+			if (const auto* kernels = SIMD::g_Mat4Kernels; kernels)
+			{
+				auto result = mat4{};
+				const auto det = kernels->invert(matrix.m_Elements.data(), result.m_Elements.data());
+				Expect(det != 0.0f, "Matrix is singular and cannot be inverted");
+
+				return result;
+			}
+		}
+
 		const auto& m = matrix.m_Elements;
 		auto result = mat4{};
 		auto& inv = result.m_Elements;
@@ -254,6 +276,15 @@ namespace Game {
 	{
 		auto result = vec4{};
 
+		if !consteval
+		{
+			if (const auto* kernels = SIMD::g_Mat4Kernels; kernels)
+			{
+				kernels->transform(m1.m_Elements.data(), &v.x, &result.x);
+				return result;
+			}
+		}
+
 		result.x = m1.m_Elements[0] * v.x + m1.m_Elements[4] * v.y + m1.m_Elements[8] * v.z + m1.m_Elements[12] * v.w;
 		result.y = m1.m_Elements[1] * v.x + m1.m_Elements[5] * v.y + m1.m_Elements[9] * v.z + m1.m_Elements[13] * v.w;
 		result.z = m1.m_Elements[2] * v.x + m1.m_Elements[6] * v.y + m1.m_Elements[10] * v.z + m1.m_Elements[14] * v.w;
@@ -0,0 +1,182 @@
+#include "RayPacket.h"
+
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+#include <immintrin.h>
+
+namespace {
+
+	constexpr auto kOriginBits = 10u;
+	constexpr auto kDirectionBits = 7u;
+
+	uint32_t Quantize(float value, float min, float extent, uint32_t bits)
+	{
+		const auto maxValue = static_cast<float>((1u << bits) - 1u);
+		const auto normalized = extent > 0.0f ? (value - min) / extent : 0.0f;
+		return static_cast<uint32_t>(std::clamp(normalized * maxValue, 0.0f, maxValue));
+	}
+
+	// @brief Interleaves the low `bits` bits of x, y and z
+	uint64_t Morton(uint32_t x, uint32_t y, uint32_t z, uint32_t bits)
+	{
+		auto code = uint64_t{};
+		for (auto bit = 0u; bit < bits; ++bit)
+		{
+			code |= static_cast<uint64_t>((x >> bit) & 1u) << (bit * 3u + 2u);
+			code |= static_cast<uint64_t>((y >> bit) & 1u) << (bit * 3u + 1u);
+			code |= static_cast<uint64_t>((z >> bit) & 1u) << (bit * 3u);
+		}
+
+		return code;
+	}
+
+	__m128 Load(const std::array<float, Game::RayPacket::kSize>& values)
+	{
+		return _mm_load_ps(values.data());
+	}
+
+	__m128 LaneMask(uint32_t activeMask)
+	{
+		const auto bits = _mm_set_epi32(8, 4, 2, 1);
+		const auto mask = _mm_and_si128(_mm_set1_epi32(static_cast<int32_t>(activeMask)), bits);
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(mask, bits));
+	}
+
+	__m128 Abs(__m128 value)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+	}
+
+}
+
+namespace Game {
+
+	void RayPacket::SetRay(uint32_t lane, const Ray& ray)
+	{
+		const auto invDirection = InverseDirection(ray.direction);
+
+		originX[lane] = ray.origin.x;
+		originY[lane] = ray.origin.y;
+		originZ[lane] = ray.origin.z;
+		directionX[lane] = ray.direction.x;
+		directionY[lane] = ray.direction.y;
+		directionZ[lane] = ray.direction.z;
+		invDirectionX[lane] = invDirection.x;
+		invDirectionY[lane] = invDirection.y;
+		invDirectionZ[lane] = invDirection.z;
+	}
+
+	Ray RayPacket::GetRay(uint32_t lane) const
+	{
+		// directions are already normalized, assign them directly as normalizing twice can change the last bit
+		auto ray = Ray{ { originX[lane], originY[lane], originZ[lane] }, { 0.0f, 0.0f, 1.0f } };
+		ray.direction = { directionX[lane], directionY[lane], directionZ[lane] };
+		return ray;
+	}
+
+	uint32_t IntersectPacket(const RayPacket& packet, const AABB& box, const PacketDistances& closest, uint32_t activeMask)
+	{
+		const auto t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.x), Load(packet.originX)), Load(packet.invDirectionX));
+		const auto t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.y), Load(packet.originY)), Load(packet.invDirectionY));
+		const auto t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.z), Load(packet.originZ)), Load(packet.invDirectionZ));
+		const auto t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.x), Load(packet.originX)), Load(packet.invDirectionX));
+		const auto t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.y), Load(packet.originY)), Load(packet.invDirectionY));
+		const auto t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.z), Load(packet.originZ)), Load(packet.invDirectionZ));
+
+		const auto entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+		const auto exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), Load(closest)));
+
+		return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(entry, exit))) & activeMask;
+	}
+
+	uint32_t IntersectPacket(const RayPacket& packet, const vec3& v0, const vec3& v1, const vec3& v2, PacketDistances& closest, uint32_t activeMask)
+	{
+		// same operations in the same order as Game::Intersect, one ray per lane
+		const auto edge1X = _mm_set1_ps(v1.x - v0.x);
+		const auto edge1Y = _mm_set1_ps(v1.y - v0.y);
+		const auto edge1Z = _mm_set1_ps(v1.z - v0.z);
+		const auto edge2X = _mm_set1_ps(v2.x - v0.x);
+		const auto edge2Y = _mm_set1_ps(v2.y - v0.y);
+		const auto edge2Z = _mm_set1_ps(v2.z - v0.z);
+
+		const auto dX = Load(packet.directionX);
+		const auto dY = Load(packet.directionY);
+		const auto dZ = Load(packet.directionZ);
+
+		// h = cross(direction, edge2)
+		const auto hX = _mm_sub_ps(_mm_mul_ps(dY, edge2Z), _mm_mul_ps(dZ, edge2Y));
+		const auto hY = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(dX, edge2Z), _mm_mul_ps(dZ, edge2X)), _mm_set1_ps(-0.0f));
+		const auto hZ = _mm_sub_ps(_mm_mul_ps(dX, edge2Y), _mm_mul_ps(dY, edge2X));
+
+		const auto a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, hX), _mm_mul_ps(edge1Y, hY)), _mm_mul_ps(edge1Z, hZ));
+		auto valid = _mm_and_ps(LaneMask(activeMask), _mm_cmpge_ps(Abs(a), _mm_set1_ps(1e-8f)));
+
+		const auto f = _mm_div_ps(_mm_set1_ps(1.0f), a);
+		const auto sX = _mm_sub_ps(Load(packet.originX), _mm_set1_ps(v0.x));
+		const auto sY = _mm_sub_ps(Load(packet.originY), _mm_set1_ps(v0.y));
+		const auto sZ = _mm_sub_ps(Load(packet.originZ), _mm_set1_ps(v0.z));
+
+		const auto u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sX, hX), _mm_mul_ps(sY, hY)), _mm_mul_ps(sZ, hZ)));
+		valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, _mm_setzero_ps()), _mm_cmple_ps(u, _mm_set1_ps(1.0f))));
+
+		// q = cross(s, edge1)
+		const auto qX = _mm_sub_ps(_mm_mul_ps(sY, edge1Z), _mm_mul_ps(sZ, edge1Y));
+		const auto qY = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(sX, edge1Z), _mm_mul_ps(sZ, edge1X)), _mm_set1_ps(-0.0f));
+		const auto qZ = _mm_sub_ps(_mm_mul_ps(sX, edge1Y), _mm_mul_ps(sY, edge1X));
+
+		const auto v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, qX), _mm_mul_ps(dY, qY)), _mm_mul_ps(dZ, qZ)));
+		valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, _mm_setzero_ps()), _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f))));
+
+		const auto t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)));
+		const auto current = Load(closest);
+		valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, _mm_set1_ps(1e-8f)), _mm_cmplt_ps(t, current)));
+
+		_mm_store_ps(closest.data(), _mm_or_ps(_mm_and_ps(valid, t), _mm_andnot_ps(valid, current)));
+
+		return static_cast<uint32_t>(_mm_movemask_ps(valid));
+	}
+
+	std::vector<uint32_t> CoherentOrder(std::span<const Ray> rays)
+	{
+		auto bounds = AABB{};
+		for (const auto& ray : rays)
+		{
+			bounds.Grow(ray.origin);
+		}
+
+		const auto extent = bounds.Extent();
+		const auto originBits = kOriginBits * 3u;
+		const auto directionBits = kDirectionBits * 3u;
+
+		// octant | origin morton code | direction morton code
+		const auto keys = rays |
+			std::views::transform([&](const auto& ray)
+								  {
+									  const auto octant = (ray.direction.x < 0.0f ? 4u : 0u) | (ray.direction.y < 0.0f ? 2u : 0u) | (ray.direction.z < 0.0f ? 1u : 0u);
+									  const auto origin = Morton(
+										  Quantize(ray.origin.x, bounds.min.x, extent.x, kOriginBits),
+										  Quantize(ray.origin.y, bounds.min.y, extent.y, kOriginBits),
+										  Quantize(ray.origin.z, bounds.min.z, extent.z, kOriginBits),
+										  kOriginBits);
+									  const auto direction = Morton(
+										  Quantize(ray.direction.x, -1.0f, 2.0f, kDirectionBits),
+										  Quantize(ray.direction.y, -1.0f, 2.0f, kDirectionBits),
+										  Quantize(ray.direction.z, -1.0f, 2.0f, kDirectionBits),
+										  kDirectionBits);
+
+									  return (static_cast<uint64_t>(octant) << (originBits + directionBits)) | (origin << directionBits) | direction;
+								  }) |
+			std::ranges::to<std::vector>();
+
+		auto order = std::vector<uint32_t>(rays.size());
+		std::iota(std::ranges::begin(order), std::ranges::end(order), 0u);
+		std::ranges::sort(order, {}, [&](auto index) { return keys[index]; });
+
+		return order;
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "AABB.h"
+#include "Ray.h"
+#include "Vector3.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Game {
+
+	// @brief Four rays in SoA layout for SSE traversal, lanes outside the active mask are ignored
+	struct alignas(16) RayPacket
+	{
+		static constexpr auto kSize = 4u;
+		static constexpr auto kFullMask = (1u << kSize) - 1u;
+
+		void SetRay(uint32_t lane, const Ray& ray);
+		Ray GetRay(uint32_t lane) const;
+
+		std::array<float, kSize> originX;
+		std::array<float, kSize> originY;
+		std::array<float, kSize> originZ;
+		std::array<float, kSize> directionX;
+		std::array<float, kSize> directionY;
+		std::array<float, kSize> directionZ;
+		std::array<float, kSize> invDirectionX;
+		std::array<float, kSize> invDirectionY;
+		std::array<float, kSize> invDirectionZ;
+	};
+
+	using PacketDistances = std::array<float, RayPacket::kSize>;
+
+	// @brief Mask of the active lanes that enter the box before their closest distance
+	uint32_t IntersectPacket(const RayPacket& packet, const AABB& box, const PacketDistances& closest, uint32_t activeMask);
+
+	// @brief Möller–Trumbore for every active lane, bit-identical to Game::Intersect. Lowers closest for lanes
+	// that hit the triangle closer and returns their mask
+	uint32_t IntersectPacket(const RayPacket& packet, const vec3& v0, const vec3& v1, const vec3& v2, PacketDistances& closest, uint32_t activeMask);
+
+	// @brief Ray order that groups rays with the same direction octant, nearby origins and similar directions,
+	// so consecutive packets traverse mostly the same nodes
+	std::vector<uint32_t> CoherentOrder(std::span<const Ray> rays);
+
+}
@@ -0,0 +1,335 @@
+#include "SIMD.h"
+
+#include "Utils/Error.h"
+#include "Utils/Log.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+#define GAME_TARGET(features) __attribute__((target(features)))
+#else
+#define GAME_TARGET(features)
+#endif
+
+namespace {
+
+	// Cofactor terms of mat4::Invert, lane i of row t is the t-th product of inv[i]:
+	// inv[i] = +/- m[A] * m[B] * m[C] +/- ... (6 terms, summed left to right)
+	constexpr int32_t kInvA[6][16] = {
+		{ 5, 1, 1, 1, 4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0 },
+		{ 5, 1, 1, 1, 4, 0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0 },
+		{ 9, 9, 5, 5, 8, 8, 4, 4, 8, 8, 4, 4, 8, 8, 4, 4 },
+		{ 9, 9, 5, 5, 8, 8, 4, 4, 8, 8, 4, 4, 8, 8, 4, 4 },
+		{ 13, 13, 13, 9, 12, 12, 12, 8, 12, 12, 12, 8, 12, 12, 12, 8 },
+		{ 13, 13, 13, 9, 12, 12, 12, 8, 12, 12, 12, 8, 12, 12, 12, 8 },
+	};
+
+	constexpr int32_t kInvB[6][16] = {
+		{ 10, 10, 6, 6, 10, 10, 6, 6, 9, 9, 5, 5, 9, 9, 5, 5 },
+		{ 11, 11, 7, 7, 11, 11, 7, 7, 11, 11, 7, 7, 10, 10, 6, 6 },
+		{ 6, 2, 2, 2, 6, 2, 2, 2, 5, 1, 1, 1, 5, 1, 1, 1 },
+		{ 7, 3, 3, 3, 7, 3, 3, 3, 7, 3, 3, 3, 6, 2, 2, 2 },
+		{ 6, 2, 2, 2, 6, 2, 2, 2, 5, 1, 1, 1, 5, 1, 1, 1 },
+		{ 7, 3, 3, 3, 7, 3, 3, 3, 7, 3, 3, 3, 6, 2, 2, 2 },
+	};
+
+	constexpr int32_t kInvC[6][16] = {
+		{ 15, 15, 15, 11, 15, 15, 15, 11, 15, 15, 15, 11, 14, 14, 14, 10 },
+		{ 14, 14, 14, 10, 14, 14, 14, 10, 13, 13, 13, 9, 13, 13, 13, 9 },
+		{ 15, 15, 15, 11, 15, 15, 15, 11, 15, 15, 15, 11, 14, 14, 14, 10 },
+		{ 14, 14, 14, 10, 14, 14, 14, 10, 13, 13, 13, 9, 13, 13, 13, 9 },
+		{ 11, 11, 7, 7, 11, 11, 7, 7, 11, 11, 7, 7, 10, 10, 6, 6 },
+		{ 10, 10, 6, 6, 10, 10, 6, 6, 9, 9, 5, 5, 9, 9, 5, 5 },
+	};
+
+	// 1 where the term is subtracted (or negated when it is the first term)
+	constexpr int32_t kInvNegate[6][16] = {
+		{ 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0 },
+		{ 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1 },
+		{ 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1 },
+		{ 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0 },
+		{ 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0 },
+		{ 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1 },
+	};
+
+	constexpr auto kSignMasks = []
+	{
+		std::array<std::array<uint32_t, 16>, 6> masks{};
+		for (auto t = 0u; t < 6u; ++t)
+		{
+			for (auto i = 0u; i < 16u; ++i)
+			{
+				masks[t][i] = kInvNegate[t][i] != 0 ? 0x80000000u : 0u;
+			}
+		}
+		return masks;
+	}();
+
+	// Determinant and scaling are shared by all backends, they are the same scalar operations as mat4::Invert
+	float FinishInvert(const float* m, float* inv)
+	{
+		auto det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		if (det == 0.0f)
+		{
+			return det;
+		}
+
+		const auto scale = _mm_set1_ps(1.0f / det);
+		for (auto i = 0u; i < 16u; i += 4u)
+		{
+			_mm_storeu_ps(inv + i, _mm_mul_ps(_mm_loadu_ps(inv + i), scale));
+		}
+
+		return det;
+	}
+
+	// SSE2 (x64 baseline)
+
+	void MultiplySSE(const float* m1, const float* m2, float* out)
+	{
+		const auto c0 = _mm_loadu_ps(m1 + 0);
+		const auto c1 = _mm_loadu_ps(m1 + 4);
+		const auto c2 = _mm_loadu_ps(m1 + 8);
+		const auto c3 = _mm_loadu_ps(m1 + 12);
+
+		__m128 result[4];
+		for (auto j = 0u; j < 4u; ++j)
+		{
+			auto sum = _mm_setzero_ps();
+			sum = _mm_add_ps(sum, _mm_mul_ps(c0, _mm_set1_ps(m2[j * 4 + 0])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(m2[j * 4 + 1])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(m2[j * 4 + 2])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(m2[j * 4 + 3])));
+			result[j] = sum;
+		}
+
+		for (auto j = 0u; j < 4u; ++j)
+		{
+			_mm_storeu_ps(out + j * 4, result[j]);
+		}
+	}
+
+	float InvertSSE(const float* m, float* out)
+	{
+		alignas(16) float inv[16];
+
+		for (auto group = 0u; group < 16u; group += 4u)
+		{
+			auto sum = _mm_setzero_ps();
+			for (auto t = 0u; t < 6u; ++t)
+			{
+				const auto* a = kInvA[t] + group;
+				const auto* b = kInvB[t] + group;
+				const auto* c = kInvC[t] + group;
+
+				const auto va = _mm_setr_ps(m[a[0]], m[a[1]], m[a[2]], m[a[3]]);
+				const auto vb = _mm_setr_ps(m[b[0]], m[b[1]], m[b[2]], m[b[3]]);
+				const auto vc = _mm_setr_ps(m[c[0]], m[c[1]], m[c[2]], m[c[3]]);
+				const auto sign = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kSignMasks[t].data() + group)));
+
+				const auto term = _mm_xor_ps(_mm_mul_ps(_mm_mul_ps(va, vb), vc), sign);
+				sum = t == 0u ? term : _mm_add_ps(sum, term);
+			}
+			_mm_store_ps(inv + group, sum);
+		}
+
+		const auto det = FinishInvert(m, inv);
+		std::memcpy(out, inv, sizeof(inv));
+		return det;
+	}
+
+	void TransformSSE(const float* m, const float* v, float* out)
+	{
+		auto result = _mm_mul_ps(_mm_loadu_ps(m + 0), _mm_set1_ps(v[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(v[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(v[2])));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3])));
+		_mm_storeu_ps(out, result);
+	}
+
+	// AVX2, two result columns (or eight cofactors) per register.
+	// FMA is deliberately not enabled, fused results would differ from the scalar path.
+
+	GAME_TARGET("avx2")
+	void MultiplyAVX2(const float* m1, const float* m2, float* out)
+	{
+		const auto c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 0));
+		const auto c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 4));
+		const auto c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 8));
+		const auto c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 12));
+
+		// columns 0|1 and 2|3 of m2, permute_ps splats element k within each 128 bit lane
+		const auto b01 = _mm256_loadu_ps(m2 + 0);
+		const auto b23 = _mm256_loadu_ps(m2 + 8);
+
+		auto r01 = _mm256_setzero_ps();
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(c0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0))));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(c1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1))));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(c2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2))));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(c3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		auto r23 = _mm256_setzero_ps();
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(c0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0))));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(c1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1))));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(c2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2))));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(c3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		_mm256_storeu_ps(out + 0, r01);
+		_mm256_storeu_ps(out + 8, r23);
+	}
+
+	// Selects m[index] per lane from the matrix held in two registers
+	GAME_TARGET("avx2")
+	__m256 Select(__m256 lo, __m256 hi, __m256i index)
+	{
+		const auto fromLo = _mm256_permutevar8x32_ps(lo, index);
+		const auto fromHi = _mm256_permutevar8x32_ps(hi, index);
+		const auto useHi = _mm256_castsi256_ps(_mm256_cmpgt_epi32(index, _mm256_set1_epi32(7)));
+		return _mm256_blendv_ps(fromLo, fromHi, useHi);
+	}
+
+	GAME_TARGET("avx2")
+	float InvertAVX2(const float* m, float* out)
+	{
+		const auto lo = _mm256_loadu_ps(m + 0);
+		const auto hi = _mm256_loadu_ps(m + 8);
+
+		alignas(32) float inv[16];
+
+		for (auto group = 0u; group < 16u; group += 8u)
+		{
+			auto sum = _mm256_setzero_ps();
+			for (auto t = 0u; t < 6u; ++t)
+			{
+				const auto a = Select(lo, hi, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kInvA[t] + group)));
+				const auto b = Select(lo, hi, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kInvB[t] + group)));
+				const auto c = Select(lo, hi, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kInvC[t] + group)));
+				const auto sign = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(kSignMasks[t].data() + group)));
+
+				const auto term = _mm256_xor_ps(_mm256_mul_ps(_mm256_mul_ps(a, b), c), sign);
+				sum = t == 0u ? term : _mm256_add_ps(sum, term);
+			}
+			_mm256_store_ps(inv + group, sum);
+		}
+
+		const auto det = FinishInvert(m, inv);
+		std::memcpy(out, inv, sizeof(inv));
+		return det;
+	}
+
+	constexpr Game::SIMD::Mat4Kernels kSSEKernels{
+		.multiply = MultiplySSE,
+		.invert = InvertSSE,
+		.transform = TransformSSE
+	};
+
+	constexpr Game::SIMD::Mat4Kernels kAVX2Kernels{
+		.multiply = MultiplyAVX2,
+		.invert = InvertAVX2,
+		.transform = TransformSSE
+	};
+
+	void CpuId(int32_t leaf, int32_t subLeaf, int32_t (&regs)[4])
+	{
+#if defined(_MSC_VER)
+		__cpuidex(regs, leaf, subLeaf);
+#else
+		uint32_t a{}, b{}, c{}, d{};
+		__cpuid_count(leaf, subLeaf, a, b, c, d);
+		regs[0] = static_cast<int32_t>(a);
+		regs[1] = static_cast<int32_t>(b);
+		regs[2] = static_cast<int32_t>(c);
+		regs[3] = static_cast<int32_t>(d);
+#endif
+	}
+
+	GAME_TARGET("xsave")
+	uint64_t XGetBV()
+	{
+		return _xgetbv(0);
+	}
+
+	bool DetectAVX2()
+	{
+		int32_t regs[4]{};
+		CpuId(0, 0, regs);
+		if (regs[0] < 7)
+		{
+			return false;
+		}
+
+		CpuId(1, 0, regs);
+		const auto osxsave = (regs[2] & (1 << 27)) != 0;
+		const auto avx = (regs[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx)
+		{
+			return false;
+		}
+
+		// OS must preserve xmm and ymm state
+		if ((XGetBV() & 0x6u) != 0x6u)
+		{
+			return false;
+		}
+
+		CpuId(7, 0, regs);
+		return (regs[1] & (1 << 5)) != 0;
+	}
+
+	const Game::SIMD::Mat4Kernels* KernelsFor(Game::SIMD::Backend backend)
+	{
+		switch (backend)
+		{
+			case Game::SIMD::Backend::SCALAR: return nullptr;
+			case Game::SIMD::Backend::SSE: return &kSSEKernels;
+			case Game::SIMD::Backend::AVX2: return &kAVX2Kernels;
+		}
+
+		return nullptr;
+	}
+
+	const auto g_HasAVX2 = DetectAVX2();
+	auto g_Backend = g_HasAVX2 ? Game::SIMD::Backend::AVX2 : Game::SIMD::Backend::SSE;
+
+}
+
+namespace Game::SIMD {
+
+	const Mat4Kernels* g_Mat4Kernels = KernelsFor(g_Backend);
+
+	bool IsSupported(Backend backend)
+	{
+		return backend != Backend::AVX2 || g_HasAVX2;
+	}
+
+	Backend GetBestBackend()
+	{
+		return g_HasAVX2 ? Backend::AVX2 : Backend::SSE;
+	}
+
+	Backend GetBackend()
+	{
+		return g_Backend;
+	}
+
+	void SetBackend(Backend backend)
+	{
+		Ensure(IsSupported(backend), "SIMD backend {} is not supported on this CPU", backend);
+
+		g_Backend = backend;
+		g_Mat4Kernels = KernelsFor(backend);
+
+		Log::Info("Using {} math backend", backend);
+	}
+
+}
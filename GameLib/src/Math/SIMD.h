@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+namespace Game::SIMD {
+
+	enum class Backend
+	{
+		SCALAR,
+		SSE,
+		AVX2
+	};
+
+	// @brief Kernels operating on column-major mat4 storage (16 floats) and vec4 (4 floats).
+	// Every kernel performs the same multiplies and additions in the same order as the scalar
+	// constexpr path in Matrix4.h, so results are bit-identical regardless of the backend.
+	// Output pointers may alias inputs.
+	struct Mat4Kernels
+	{
+		void (*multiply)(const float* m1, const float* m2, float* out);
+		float (*invert)(const float* m, float* out);
+		void (*transform)(const float* m, const float* v, float* out);
+	};
+
+	// nullptr when the scalar backend is active
+	extern const Mat4Kernels* g_Mat4Kernels;
+
+	bool IsSupported(Backend backend);
+	Backend GetBestBackend();
+	Backend GetBackend();
+	void SetBackend(Backend backend);
+
+	inline std::string to_string(Backend backend)
+	{
+		switch (backend)
+		{
+			case Backend::SCALAR: return "SCALAR";
+			case Backend::SSE: return "SSE";
+			case Backend::AVX2: return "AVX2";
+			default: return "unknown";
+		}
+	}
+
+}
@@ -38,6 +38,8 @@ namespace Game {
 		float w;
 	};
 
+	static_assert(sizeof(vec4) == sizeof(float) * 4);
+
 	constexpr vec4::operator vec3() const
 	{
 		return vec3{ x, y, z };
@@ -32,6 +32,18 @@ namespace {
 		#embed "../Game/assets/shaders/light_pass.frag"
 	};
 
+	constexpr const char cullComputeShader[] = {
+		#embed "../Game/assets/shaders/cull.comp"
+	};
+
+	constexpr const char cullCompactComputeShader[] = {
+		#embed "../Game/assets/shaders/cull_compact.comp"
+	};
+
+	constexpr const char lightClusterComputeShader[] = {
+		#embed "../Game/assets/shaders/light_cluster.comp"
+	};
+
 	constexpr const char diamondFloorAlbedo[] = {
 		#embed "../Game/assets/textures/diamond_floor_albedo.png"
 	};
@@ -72,6 +84,9 @@ namespace Game {
 			{"shaders\\gbuffer.frag", gbufferFragmentShader},
 			{"shaders\\light_pass.vert", lightPassVertexShader},
 			{"shaders\\light_pass.frag", lightPassFragmentShader},
+			{"shaders\\cull.comp", cullComputeShader},
+			{"shaders\\cull_compact.comp", cullCompactComputeShader},
+			{"shaders\\light_cluster.comp", lightClusterComputeShader},
 
 			{"textures\\diamond_floor_albedo.png", diamondFloorAlbedo},
 			{"textures\\diamond_floor_normal.png", diamondFloorNormal},
@@ -0,0 +1,171 @@
+#include "RangeAllocator.h"
+
+#include "Utils/Error.h"
+
+#include <format>
+#include <iterator>
+
+namespace Game {
+
+	float RangeAllocatorStats::Fragmentation() const
+	{
+		const auto freeSize = capacity - used;
+		return freeSize == 0u ? 0.0f : 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeSize);
+	}
+
+	std::string RangeAllocatorStats::to_string() const
+	{
+		return std::format("used {}/{}, {} free ranges, largest free {}, fragmentation {:.2f}", used, capacity, freeRangeCount, largestFreeRange, Fragmentation());
+	}
+
+	RangeAllocator::RangeAllocator()
+		: RangeAllocator(0u)
+	{}
+
+	RangeAllocator::RangeAllocator(uint32_t capacity)
+		: m_FreeByOffset{}
+		, m_FreeBySize{}
+		, m_Capacity{ capacity }
+		, m_Used{}
+	{
+		if (capacity > 0u)
+		{
+			Insert(0u, capacity);
+		}
+	}
+
+	std::optional<uint32_t> RangeAllocator::Allocate(uint32_t size)
+	{
+		Expect(size > 0u, "Cannot allocate an empty range");
+
+		const auto best = m_FreeBySize.lower_bound({ size, 0u });
+		if (best == std::ranges::end(m_FreeBySize))
+		{
+			return {};
+		}
+
+		const auto offset = best->second;
+		Take(m_FreeByOffset.find(offset), size);
+
+		return offset;
+	}
+
+	std::optional<uint32_t> RangeAllocator::AllocateBelow(uint32_t size, uint32_t limit)
+	{
+		Expect(size > 0u, "Cannot allocate an empty range");
+
+		for (auto range = std::ranges::begin(m_FreeByOffset); range != std::ranges::end(m_FreeByOffset) && range->first + size <= limit; ++range)
+		{
+			if (range->second >= size)
+			{
+				const auto offset = range->first;
+				Take(range, size);
+				return offset;
+			}
+		}
+
+		return {};
+	}
+
+	void RangeAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		Expect(size > 0u && offset + size <= m_Capacity, "Range [{}, {}) is outside of the pool {}", offset, offset + size, m_Capacity);
+
+		auto first = offset;
+		auto last = offset + size;
+
+		// merge with the free neighbours on either side
+		const auto next = m_FreeByOffset.lower_bound(offset);
+		Expect(next == std::ranges::end(m_FreeByOffset) || next->first >= last, "Range [{}, {}) overlaps a free range", first, last);
+
+		if (next != std::ranges::end(m_FreeByOffset) && next->first == last)
+		{
+			last += next->second;
+			Erase(next);
+		}
+
+		if (const auto previous = m_FreeByOffset.lower_bound(offset); previous != std::ranges::begin(m_FreeByOffset))
+		{
+			const auto before = std::prev(previous);
+			Expect(before->first + before->second <= first, "Range [{}, {}) overlaps a free range", first, last);
+
+			if (before->first + before->second == first)
+			{
+				first = before->first;
+				Erase(before);
+			}
+		}
+
+		Insert(first, last - first);
+		m_Used -= size;
+	}
+
+	void RangeAllocator::Grow(uint32_t newCapacity)
+	{
+		Expect(newCapacity >= m_Capacity, "Pool cannot shrink from {} to {}", m_Capacity, newCapacity);
+
+		if (newCapacity == m_Capacity)
+		{
+			return;
+		}
+
+		const auto oldCapacity = m_Capacity;
+		m_Capacity = newCapacity;
+
+		// Free coalesces the new space with a free range at the old end
+		m_Used += newCapacity - oldCapacity;
+		Free(oldCapacity, newCapacity - oldCapacity);
+	}
+
+	bool RangeAllocator::HasHoles() const
+	{
+		if (m_FreeByOffset.empty())
+		{
+			return false;
+		}
+
+		const auto& [offset, size] = *std::ranges::begin(m_FreeByOffset);
+		return offset + size < m_Capacity;
+	}
+
+	RangeAllocatorStats RangeAllocator::GetStats() const
+	{
+		return {
+			.capacity = m_Capacity,
+			.used = m_Used,
+			.freeRangeCount = static_cast<uint32_t>(m_FreeByOffset.size()),
+			.largestFreeRange = m_FreeBySize.empty() ? 0u : std::ranges::rbegin(m_FreeBySize)->first
+		};
+	}
+
+	std::string RangeAllocator::to_string() const
+	{
+		return GetStats().to_string();
+	}
+
+	void RangeAllocator::Insert(uint32_t offset, uint32_t size)
+	{
+		m_FreeByOffset.emplace(offset, size);
+		m_FreeBySize.emplace(size, offset);
+	}
+
+	void RangeAllocator::Erase(std::map<uint32_t, uint32_t>::iterator range)
+	{
+		m_FreeBySize.erase({ range->second, range->first });
+		m_FreeByOffset.erase(range);
+	}
+
+	void RangeAllocator::Take(std::map<uint32_t, uint32_t>::iterator range, uint32_t size)
+	{
+		const auto [rangeOffset, rangeSize] = *range;
+		Erase(range);
+
+		if (rangeSize > size)
+		{
+			Insert(rangeOffset + size, rangeSize - size);
+		}
+
+		m_Used += size;
+	}
+
+}
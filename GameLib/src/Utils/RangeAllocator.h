@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace Game {
+
+	struct RangeAllocatorStats
+	{
+		uint32_t capacity;
+		uint32_t used;
+		uint32_t freeRangeCount;
+		uint32_t largestFreeRange;
+
+		// @brief 0 when all free space is one range, approaching 1 as it splits into many small ones
+		float Fragmentation() const;
+
+		std::string to_string() const;
+	};
+
+	// @brief Offset allocator for suballocating element ranges out of a pool, e.g. a GPU vertex or index buffer.
+	// Free ranges are kept ordered by offset for coalescing and by size for best fit allocation.
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator();
+		explicit RangeAllocator(uint32_t capacity);
+
+		std::optional<uint32_t> Allocate(uint32_t size);
+
+		// @brief Lowest free offset that fits size and ends at or before limit, used to compact live ranges downwards
+		std::optional<uint32_t> AllocateBelow(uint32_t size, uint32_t limit);
+
+		void Free(uint32_t offset, uint32_t size);
+
+		// @brief Adds [capacity, newCapacity) to the pool
+		void Grow(uint32_t newCapacity);
+
+		// @brief True when some free range lies below allocated data, i.e. compaction could move something
+		bool HasHoles() const;
+
+		RangeAllocatorStats GetStats() const;
+		std::string to_string() const;
+
+	private:
+		void Insert(uint32_t offset, uint32_t size);
+		void Erase(std::map<uint32_t, uint32_t>::iterator range);
+		void Take(std::map<uint32_t, uint32_t>::iterator range, uint32_t size);
+
+		std::map<uint32_t, uint32_t> m_FreeByOffset;
+		std::set<std::pair<uint32_t, uint32_t>> m_FreeBySize;	// size, offset
+		uint32_t m_Capacity;
+		uint32_t m_Used;
+	};
+
+}
@@ -0,0 +1,80 @@
+#include "RollingStats.h"
+
+#include "Utils/Error.h"
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <ranges>
+
+namespace Game {
+
+	std::string RollingSummary::to_string() const
+	{
+		return std::format("min {:.3f} avg {:.3f} p99 {:.3f} over {}", min, avg, p99, count);
+	}
+
+	RollingStats::RollingStats(size_t capacity)
+		: m_Samples(capacity)
+		, m_Next{ 0zu }
+		, m_Count{ 0zu }
+	{
+		Expect(capacity > 0zu, "Rolling window must hold a sample");
+	}
+
+	void RollingStats::Add(float sample)
+	{
+		m_Samples[m_Next] = sample;
+		m_Next = (m_Next + 1zu) % m_Samples.size();
+		m_Count = std::min(m_Count + 1zu, m_Samples.size());
+	}
+
+	void RollingStats::Clear()
+	{
+		m_Next = 0zu;
+		m_Count = 0zu;
+	}
+
+	RollingSummary RollingStats::Summary() const
+	{
+		if (m_Count == 0zu)
+		{
+			return { .min = 0.0f, .avg = 0.0f, .p99 = 0.0f, .count = 0zu };
+		}
+
+		auto samples = Samples();
+		const auto sum = std::reduce(std::ranges::cbegin(samples), std::ranges::cend(samples), 0.0);
+		const auto min = std::ranges::min(samples);
+
+		// smallest sample at least 99% of the window is not above
+		const auto rank = (m_Count * 99zu + 99zu) / 100zu - 1zu;
+		std::ranges::nth_element(samples, std::ranges::begin(samples) + rank);
+
+		return {
+			.min = min,
+			.avg = static_cast<float>(sum / static_cast<double>(m_Count)),
+			.p99 = samples[rank],
+			.count = m_Count
+		};
+	}
+
+	std::vector<float> RollingStats::Samples() const
+	{
+		// before the window fills the oldest sample is at the front, afterwards it is the next one to be overwritten
+		const auto oldest = m_Count < m_Samples.size() ? 0zu : m_Next;
+		return std::views::iota(0zu, m_Count) |
+			std::views::transform([&](auto index) { return m_Samples[(oldest + index) % m_Samples.size()]; }) |
+			std::ranges::to<std::vector>();
+	}
+
+	std::optional<float> RollingStats::Latest() const
+	{
+		if (m_Count == 0zu)
+		{
+			return std::nullopt;
+		}
+
+		return m_Samples[(m_Next + m_Samples.size() - 1zu) % m_Samples.size()];
+	}
+
+}
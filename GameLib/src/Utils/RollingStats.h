@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Game {
+
+	struct RollingSummary
+	{
+		float min;
+		float avg;
+		float p99;		// nearest rank
+		size_t count;
+
+		std::string to_string() const;
+	};
+
+	// @brief Summary of the latest samples, older ones are overwritten once the window is full
+	class RollingStats
+	{
+	public:
+		explicit RollingStats(size_t capacity);
+
+		void Add(float sample);
+		void Clear();
+
+		// @brief All zero while empty
+		RollingSummary Summary() const;
+		// @brief Oldest first, for plotting
+		std::vector<float> Samples() const;
+		std::optional<float> Latest() const;
+
+	private:
+		std::vector<float> m_Samples;
+		size_t m_Next;
+		size_t m_Count;
+	};
+
+}
@@ -29,3 +29,4 @@ outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 include "GameLib/Build-GameLib.lua"
 include "Game/Build-Game.lua"
+include "Benchmark/Build-Benchmark.lua"